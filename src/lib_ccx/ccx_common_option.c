@@ -70,6 +70,7 @@ void init_options(struct ccx_s_options *options)
 	options->tickertext = 0;	  // By default, do not assume ticker style text
 	options->hardsubx = 0;		  // By default, don't try to extract hard subtitles
 	options->dvblang = NULL;	  // By default, autodetect DVB language
+	options->dvb_all_streams = 0;	  // By default, extract a single DVB stream
 	options->ocrlang = NULL;	  // By default, autodetect .traineddata file
 	options->ocr_oem = -1;		  // By default, OEM mode depends on the tesseract version
 	options->psm = 3;		  // Default PSM mode (3 is the default tesseract as well)
@@ -83,6 +84,10 @@ void init_options(struct ccx_s_options *options)
 	options->hardsubx_subcolor = 0;
 	options->hardsubx_min_sub_duration = 0.5;
 	options->hardsubx_detect_italics = 0;
+	options->hardsubx_binary_search = 0;
+	options->hardsubx_roi_top = -1; // Not set, depends on --tickertext
+	options->hardsubx_threads = 1;
+	options->hardsubx_skip_frames = 0;
 	options->hardsubx_conf_thresh = 0.0;
 	options->hardsubx_hue = 0.0;
 	options->hardsubx_lum_thresh = 95.0;
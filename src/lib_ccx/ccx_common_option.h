@@ -145,6 +145,7 @@ struct ccx_s_options // Options from user parameters
 	int hardsubx;                     // 1 if burned-in subtitles to be extracted
 	int hardsubx_and_common;		  // 1 if both burned-in and not burned in need to be extracted
 	char *dvblang;                    // The name of the language stream for DVB
+	int dvb_all_streams;              // 1 if every DVB subtitle stream is to be extracted, each to its own output
 	const char *ocrlang;              // The name of the .traineddata file to be loaded with tesseract
 	int ocr_oem;                      // The Tesseract OEM mode, could be 0 (default), 1 or 2
 	int psm;						  // The Tesseract PSM mode, could be between 0 and 13. 3 is tesseract default
@@ -157,6 +158,10 @@ struct ccx_s_options // Options from user parameters
 	int hardsubx_subcolor;
 	float hardsubx_min_sub_duration;
 	int hardsubx_detect_italics;
+	int hardsubx_binary_search;
+	float hardsubx_roi_top;
+	int hardsubx_threads;
+	int hardsubx_skip_frames;
 	float hardsubx_conf_thresh;
 	float hardsubx_hue;
 	float hardsubx_lum_thresh;
@@ -14,10 +14,12 @@ made to reuse, not duplicate, as many functions as possible */
 #include "ccx_decoders_vbi.h"
 #include "ccx_encoders_mcc.h"
 #include "ccx_dtvcc.h"
+#include "dvd_subtitle_decoder.h"
 
 #ifndef DISABLE_RUST
 extern int ccxr_process_cc_data(struct lib_cc_decode *dec_ctx, unsigned char *cc_data, int cc_count);
-extern void ccxr_flush_decoder(struct dtvcc_ctx *dtvcc, struct dtvcc_service_decoder *decoder);
+extern int ccxr_flush_active_decoders(struct lib_cc_decode *ctx);
+extern void ccxr_dtvcc_free(void *dtvcc_rust);
 #endif
 
 uint64_t utc_refvalue = UINT64_MAX; /* _UI64_MAX/UINT64_MAX means don't use UNIX, 0 = use current system time as reference, +1 use a specific reference */
@@ -232,11 +234,17 @@ int do_cb(struct lib_cc_decode *ctx, unsigned char *cc_block, struct cc_subtitle
 void dinit_cc_decode(struct lib_cc_decode **ctx)
 {
 	struct lib_cc_decode *lctx = *ctx;
+#ifndef DISABLE_RUST
+	ccxr_dtvcc_free(lctx->dtvcc_rust);
+	lctx->dtvcc_rust = NULL;
+#endif
 	dtvcc_free(&lctx->dtvcc);
 	dinit_avc(&lctx->avc_ctx);
 	ccx_decoder_608_dinit_library(&lctx->context_cc608_field_1);
 	ccx_decoder_608_dinit_library(&lctx->context_cc608_field_2);
 	dinit_timing_ctx(&lctx->timing);
+	if (lctx->is_alloc)
+		dvdsub_close_decoder(&lctx->private_data);
 	free_decoder_context(lctx->prev);
 	free_subtitle(lctx->dec_sub.prev);
 	freep(ctx);
@@ -263,6 +271,7 @@ struct lib_cc_decode *init_cc_decode(struct ccx_decoders_common_settings_t *sett
 
 	ctx->dtvcc = dtvcc_init(setting->settings_dtvcc);
 	ctx->dtvcc->is_active = setting->settings_dtvcc->enabled;
+	ctx->dtvcc_rust = NULL;
 
 	if (setting->codec == CCX_CODEC_ATSC_CC)
 	{
@@ -299,6 +308,7 @@ struct lib_cc_decode *init_cc_decode(struct ccx_decoders_common_settings_t *sett
 	ctx->hauppauge_mode = setting->hauppauge_mode;
 	ctx->saw_caption_block = 0;
 	ctx->program_number = setting->program_number;
+	ctx->stream_pid = 0;
 	ctx->processed_enough = 0;
 	ctx->max_gop_length = 0;
 	ctx->has_ccdata_buffered = 0;
@@ -316,6 +326,8 @@ struct lib_cc_decode *init_cc_decode(struct ccx_decoders_common_settings_t *sett
 	ctx->stat_divicom = 0;
 	ctx->false_pict_header = 0;
 	ctx->is_alloc = 0;
+	ctx->before_encode = setting->before_encode;
+	ctx->before_encode_arg = setting->before_encode_arg;
 
 	memcpy(&ctx->extraction_start, &setting->extraction_start, sizeof(struct ccx_boundary_time));
 	memcpy(&ctx->extraction_end, &setting->extraction_end, sizeof(struct ccx_boundary_time));
@@ -443,6 +455,11 @@ void flush_cc_decode(struct lib_cc_decode *ctx, struct cc_subtitle *sub)
 	}
 	if (ctx->dtvcc->is_active)
 	{
+#ifndef DISABLE_RUST
+		// The Rust decoder keeps its service decoders in ctx->dtvcc_rust
+		if (ccxr_flush_active_decoders(ctx))
+			ctx->current_field = 3;
+#else
 		for (int i = 0; i < CCX_DTVCC_MAX_SERVICES; i++)
 		{
 			dtvcc_service_decoder *decoder = &ctx->dtvcc->decoders[i];
@@ -451,13 +468,10 @@ void flush_cc_decode(struct lib_cc_decode *ctx, struct cc_subtitle *sub)
 			if (decoder->cc_count > 0)
 			{
 				ctx->current_field = 3;
-#ifndef DISABLE_RUST
-				ccxr_flush_decoder(ctx->dtvcc, decoder);
-#else
 				dtvcc_decoder_flush(ctx->dtvcc, decoder);
-#endif
 			}
 		}
+#endif
 	}
 }
 struct encoder_ctx *copy_encoder_context(struct encoder_ctx *ctx)
@@ -540,6 +554,8 @@ struct lib_cc_decode *copy_decoder_context(struct lib_cc_decode *ctx)
 		ctx_copy->dtvcc = malloc(sizeof(struct dtvcc_ctx));
 		memcpy(ctx_copy->dtvcc, ctx->dtvcc, sizeof(struct dtvcc_ctx));
 	}
+	// The Rust decoder refers to the original dtvcc, the copy creates its own when needed
+	ctx_copy->dtvcc_rust = NULL;
 	if (ctx->xds_ctx)
 	{
 		ctx_copy->xds_ctx = malloc(sizeof(struct ccx_decoders_xds_context));
@@ -593,6 +609,10 @@ void free_decoder_context(struct lib_cc_decode *ctx)
 	freep(&ctx->timing);
 	freep(&ctx->avc_ctx);
 	freep(&ctx->private_data);
+#ifndef DISABLE_RUST
+	ccxr_dtvcc_free(ctx->dtvcc_rust);
+	ctx->dtvcc_rust = NULL;
+#endif
 	freep(&ctx->dtvcc);
 	freep(&ctx->xds_ctx);
 	freep(&ctx->vbi_decoder);
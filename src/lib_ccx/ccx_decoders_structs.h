@@ -108,6 +108,8 @@ struct eia608_screen // A CC buffer
 	int cur_xds_packet_class;
 };
 
+struct encoder_ctx;
+
 struct ccx_decoders_common_settings_t
 {
 	LLONG subs_delay;                                          // ms to delay (or advance) subs
@@ -129,6 +131,9 @@ struct ccx_decoders_common_settings_t
 	int xds_write_to_file;
 	void *private_data;
 	int ocr_quantmode;
+	// Installed as before_encode on every decoder created with these settings
+	void (*before_encode)(void *arg, struct encoder_ctx *enc_ctx, struct cc_subtitle *sub);
+	void *before_encode_arg;
 };
 
 struct lib_cc_decode
@@ -163,6 +168,7 @@ struct lib_cc_decode
 	unsigned total_pulldownfields;
 	unsigned total_pulldownframes;
 	int program_number;
+	int stream_pid; // Non-zero if this decoder is bound to a single DVB stream (--dvblang all)
 	struct list_head list;
 	struct ccx_common_timing_ctx *timing;
 	enum ccx_code_type codec;
@@ -170,6 +176,10 @@ struct lib_cc_decode
 	int has_ccdata_buffered;
 	int is_alloc;
 
+	// If set, called by process_data() before each subtitle of this decoder is encoded
+	void (*before_encode)(void *arg, struct encoder_ctx *enc_ctx, struct cc_subtitle *sub);
+	void *before_encode_arg;
+
 	struct avc_ctx *avc_ctx;
 	void *private_data;
 
@@ -209,6 +219,7 @@ struct lib_cc_decode
     int false_pict_header;
 
 	dtvcc_ctx *dtvcc;
+	void *dtvcc_rust; // Persistent Rust 708 decoder, created by ccxr_process_cc_data()
 	int current_field;
 	// Analyse/use the picture information
 	int maxtref; // Use to remember the temporal reference number
@@ -218,6 +229,10 @@ struct lib_cc_decode
 	LLONG cc_fts[SORTBUF];
 	// Store HD CC packets
 	unsigned char cc_data_pkts[SORTBUF][10*31*3+1]; // *10, because MP4 seems to have different limits
+	// Indexes of the cc_data_pkts slots holding data, in ascending order,
+	// so flushing does not have to scan all SORTBUF slots.
+	unsigned char cc_seq_filled[SORTBUF];
+	int cc_seq_filled_count;
 
 	// The sequence number of the current anchor frame.  All currently read
 	// B-Frames belong to this I- or P-frame.
@@ -972,6 +972,7 @@ struct encoder_ctx *init_encoder(struct encoder_cfg *opt)
 	ctx->wrote_ccd_channel_header = false;
 
 	ctx->program_number = opt->program_number;
+	ctx->stream_pid = 0;
 	ctx->send_to_srv = opt->send_to_srv;
 	ctx->multiple_files = opt->multiple_files;
 	ctx->first_input_file = opt->first_input_file;
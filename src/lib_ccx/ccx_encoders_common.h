@@ -143,6 +143,7 @@ struct encoder_ctx
 	int new_sentence; // Capitalize next letter?
 
 	int program_number;
+	int stream_pid; // Non-zero if this encoder is bound to a single DVB stream (--dvblang all)
 	struct list_head list;
 
 	/* split-by-sentence stuff */
@@ -217,8 +217,11 @@ char *sbs_find_insert_point_partial(char *old_tail, const char *new_start, size_
 	int dist_r = -1;
 	int partial_shift;
 
-	dist_l = levenshtein_dist_char(old_tail, new_start, len_l, len_l);
-	dist_r = levenshtein_dist_char(old_tail + len_l, new_start + len_l, len_r, len_r);
+	// Only the error count of a match is used, so give up as soon as maxerr is exceeded
+	dist_l = levenshtein_dist_char_bounded(old_tail, new_start, len_l, len_l, maxerr);
+	if (dist_l > maxerr)
+		return NULL;
+	dist_r = levenshtein_dist_char_bounded(old_tail + len_l, new_start + len_l, len_r, len_r, maxerr - dist_l);
 
 	*errcount = dist_r + dist_l;
 
@@ -0,0 +1,12 @@
+/*
+ * the configured options and settings for CCExtractor
+ */
+
+#ifndef CCX_CCEXTRACTOR_COMPILE_REAL_H
+#define CCX_CCEXTRACTOR_COMPILE_REAL_H
+#define GIT_COMMIT "75df9bcd5a604ce2c8e076de6b59104c4d6e8535"
+#define COMPILE_DATE "2026-10-19"
+#endif
+
+#define CCExtractor_VERSION_MAJOR "0"
+#define CCExtractor_VERSION_MINOR "89"
@@ -181,7 +181,7 @@ typedef struct DVBSubContext
 	/* Store time in ms */
 	LLONG time_out;
 #ifdef ENABLE_OCR
-	void *ocr_ctx;
+	void *ocr_pool;
 #endif
 	DVBSubRegion *region_list;
 	DVBSubCLUT *clut_list;
@@ -189,6 +189,9 @@ typedef struct DVBSubContext
 
 	DVBSubRegionDisplay *display_list;
 	DVBSubDisplayDefinition *display_definition;
+
+	/* Hash of the last display set, see hash_display_set() */
+	uint64_t display_hash;
 } DVBSubContext;
 
 static __inline unsigned int bytestream_get_byte(const uint8_t **b)
@@ -281,6 +284,89 @@ static __inline unsigned int get_bits1(GetBitContext *s)
 	return result;
 }
 
+/**
+ * One entry of the 2-bit and 4-bit pixel code tables, indexed by the first
+ * byte of a code. That byte always tells the code apart, the run length
+ * and pixel code fields that follow it are read straight from the bit
+ * window.
+ */
+typedef struct DVBSubRLECode
+{
+	uint8_t bits;	    // Length of the whole code
+	uint8_t end;	    // 1 for end_of_string_signal
+	uint8_t run;	    // Run length, added to the run length field if there is one
+	uint8_t run_bits;   // Width of the run length field, 0 if none
+	uint8_t run_pos;    // Offset of the run length field in the code
+	uint8_t color_bits; // Width of the pixel code field, 0 for pixel code 0
+	uint8_t color_pos;  // Offset of the pixel code field in the code
+} DVBSubRLECode;
+
+static DVBSubRLECode rle_2bit_codes[256];
+static DVBSubRLECode rle_4bit_codes[256];
+
+static void set_rle_code(DVBSubRLECode *code, int bits, int run, int run_bits, int run_pos, int color_bits, int color_pos)
+{
+	code->bits = bits;
+	code->end = 0;
+	code->run = run;
+	code->run_bits = run_bits;
+	code->run_pos = run_pos;
+	code->color_bits = color_bits;
+	code->color_pos = color_pos;
+}
+
+/* ETSI EN 300 743, 7.2.5.2 */
+static void init_rle_tables(void)
+{
+	static int initialized = 0;
+	if (initialized)
+		return;
+
+	for (int b = 0; b < 256; b++)
+	{
+		DVBSubRLECode *code = &rle_2bit_codes[b];
+		if (b >> 6)
+			set_rle_code(code, 2, 1, 0, 0, 2, 0); // pixel code
+		else if (b & 0x20)
+			set_rle_code(code, 8, 3, 3, 3, 2, 6); // 00 1 LLL CC
+		else if (b & 0x10)
+			set_rle_code(code, 4, 1, 0, 0, 0, 0); // 00 01
+		else if ((b >> 2) == 0x2)
+			set_rle_code(code, 12, 12, 4, 6, 2, 10); // 00 00 10 LLLL CC
+		else if ((b >> 2) == 0x3)
+			set_rle_code(code, 16, 29, 8, 6, 2, 14); // 00 00 11 LLLLLLLL CC
+		else if ((b >> 2) == 0x1)
+			set_rle_code(code, 6, 2, 0, 0, 0, 0); // 00 00 01
+		else
+		{
+			set_rle_code(code, 6, 0, 0, 0, 0, 0); // 00 00 00
+			code->end = 1;
+		}
+
+		code = &rle_4bit_codes[b];
+		if (b >> 4)
+			set_rle_code(code, 4, 1, 0, 0, 4, 0); // pixel code
+		else if ((b & 0x08) == 0 && (b & 0x07))
+			set_rle_code(code, 8, 2, 3, 5, 0, 0); // 0000 0 LLL
+		else if ((b & 0x08) == 0)
+		{
+			set_rle_code(code, 8, 0, 0, 0, 0, 0); // 0000 0 000
+			code->end = 1;
+		}
+		else if ((b & 0x04) == 0)
+			set_rle_code(code, 12, 4, 2, 6, 4, 8); // 0000 10 LL CCCC
+		else if ((b & 0x03) == 0x2)
+			set_rle_code(code, 16, 9, 4, 8, 4, 12); // 0000 11 10 LLLL CCCC
+		else if ((b & 0x03) == 0x3)
+			set_rle_code(code, 20, 25, 8, 8, 4, 16); // 0000 11 11 LLLLLLLL CCCC
+		else if ((b & 0x03) == 0x1)
+			set_rle_code(code, 8, 2, 0, 0, 0, 0); // 0000 11 01
+		else
+			set_rle_code(code, 8, 1, 0, 0, 0, 0); // 0000 11 00
+	}
+	initialized = 1;
+}
+
 static DVBSubObject *get_object(DVBSubContext *ctx, int object_id)
 {
 	DVBSubObject *ptr = ctx->object_list;
@@ -418,12 +504,14 @@ static void delete_regions(DVBSubContext *ctx)
  * @return DVB context kept as void* for abstraction
  *
  */
-void *dvbsub_init_decoder(struct dvb_config *cfg, int initialized_ocr)
+void *dvbsub_init_decoder(struct dvb_config *cfg)
 {
 	int i, r, g, b, a = 0;
 	DVBSubContext *ctx = (DVBSubContext *)malloc(sizeof(DVBSubContext));
 	memset(ctx, 0, sizeof(DVBSubContext));
 
+	init_rle_tables();
+
 	if (cfg)
 	{
 		ctx->composition_id = cfg->composition_id[0];
@@ -438,8 +526,9 @@ void *dvbsub_init_decoder(struct dvb_config *cfg, int initialized_ocr)
 	}
 
 #ifdef ENABLE_OCR
-	if (!initialized_ocr)
-		ctx->ocr_ctx = init_ocr(ctx->lang_index);
+	// One worker is enough, only one subtitle per stream is OCR'ed at a time.
+	// Tesseract itself is only loaded once the first subtitle needs it.
+	ctx->ocr_pool = init_ocr_pool(ctx->lang_index, 1);
 #endif
 	ctx->version = -1;
 
@@ -543,21 +632,40 @@ int dvbsub_close_decoder(void **dvb_ctx)
 	}
 
 #ifdef ENABLE_OCR
-	if (ctx->ocr_ctx)
-		delete_ocr(&ctx->ocr_ctx);
+	if (ctx->ocr_pool)
+		delete_ocr_pool(&ctx->ocr_pool);
 #endif
 	freep(dvb_ctx);
 	return 0;
 }
 
-static int dvbsub_read_2bit_string(uint8_t *destbuf, int dbuf_len,
-				   const uint8_t **srcbuf, int buf_size, int non_mod, uint8_t *map_table,
-				   int x_pos)
+void dvbsub_wait_ocr(void *dvb_ctx)
 {
-	GetBitContext gb;
+#ifdef ENABLE_OCR
+	DVBSubContext *ctx = (DVBSubContext *)dvb_ctx;
+	if (ctx && ctx->ocr_pool)
+		ocr_pool_wait(ctx->ocr_pool);
+#endif
+}
 
-	int bits;
-	int run_length;
+const char *dvbsub_get_language(void *dvb_ctx)
+{
+	DVBSubContext *ctx = (DVBSubContext *)dvb_ctx;
+	if (!ctx || ctx->lang_index < 0 || ctx->lang_index >= NB_LANGUAGE || !language[ctx->lang_index])
+		return language[0];
+	return language[ctx->lang_index];
+}
+
+/**
+ * Decode a 2-bit or 4-bit/pixel code string with one table lookup per code
+ * and runs filled with memset.
+ */
+static int dvbsub_read_rle_string(const DVBSubRLECode *codes, int stuffing_bits,
+				  uint8_t *destbuf, int dbuf_len,
+				  const uint8_t **srcbuf, int buf_size, int non_mod, uint8_t *map_table,
+				  int x_pos)
+{
+	GetBitContext gb;
 	int pixels_read = x_pos;
 
 	init_get_bits(&gb, *srcbuf, buf_size << 3);
@@ -566,276 +674,63 @@ static int dvbsub_read_2bit_string(uint8_t *destbuf, int dbuf_len,
 
 	while (get_bits_count(&gb) < buf_size << 3 && pixels_read < dbuf_len)
 	{
-		bits = get_bits(&gb, 2);
-
-		if (bits)
+		// At least 25 valid bits, the longest code is 20
+		uint32_t window = RB32(gb.buffer + (gb.index >> 3)) << (gb.index & 7);
+		const DVBSubRLECode *code = &codes[window >> 24];
+		int run = code->run;
+		int color = 0;
+
+		gb.index = MIN(gb.index + code->bits, gb.size_in_bits_plus8);
+		if (code->end)
 		{
-			if (non_mod != 1 || bits != 1)
-			{
-				if (map_table)
-					*destbuf++ = map_table[bits];
-				else
-					*destbuf++ = bits;
-			}
-			pixels_read++;
+			(*srcbuf) += (get_bits_count(&gb) + 7) >> 3;
+			return pixels_read;
 		}
-		else
-		{
-			bits = get_bits1(&gb);
-			if (bits == 1)
-			{
-				run_length = get_bits(&gb, 3) + 3;
-				bits = get_bits(&gb, 2);
+		if (code->run_bits)
+			run += (window << code->run_pos) >> (32 - code->run_bits);
+		if (code->color_bits)
+			color = (window << code->color_pos) >> (32 - code->color_bits);
 
-				if (non_mod == 1 && bits == 1)
-					pixels_read += run_length;
-				else
-				{
-					if (map_table)
-						bits = map_table[bits];
-					while (run_length-- > 0 && pixels_read < dbuf_len)
-					{
-						*destbuf++ = bits;
-						pixels_read++;
-					}
-				}
-			}
-			else
-			{
-				bits = get_bits1(&gb);
-				if (bits == 0)
-				{
-					bits = get_bits(&gb, 2);
-					if (bits == 2)
-					{
-						run_length = get_bits(&gb, 4) + 12;
-						bits = get_bits(&gb, 2);
-
-						if (non_mod == 1 && bits == 1)
-							pixels_read += run_length;
-						else
-						{
-							if (map_table)
-								bits = map_table[bits];
-							while (run_length-- > 0 && pixels_read < dbuf_len)
-							{
-								*destbuf++ = bits;
-								pixels_read++;
-							}
-						}
-					}
-					else if (bits == 3)
-					{
-						run_length = get_bits(&gb, 8) + 29;
-						bits = get_bits(&gb, 2);
-
-						if (non_mod == 1 && bits == 1)
-							pixels_read += run_length;
-						else
-						{
-							if (map_table)
-								bits = map_table[bits];
-							while (run_length-- > 0 && pixels_read < dbuf_len)
-							{
-								*destbuf++ = bits;
-								pixels_read++;
-							}
-						}
-					}
-					else if (bits == 1)
-					{
-						if (map_table)
-							bits = map_table[0];
-						else
-							bits = 0;
-						run_length = 2;
-						while (run_length-- > 0 && pixels_read < dbuf_len)
-						{
-							*destbuf++ = bits;
-							pixels_read++;
-						}
-					}
-					else
-					{
-						(*srcbuf) += (get_bits_count(&gb) + 7) >> 3;
-						return pixels_read;
-					}
-				}
-				else
-				{
-					if (map_table)
-						bits = map_table[0];
-					else
-						bits = 0;
-					*destbuf++ = bits;
-					pixels_read++;
-				}
-			}
+		if (non_mod == 1 && color == 1)
+		{
+			pixels_read += run;
+			continue;
 		}
+		if (map_table)
+			color = map_table[color];
+		if (run > dbuf_len - pixels_read)
+			run = dbuf_len - pixels_read;
+		memset(destbuf, color, run);
+		destbuf += run;
+		pixels_read += run;
 	}
 
-	if (get_bits(&gb, 6))
-	{
-		mprint("DVBSub error: line overflow at dvbsub_read_2bit_string()\n");
+	if (get_bits(&gb, stuffing_bits))
 		return -1;
-	}
 
 	(*srcbuf) += (get_bits_count(&gb) + 7) >> 3;
 
 	return pixels_read;
 }
 
-static int dvbsub_read_4bit_string(uint8_t *destbuf, int dbuf_len,
+static int dvbsub_read_2bit_string(uint8_t *destbuf, int dbuf_len,
 				   const uint8_t **srcbuf, int buf_size, int non_mod, uint8_t *map_table,
 				   int x_pos)
 {
-	GetBitContext gb;
-
-	int bits;
-	int run_length;
-	int pixels_read = x_pos;
-
-	init_get_bits(&gb, *srcbuf, buf_size << 3);
-
-	destbuf += x_pos;
-
-	while (get_bits_count(&gb) < buf_size << 3 && pixels_read < dbuf_len)
-	{
-		bits = get_bits(&gb, 4);
-
-		if (bits)
-		{
-			if (non_mod != 1 || bits != 1)
-			{
-				if (map_table)
-					*destbuf++ = map_table[bits];
-				else
-					*destbuf++ = bits;
-			}
-			pixels_read++;
-		}
-		else
-		{
-			bits = get_bits1(&gb);
-			if (bits == 0)
-			{
-				run_length = get_bits(&gb, 3);
-
-				if (run_length == 0)
-				{
-					(*srcbuf) += (get_bits_count(&gb) + 7) >> 3;
-					return pixels_read;
-				}
-
-				run_length += 2;
-
-				if (map_table)
-					bits = map_table[0];
-				else
-					bits = 0;
-
-				while (run_length-- > 0 && pixels_read < dbuf_len)
-				{
-					*destbuf++ = bits;
-					pixels_read++;
-				}
-			}
-			else
-			{
-				bits = get_bits1(&gb);
-				if (bits == 0)
-				{
-					run_length = get_bits(&gb, 2) + 4;
-					bits = get_bits(&gb, 4);
-
-					if (non_mod == 1 && bits == 1)
-						pixels_read += run_length;
-					else
-					{
-						if (map_table)
-							bits = map_table[bits];
-						while (run_length-- > 0 && pixels_read < dbuf_len)
-						{
-							*destbuf++ = bits;
-							pixels_read++;
-						}
-					}
-				}
-				else
-				{
-					bits = get_bits(&gb, 2);
-					if (bits == 2)
-					{
-						run_length = get_bits(&gb, 4) + 9;
-						bits = get_bits(&gb, 4);
-
-						if (non_mod == 1 && bits == 1)
-							pixels_read += run_length;
-						else
-						{
-							if (map_table)
-								bits = map_table[bits];
-							while (run_length-- > 0 && pixels_read < dbuf_len)
-							{
-								*destbuf++ = bits;
-								pixels_read++;
-							}
-						}
-					}
-					else if (bits == 3)
-					{
-						run_length = get_bits(&gb, 8) + 25;
-						bits = get_bits(&gb, 4);
-
-						if (non_mod == 1 && bits == 1)
-							pixels_read += run_length;
-						else
-						{
-							if (map_table)
-								bits = map_table[bits];
-							while (run_length-- > 0 && pixels_read < dbuf_len)
-							{
-								*destbuf++ = bits;
-								pixels_read++;
-							}
-						}
-					}
-					else if (bits == 1)
-					{
-						if (map_table)
-							bits = map_table[0];
-						else
-							bits = 0;
-						run_length = 2;
-						while (run_length-- > 0 && pixels_read < dbuf_len)
-						{
-							*destbuf++ = bits;
-							pixels_read++;
-						}
-					}
-					else
-					{
-						if (map_table)
-							bits = map_table[0];
-						else
-							bits = 0;
-						*destbuf++ = bits;
-						pixels_read++;
-					}
-				}
-			}
-		}
-	}
+	int ret = dvbsub_read_rle_string(rle_2bit_codes, 6, destbuf, dbuf_len, srcbuf, buf_size, non_mod, map_table, x_pos);
+	if (ret < 0)
+		mprint("DVBSub error: line overflow at dvbsub_read_2bit_string()\n");
+	return ret;
+}
 
-	if (get_bits(&gb, 8))
-	{
+static int dvbsub_read_4bit_string(uint8_t *destbuf, int dbuf_len,
+				   const uint8_t **srcbuf, int buf_size, int non_mod, uint8_t *map_table,
+				   int x_pos)
+{
+	int ret = dvbsub_read_rle_string(rle_4bit_codes, 8, destbuf, dbuf_len, srcbuf, buf_size, non_mod, map_table, x_pos);
+	if (ret < 0)
 		mprint("DVBSub error: line overflow at dvbsub_read_4bit_string()\n");
-		return -1;
-	}
-
-	(*srcbuf) += (get_bits_count(&gb) + 7) >> 3;
-
-	return pixels_read;
+	return ret;
 }
 
 static int dvbsub_read_8bit_string(uint8_t *destbuf, int dbuf_len,
@@ -863,44 +758,34 @@ static int dvbsub_read_8bit_string(uint8_t *destbuf, int dbuf_len,
 					*destbuf++ = bits;
 			}
 			pixels_read++;
+			continue;
+		}
+
+		bits = *(*srcbuf)++;
+		run_length = bits & 0x7f;
+		if ((bits & 0x80) == 0)
+		{
+			if (run_length == 0)
+				return pixels_read;
+			bits = 0;
 		}
 		else
 		{
 			bits = *(*srcbuf)++;
-			run_length = bits & 0x7f;
-			if ((bits & 0x80) == 0)
+			if (non_mod == 1 && bits == 1)
 			{
-				if (run_length == 0)
-				{
-					return pixels_read;
-				}
-
-				if (map_table)
-					bits = map_table[0];
-				else
-					bits = 0;
-				while (run_length-- > 0 && pixels_read < dbuf_len)
-				{
-					*destbuf++ = bits;
-					pixels_read++;
-				}
-			}
-			else
-			{
-				bits = *(*srcbuf)++;
-
-				if (non_mod == 1 && bits == 1)
-					pixels_read += run_length;
-				if (map_table)
-					bits = map_table[bits];
-				else
-					while (run_length-- > 0 && pixels_read < dbuf_len)
-					{
-						*destbuf++ = bits;
-						pixels_read++;
-					}
+				pixels_read += run_length;
+				continue;
 			}
 		}
+
+		if (map_table)
+			bits = map_table[bits];
+		if (run_length > dbuf_len - pixels_read)
+			run_length = dbuf_len - pixels_read;
+		memset(destbuf, bits, run_length);
+		destbuf += run_length;
+		pixels_read += run_length;
 	}
 
 	if (*(*srcbuf)++)
@@ -1481,6 +1366,56 @@ static void dvbsub_parse_display_definition_segment(void *dvb_ctx,
 	}
 }
 
+/**
+ * FNV-1a over everything write_dvb_sub() would turn into a bitmap: the
+ * display offset, the position of each displayed region, its pixels and
+ * its CLUT. Page refreshes that re-send an unchanged page hash the same.
+ */
+static uint64_t hash_display_set(DVBSubContext *ctx)
+{
+	uint64_t hash = FNV1A_64_INIT;
+	DVBSubRegionDisplay *display;
+
+	if (ctx->display_definition)
+	{
+		hash = fnv1a_64(hash, &ctx->display_definition->x, sizeof(int));
+		hash = fnv1a_64(hash, &ctx->display_definition->y, sizeof(int));
+	}
+	for (display = ctx->display_list; display; display = display->next)
+	{
+		DVBSubRegion *region = get_region(ctx, display->region_id);
+		DVBSubCLUT *clut;
+
+		if (!region)
+			continue;
+		hash = fnv1a_64(hash, &display->x_pos, sizeof(int));
+		hash = fnv1a_64(hash, &display->y_pos, sizeof(int));
+		hash = fnv1a_64(hash, &region->width, sizeof(int));
+		hash = fnv1a_64(hash, &region->height, sizeof(int));
+		hash = fnv1a_64(hash, &region->depth, sizeof(int));
+		hash = fnv1a_64(hash, &region->dirty, sizeof(int));
+		hash = fnv1a_64(hash, region->pbuf, region->width * region->height);
+
+		clut = get_clut(ctx, region->clut);
+		if (!clut)
+			clut = &default_clut;
+		switch (region->depth)
+		{
+			case 2:
+				hash = fnv1a_64(hash, clut->clut4, sizeof(clut->clut4));
+				break;
+			case 8:
+				hash = fnv1a_64(hash, clut->clut256, sizeof(clut->clut256));
+				break;
+			case 4:
+			default:
+				hash = fnv1a_64(hash, clut->clut16, sizeof(clut->clut16));
+				break;
+		}
+	}
+	return hash;
+}
+
 /**
  * Write Subtitle in cc_subtitle structure in CC_BITMAP format
  * when OCR subsystem is present then it also write recognised text in
@@ -1658,22 +1593,11 @@ static int write_dvb_sub(struct lib_cc_decode *dec_ctx, struct cc_subtitle *sub)
 
 	sub->nb_data = 1; // Set nb_data to 1 since we have merged the images into one image.
 
-	// Perform OCR
+	// Perform OCR, in the background. The result is picked up by dvbsub_wait_ocr()
 #ifdef ENABLE_OCR
-	char *ocr_str = NULL;
-	if (ctx->ocr_ctx)
-	{
-		int ret = ocr_rect(ctx->ocr_ctx, rect, &ocr_str, region->bgcolor, dec_ctx->ocr_quantmode);
-		if (ret >= 0)
-			rect->ocr_text = ocr_str;
-		else
-			rect->ocr_text = NULL;
-		dbg_print(CCX_DMT_DVB, "\nOCR Result: %s\n", rect->ocr_text ? rect->ocr_text : "NULL");
-	}
-	else
-	{
-		rect->ocr_text = NULL;
-	}
+	rect->ocr_text = NULL;
+	if (ctx->ocr_pool)
+		ocr_pool_submit(ctx->ocr_pool, rect, region->bgcolor, dec_ctx->ocr_quantmode);
 #endif
 	return 0;
 }
@@ -1683,8 +1607,35 @@ void dvbsub_handle_display_segment(struct encoder_ctx *enc_ctx,
 				   struct cc_subtitle *sub)
 {
 	DVBSubContext *ctx = (DVBSubContext *)dec_ctx->private_data;
+	uint64_t display_hash;
+	LLONG now;
 	if (!enc_ctx)
 		return;
+
+	// Broadcasters re-send the page periodically. If nothing visible changed
+	// and the previous subtitle has not timed out yet, it simply stays on
+	// screen for another page time-out. Once it has, the repeat starts a new
+	// subtitle, so the gap stays in the output.
+	display_hash = hash_display_set(ctx);
+	now = (dec_ctx->timing->current_pts - dec_ctx->timing->min_pts) / (MPEG_CLOCK_FREQ / 1000);
+	if (enc_ctx->write_previous && sub->prev && display_hash == ctx->display_hash &&
+	    now - sub->prev->start_time < sub->prev->time_out)
+	{
+		sub->prev->time_out = now - sub->prev->start_time + ctx->time_out;
+		dbg_print(CCX_DMT_DVB, "\nDisplay set unchanged, extending previous subtitle to %lld\n",
+			  sub->prev->start_time + sub->prev->time_out);
+		return;
+	}
+	ctx->display_hash = display_hash;
+
+	dvbsub_wait_ocr(ctx);
+#ifdef ENABLE_OCR
+	if (enc_ctx->write_previous && sub->prev && sub->prev->data)
+	{
+		struct cc_bitmap *rect = sub->prev->data;
+		dbg_print(CCX_DMT_DVB, "\nOCR Result: %s\n", rect->ocr_text ? rect->ocr_text : "NULL");
+	}
+#endif
 	if (enc_ctx->write_previous) // this condition is used for the first subtitle - write_previous will be 0 first so we don't encode a non-existing previous sub
 	{
 		enc_ctx->prev->last_string = NULL;									    // Reset last recognized sub text
@@ -1745,8 +1696,9 @@ void dvbsub_handle_display_segment(struct encoder_ctx *enc_ctx,
 	if (sub->prev)
 	{
 		struct cc_bitmap *content_prev = sub->prev->data;
+		// OCR of the previous subtitle may still be running, don't touch ocr_text
 		dbg_print(CCX_DMT_DVB, "\nPrevious subtitle %x (%s)\nStart time: %lld; End time: %lld",
-			  sub->prev, content_prev ? (content_prev->ocr_text ? content_prev->ocr_text : "NULL OCR") : "NULL DATA",
+			  sub->prev, content_prev ? "OCR pending" : "NULL DATA",
 			  sub->prev->start_time, sub->prev->end_time);
 	}
 	struct cc_bitmap *content = sub->data;
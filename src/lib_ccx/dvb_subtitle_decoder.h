@@ -42,10 +42,25 @@ extern "C"
 	* @return DVB context kept as void* for abstraction
 	*
 	*/
-	void* dvbsub_init_decoder(struct dvb_config* cfg, int initialized_ocr);
+	void* dvbsub_init_decoder(struct dvb_config* cfg);
 
 	int dvbsub_close_decoder(void **dvb_ctx);
 
+	/**
+	* Block until the OCR of the last written subtitle is done, so that
+	* its ocr_text can be read and the subtitle encoded or freed.
+	*
+	* @param dvb_ctx DVB context returned by dvbsub_init_decoder
+	*/
+	void dvbsub_wait_ocr(void *dvb_ctx);
+
+	/**
+	* @param dvb_ctx DVB context returned by dvbsub_init_decoder
+	*
+	* @return ISO 639-2 code of the stream language, "und" if unknown
+	*/
+	const char *dvbsub_get_language(void *dvb_ctx);
+
 	/**
 	* @param dvb_ctx    PreInitialized DVB context using DVB
 	* @param buf        buffer containing segment data, first sync byte need to 0x0f.
@@ -24,9 +24,6 @@ struct DVD_Ctx
 	struct ctrl_seq *ctrl;
 	int append;
 	unsigned char *bitmap;
-#ifdef ENABLE_OCR
-	void *ocr_ctx;
-#endif
 };
 
 struct ctrl_seq
@@ -97,6 +94,7 @@ void get_bitmap(struct DVD_Ctx *ctx)
 	m = 0;
 	nextbyte = ctx->buffer[pos];
 
+	freep(&ctx->bitmap);
 	ctx->bitmap = malloc(w * h);
 	buffp = ctx->bitmap;
 	if (!buffp)
@@ -369,9 +367,10 @@ int write_dvd_sub(struct lib_cc_decode *dec_ctx, struct DVD_Ctx *ctx, struct cc_
 
 #ifdef ENABLE_OCR
 	char *ocr_str = NULL;
-	int ret = ocr_rect(ctx->ocr_ctx, rect, &ocr_str, 0, dec_ctx->ocr_quantmode);
-	if (ret >= 0)
+	void *ocr_ctx = acquire_ocr(1);
+	if (ocr_ctx && ocr_rect(ocr_ctx, rect, &ocr_str, 0, dec_ctx->ocr_quantmode) >= 0)
 		rect->ocr_text = ocr_str;
+	release_ocr(&ocr_ctx);
 #endif
 
 	return 0;
@@ -426,20 +425,24 @@ int process_spu(struct lib_cc_decode *dec_ctx, unsigned char *buff, int length,
 
 	write_dvd_sub(dec_ctx, ctx, sub);
 	// dec_ctx->got_output = 1;
-	// free(ctx);
-	// #ifdef ENABLE_OCR
-	// 	delete_ocr(&ctx->ocr_ctx);
-	// #endif
 	return length;
 }
 
 void *init_dvdsub_decode()
 {
 	struct DVD_Ctx *ctx = malloc(sizeof(struct DVD_Ctx));
-#ifdef ENABLE_OCR
-	ctx->ocr_ctx = init_ocr(1);
-#endif
 	ctx->ctrl = malloc(sizeof(struct ctrl_seq));
 	ctx->append = 0;
+	ctx->bitmap = NULL;
 	return (void *)ctx;
 }
+
+void dvdsub_close_decoder(void **dvd_ctx)
+{
+	struct DVD_Ctx *ctx = (struct DVD_Ctx *)*dvd_ctx;
+	if (!ctx)
+		return;
+	freep(&ctx->ctrl);
+	freep(&ctx->bitmap);
+	freep(dvd_ctx);
+}
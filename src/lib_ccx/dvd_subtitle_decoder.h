@@ -8,6 +8,11 @@
  */
 void *init_dvdsub_decode();
 
+/**
+ * @param dvd_ctx	DVD context returned by init_dvdsub_decode(), set to NULL
+ */
+void dvdsub_close_decoder(void **dvd_ctx);
+
 /**
  * @param buffer	buffer containing the spu packet data
  * @param length	Length of the data buffer received
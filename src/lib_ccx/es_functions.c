@@ -17,6 +17,7 @@ static int pic_coding_ext(struct lib_cc_decode *ctx, struct bitstream *esstream)
 static int read_eau_info(struct encoder_ctx *enc_ctx, struct lib_cc_decode *ctx, struct bitstream *esstream, int udtype, struct cc_subtitle *sub);
 static int extension_and_user_data(struct encoder_ctx *enc_ctx, struct lib_cc_decode *ctx, struct bitstream *esstream, int udtype, struct cc_subtitle *sub);
 static int read_pic_data(struct bitstream *esstream);
+static unsigned char *skip_slices(unsigned char *pos, unsigned char *end, unsigned char **last_slice);
 
 #define debug(...) ccx_common_logging.debug_ftn(CCX_DMT_VERBOSE, __VA_ARGS__)
 /* Process a mpeg-2 data stream with "length" bytes in buffer "data".
@@ -1044,39 +1045,56 @@ static int read_pic_data(struct bitstream *esstream)
 	// after getting more.
 	unsigned char *slice_start = esstream->pos;
 
-	do
+	// Slices carry no caption data, jump straight to the first start
+	// code that is not a slice_start_code.
+	unsigned char *next = skip_slices(slice_start, esstream->end, &slice_start);
+	if (next == NULL)
 	{
-		startcode = next_start_code(esstream);
-		// Syntax check
-		if (startcode == 0xB4)
-		{
-			if (esstream->bitsleft < 0)
-				init_bitstream(esstream, slice_start, esstream->end);
+		init_bitstream(esstream, slice_start, esstream->end);
+		debug("read_pic_data: reached end of bitstream.\n");
+		return 0;
+	}
 
-			if (esstream->error)
-				debug("read_pic_data: syntax problem.\n");
-			else
-				debug("read_pic_data: reached end of bitstream.\n");
+	// A following 0xB4 start code is reported by the next call to
+	// next_start_code().
+	init_bitstream(esstream, next, esstream->end);
 
-			return 0;
-		}
+	debug("Read Pic Data - processed\n");
 
-		slice_start = esstream->pos; // No need to come back
+	return 1;
+}
 
-		if (startcode >= 0x01 && startcode <= 0xAF)
-		{
-			skip_u32(esstream);	     // Advance bitstream
-			search_start_code(esstream); // Skip this slice
-		}
-	} while (startcode >= 0x01 && startcode <= 0xAF);
+// Skip the slice starting with the slice_start_code at pos and all slices
+// following it. Return a pointer to the first start code after them that
+// is not a slice_start_code (0x01 to 0xAF), or NULL if end is reached
+// first. *last_slice is set to the last slice_start_code seen, this is
+// where the search has to restart once more data is available.
+// The scan uses memchr() for the 0x01 byte of the start code prefix and
+// does not go through the bitstream functions for every slice.
+static unsigned char *skip_slices(unsigned char *pos, unsigned char *end, unsigned char **last_slice)
+{
+	// The prefix of the next start code cannot begin before the end of
+	// the current one, so its 0x01 byte is at least 6 bytes in.
+	unsigned char *tstr = pos + 6;
 
-	if (esstream->bitsleft < 0)
+	while (tstr < end)
 	{
-		init_bitstream(esstream, slice_start, esstream->end);
-		return 0;
-	}
+		tstr = (unsigned char *)memchr(tstr, 0x01, end - tstr);
+		if (tstr == NULL || tstr + 1 >= end)
+			return NULL;
 
-	debug("Read Pic Data - processed\n");
+		if (tstr[-1] != 0x00 || tstr[-2] != 0x00)
+		{
+			tstr++;
+			continue;
+		}
 
-	return 1;
+		// Found 0x000001??
+		if (tstr[1] < 0x01 || tstr[1] > 0xAF)
+			return tstr - 2;
+
+		*last_slice = tstr - 2;
+		tstr += 4;
+	}
+	return NULL;
 }
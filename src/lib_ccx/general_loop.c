@@ -667,7 +667,7 @@ int process_data(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, str
 		// telxcc_update_gt(dec_ctx->private_data, ctx->demux_ctx->global_timestamp);
 		if (enc_ctx)
 		{
-			ret = tlt_process_pes_packet(dec_ctx, data_node->buffer, data_node->len, dec_sub, enc_ctx->sentence_cap);
+			ret = tlt_process_pes_packet(enc_ctx, dec_ctx, data_node->buffer, data_node->len, dec_sub);
 			if (ret == CCX_EINVAL)
 				return ret;
 		}
@@ -752,6 +752,8 @@ int process_data(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, str
 	if (data_node->bufferdatatype != CCX_DVB_SUBTITLE && dec_sub->got_output)
 	{
 		ret = 1;
+		if (dec_ctx->before_encode)
+			dec_ctx->before_encode(dec_ctx->before_encode_arg, enc_ctx, dec_sub);
 		encode_sub(enc_ctx, dec_sub);
 		dec_sub->got_output = 0;
 	}
@@ -830,6 +832,91 @@ void segment_output_file(struct lib_ccx_ctx *ctx, struct lib_cc_decode *dec_ctx)
 		}
 	}
 }
+
+/**
+ * With --dvblang all, decode the DVB streams that get_best_stream() didn't
+ * pick from the same demuxed data, each with its own decoder and output.
+ * Those are only created once a stream carries data, so streams without
+ * subtitles leave no empty files behind.
+ */
+static void process_dvb_sibling_streams(struct lib_ccx_ctx *ctx,
+					struct demuxer_data *datalist,
+					struct lib_cc_decode *main_dec_ctx,
+					int main_pid,
+					int *caps)
+{
+	struct cap_info *iter;
+	int flush = !(!terminate_asap && !end_of_file && is_decoder_processed_enough(ctx) == CCX_FALSE);
+
+	list_for_each_entry(iter, &ctx->demux_ctx->cinfo_tree.all_stream, all_stream, struct cap_info)
+	{
+		struct lib_cc_decode *dec_ctx = NULL;
+		struct encoder_ctx *enc_ctx = NULL;
+		struct demuxer_data *data_node;
+		int ret;
+
+		if (iter->codec != CCX_CODEC_DVB || iter->ignore || iter->pid == main_pid || !iter->codec_private_data)
+			continue;
+
+		data_node = get_data_stream(datalist, iter->pid);
+		if (data_node)
+		{
+			dec_ctx = update_decoder_list_stream(ctx, iter);
+			enc_ctx = update_encoder_list_stream(ctx, iter, dvbsub_get_language(iter->codec_private_data));
+		}
+		else
+		{
+			struct lib_cc_decode *dec_iter;
+			struct encoder_ctx *enc_iter;
+
+			list_for_each_entry(dec_iter, &ctx->dec_ctx_head, list, struct lib_cc_decode)
+			{
+				if (dec_iter->stream_pid == iter->pid)
+					dec_ctx = dec_iter;
+			}
+			if (!dec_ctx)
+				continue; // No data for this stream so far
+			list_for_each_entry(enc_iter, &ctx->enc_ctx_head, list, struct encoder_ctx)
+			{
+				if (enc_iter->stream_pid == iter->pid)
+					enc_ctx = enc_iter;
+			}
+		}
+
+		// All DVB streams are synced with audio, so they share the min_pts of the main one
+		if (dec_ctx->timing->min_pts == 0x01FFFFFFFFLL && main_dec_ctx->timing->min_pts != 0x01FFFFFFFFLL)
+		{
+			set_current_pts(dec_ctx->timing, main_dec_ctx->timing->min_pts);
+			set_fts(dec_ctx->timing);
+		}
+		if (enc_ctx)
+			enc_ctx->timing = dec_ctx->timing;
+
+		if (data_node)
+		{
+			if (data_node->pts != CCX_NOPTS)
+			{
+				set_current_pts(dec_ctx->timing, data_node->pts);
+				set_fts(dec_ctx->timing);
+			}
+
+			ret = process_data(enc_ctx, dec_ctx, data_node);
+			if (enc_ctx && (enc_ctx->srt_counter || dec_ctx->saw_caption_block || ret == 1))
+				*caps = 1;
+		}
+
+		// Process the last subtitle for DVB, whether or not the stream had data in this chunk
+		if (flush && dec_ctx->dec_sub.prev && dec_ctx->dec_sub.prev->end_time == 0)
+		{
+			dec_ctx->dec_sub.prev->end_time = (dec_ctx->timing->current_pts - dec_ctx->timing->min_pts) / (MPEG_CLOCK_FREQ / 1000);
+			dvbsub_wait_ocr(dec_ctx->private_data);
+			if (enc_ctx != NULL)
+				encode_sub(enc_ctx->prev, dec_ctx->dec_sub.prev);
+			dec_ctx->dec_sub.prev->got_output = 0;
+		}
+	}
+}
+
 int process_non_multiprogram_general_loop(struct lib_ccx_ctx *ctx,
 					  struct demuxer_data **datalist,
 					  struct demuxer_data **data_node,
@@ -978,12 +1065,16 @@ int process_non_multiprogram_general_loop(struct lib_ccx_ctx *ctx,
 			if ((*data_node)->bufferdatatype == CCX_DVB_SUBTITLE && (*dec_ctx)->dec_sub.prev->end_time == 0)
 			{
 				(*dec_ctx)->dec_sub.prev->end_time = ((*dec_ctx)->timing->current_pts - (*dec_ctx)->timing->min_pts) / (MPEG_CLOCK_FREQ / 1000);
+				dvbsub_wait_ocr((*dec_ctx)->private_data);
 				if ((*enc_ctx) != NULL)
 					encode_sub((*enc_ctx)->prev, (*dec_ctx)->dec_sub.prev);
 				(*dec_ctx)->dec_sub.prev->got_output = 0;
 			}
 		}
 	}
+
+	if (ccx_options.dvb_all_streams && (*dec_ctx)->codec == CCX_CODEC_DVB)
+		process_dvb_sibling_streams(ctx, *datalist, *dec_ctx, pid, caps);
 	return ret;
 }
 
@@ -1150,6 +1241,7 @@ int general_loop(struct lib_ccx_ctx *ctx)
 					if (data_node->bufferdatatype == CCX_DVB_SUBTITLE && dec_ctx && dec_ctx->dec_sub.prev && dec_ctx->dec_sub.prev->end_time == 0)
 					{
 						dec_ctx->dec_sub.prev->end_time = (dec_ctx->timing->current_pts - dec_ctx->timing->min_pts) / (MPEG_CLOCK_FREQ / 1000);
+						dvbsub_wait_ocr(dec_ctx->private_data);
 						if (enc_ctx != NULL)
 							encode_sub(enc_ctx->prev, dec_ctx->dec_sub.prev);
 						dec_ctx->dec_sub.prev->got_output = 0;
@@ -64,4 +64,75 @@ const uint8_t UNHAM_8_4[256] = {
 	0x08, 0xff, 0xff, 0x05, 0xff, 0x0e, 0x0d, 0xff, 0xff, 0x0e, 0x0f, 0xff, 0x0e, 0x0e, 0xff, 0x0e
 };
 
+// ETS 300 706, chapter 8.3: contribution of each byte of a Hamming 24/18 triplet to the
+// syndrome. Bit i of the triplet contributes (i + 33) for i < 23, bit 23 only the parity test.
+const uint8_t UNHAM_24_18_PAR[3][256] = {
+	{
+		0x00, 0x21, 0x22, 0x03, 0x23, 0x02, 0x01, 0x20, 0x24, 0x05, 0x06, 0x27, 0x07, 0x26, 0x25, 0x04,
+		0x25, 0x04, 0x07, 0x26, 0x06, 0x27, 0x24, 0x05, 0x01, 0x20, 0x23, 0x02, 0x22, 0x03, 0x00, 0x21,
+		0x26, 0x07, 0x04, 0x25, 0x05, 0x24, 0x27, 0x06, 0x02, 0x23, 0x20, 0x01, 0x21, 0x00, 0x03, 0x22,
+		0x03, 0x22, 0x21, 0x00, 0x20, 0x01, 0x02, 0x23, 0x27, 0x06, 0x05, 0x24, 0x04, 0x25, 0x26, 0x07,
+		0x27, 0x06, 0x05, 0x24, 0x04, 0x25, 0x26, 0x07, 0x03, 0x22, 0x21, 0x00, 0x20, 0x01, 0x02, 0x23,
+		0x02, 0x23, 0x20, 0x01, 0x21, 0x00, 0x03, 0x22, 0x26, 0x07, 0x04, 0x25, 0x05, 0x24, 0x27, 0x06,
+		0x01, 0x20, 0x23, 0x02, 0x22, 0x03, 0x00, 0x21, 0x25, 0x04, 0x07, 0x26, 0x06, 0x27, 0x24, 0x05,
+		0x24, 0x05, 0x06, 0x27, 0x07, 0x26, 0x25, 0x04, 0x00, 0x21, 0x22, 0x03, 0x23, 0x02, 0x01, 0x20,
+		0x28, 0x09, 0x0a, 0x2b, 0x0b, 0x2a, 0x29, 0x08, 0x0c, 0x2d, 0x2e, 0x0f, 0x2f, 0x0e, 0x0d, 0x2c,
+		0x0d, 0x2c, 0x2f, 0x0e, 0x2e, 0x0f, 0x0c, 0x2d, 0x29, 0x08, 0x0b, 0x2a, 0x0a, 0x2b, 0x28, 0x09,
+		0x0e, 0x2f, 0x2c, 0x0d, 0x2d, 0x0c, 0x0f, 0x2e, 0x2a, 0x0b, 0x08, 0x29, 0x09, 0x28, 0x2b, 0x0a,
+		0x2b, 0x0a, 0x09, 0x28, 0x08, 0x29, 0x2a, 0x0b, 0x0f, 0x2e, 0x2d, 0x0c, 0x2c, 0x0d, 0x0e, 0x2f,
+		0x0f, 0x2e, 0x2d, 0x0c, 0x2c, 0x0d, 0x0e, 0x2f, 0x2b, 0x0a, 0x09, 0x28, 0x08, 0x29, 0x2a, 0x0b,
+		0x2a, 0x0b, 0x08, 0x29, 0x09, 0x28, 0x2b, 0x0a, 0x0e, 0x2f, 0x2c, 0x0d, 0x2d, 0x0c, 0x0f, 0x2e,
+		0x29, 0x08, 0x0b, 0x2a, 0x0a, 0x2b, 0x28, 0x09, 0x0d, 0x2c, 0x2f, 0x0e, 0x2e, 0x0f, 0x0c, 0x2d,
+		0x0c, 0x2d, 0x2e, 0x0f, 0x2f, 0x0e, 0x0d, 0x2c, 0x28, 0x09, 0x0a, 0x2b, 0x0b, 0x2a, 0x29, 0x08
+	},
+	{
+		0x00, 0x29, 0x2a, 0x03, 0x2b, 0x02, 0x01, 0x28, 0x2c, 0x05, 0x06, 0x2f, 0x07, 0x2e, 0x2d, 0x04,
+		0x2d, 0x04, 0x07, 0x2e, 0x06, 0x2f, 0x2c, 0x05, 0x01, 0x28, 0x2b, 0x02, 0x2a, 0x03, 0x00, 0x29,
+		0x2e, 0x07, 0x04, 0x2d, 0x05, 0x2c, 0x2f, 0x06, 0x02, 0x2b, 0x28, 0x01, 0x29, 0x00, 0x03, 0x2a,
+		0x03, 0x2a, 0x29, 0x00, 0x28, 0x01, 0x02, 0x2b, 0x2f, 0x06, 0x05, 0x2c, 0x04, 0x2d, 0x2e, 0x07,
+		0x2f, 0x06, 0x05, 0x2c, 0x04, 0x2d, 0x2e, 0x07, 0x03, 0x2a, 0x29, 0x00, 0x28, 0x01, 0x02, 0x2b,
+		0x02, 0x2b, 0x28, 0x01, 0x29, 0x00, 0x03, 0x2a, 0x2e, 0x07, 0x04, 0x2d, 0x05, 0x2c, 0x2f, 0x06,
+		0x01, 0x28, 0x2b, 0x02, 0x2a, 0x03, 0x00, 0x29, 0x2d, 0x04, 0x07, 0x2e, 0x06, 0x2f, 0x2c, 0x05,
+		0x2c, 0x05, 0x06, 0x2f, 0x07, 0x2e, 0x2d, 0x04, 0x00, 0x29, 0x2a, 0x03, 0x2b, 0x02, 0x01, 0x28,
+		0x30, 0x19, 0x1a, 0x33, 0x1b, 0x32, 0x31, 0x18, 0x1c, 0x35, 0x36, 0x1f, 0x37, 0x1e, 0x1d, 0x34,
+		0x1d, 0x34, 0x37, 0x1e, 0x36, 0x1f, 0x1c, 0x35, 0x31, 0x18, 0x1b, 0x32, 0x1a, 0x33, 0x30, 0x19,
+		0x1e, 0x37, 0x34, 0x1d, 0x35, 0x1c, 0x1f, 0x36, 0x32, 0x1b, 0x18, 0x31, 0x19, 0x30, 0x33, 0x1a,
+		0x33, 0x1a, 0x19, 0x30, 0x18, 0x31, 0x32, 0x1b, 0x1f, 0x36, 0x35, 0x1c, 0x34, 0x1d, 0x1e, 0x37,
+		0x1f, 0x36, 0x35, 0x1c, 0x34, 0x1d, 0x1e, 0x37, 0x33, 0x1a, 0x19, 0x30, 0x18, 0x31, 0x32, 0x1b,
+		0x32, 0x1b, 0x18, 0x31, 0x19, 0x30, 0x33, 0x1a, 0x1e, 0x37, 0x34, 0x1d, 0x35, 0x1c, 0x1f, 0x36,
+		0x31, 0x18, 0x1b, 0x32, 0x1a, 0x33, 0x30, 0x19, 0x1d, 0x34, 0x37, 0x1e, 0x36, 0x1f, 0x1c, 0x35,
+		0x1c, 0x35, 0x36, 0x1f, 0x37, 0x1e, 0x1d, 0x34, 0x30, 0x19, 0x1a, 0x33, 0x1b, 0x32, 0x31, 0x18
+	},
+	{
+		0x00, 0x31, 0x32, 0x03, 0x33, 0x02, 0x01, 0x30, 0x34, 0x05, 0x06, 0x37, 0x07, 0x36, 0x35, 0x04,
+		0x35, 0x04, 0x07, 0x36, 0x06, 0x37, 0x34, 0x05, 0x01, 0x30, 0x33, 0x02, 0x32, 0x03, 0x00, 0x31,
+		0x36, 0x07, 0x04, 0x35, 0x05, 0x34, 0x37, 0x06, 0x02, 0x33, 0x30, 0x01, 0x31, 0x00, 0x03, 0x32,
+		0x03, 0x32, 0x31, 0x00, 0x30, 0x01, 0x02, 0x33, 0x37, 0x06, 0x05, 0x34, 0x04, 0x35, 0x36, 0x07,
+		0x37, 0x06, 0x05, 0x34, 0x04, 0x35, 0x36, 0x07, 0x03, 0x32, 0x31, 0x00, 0x30, 0x01, 0x02, 0x33,
+		0x02, 0x33, 0x30, 0x01, 0x31, 0x00, 0x03, 0x32, 0x36, 0x07, 0x04, 0x35, 0x05, 0x34, 0x37, 0x06,
+		0x01, 0x30, 0x33, 0x02, 0x32, 0x03, 0x00, 0x31, 0x35, 0x04, 0x07, 0x36, 0x06, 0x37, 0x34, 0x05,
+		0x34, 0x05, 0x06, 0x37, 0x07, 0x36, 0x35, 0x04, 0x00, 0x31, 0x32, 0x03, 0x33, 0x02, 0x01, 0x30,
+		0x20, 0x11, 0x12, 0x23, 0x13, 0x22, 0x21, 0x10, 0x14, 0x25, 0x26, 0x17, 0x27, 0x16, 0x15, 0x24,
+		0x15, 0x24, 0x27, 0x16, 0x26, 0x17, 0x14, 0x25, 0x21, 0x10, 0x13, 0x22, 0x12, 0x23, 0x20, 0x11,
+		0x16, 0x27, 0x24, 0x15, 0x25, 0x14, 0x17, 0x26, 0x22, 0x13, 0x10, 0x21, 0x11, 0x20, 0x23, 0x12,
+		0x23, 0x12, 0x11, 0x20, 0x10, 0x21, 0x22, 0x13, 0x17, 0x26, 0x25, 0x14, 0x24, 0x15, 0x16, 0x27,
+		0x17, 0x26, 0x25, 0x14, 0x24, 0x15, 0x16, 0x27, 0x23, 0x12, 0x11, 0x20, 0x10, 0x21, 0x22, 0x13,
+		0x22, 0x13, 0x10, 0x21, 0x11, 0x20, 0x23, 0x12, 0x16, 0x27, 0x24, 0x15, 0x25, 0x14, 0x17, 0x26,
+		0x21, 0x10, 0x13, 0x22, 0x12, 0x23, 0x20, 0x11, 0x15, 0x24, 0x27, 0x16, 0x26, 0x17, 0x14, 0x25,
+		0x14, 0x25, 0x26, 0x17, 0x27, 0x16, 0x15, 0x24, 0x20, 0x11, 0x12, 0x23, 0x13, 0x22, 0x21, 0x10
+	}
+};
+
+// Bit to flip for each syndrome, 0xffffffff for an uncorrectable (double) error
+const uint32_t UNHAM_24_18_ERR[64] = {
+	0x40000000, 0x20000000, 0x10000000, 0x08000000, 0x04000000, 0x02000000, 0x01000000, 0x00800000,
+	0x00400000, 0x00200000, 0x00100000, 0x00080000, 0x00040000, 0x00020000, 0x00010000, 0x00008000,
+	0x00004000, 0x00002000, 0x00001000, 0x00000800, 0x00000400, 0x00000200, 0x00000100, 0x00000080,
+	0x00000040, 0x00000020, 0x00000010, 0x00000008, 0x00000004, 0x00000002, 0x00000001, 0x00000000,
+	0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+	0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+	0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+	0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0x00000000
+};
+
 #endif
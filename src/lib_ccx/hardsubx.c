@@ -8,6 +8,7 @@
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 #include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
 #include <libswscale/swscale.h>
 
 int hardsubx_process_data(struct lib_hardsubx_ctx *ctx, struct lib_ccx_ctx *ctx_normal)
@@ -59,6 +60,22 @@ int hardsubx_process_data(struct lib_hardsubx_ctx *ctx, struct lib_ccx_ctx *ctx_
 		fatal(EXIT_READ_ERROR, "Input codec is not supported!\n");
 	}
 
+	// The linear and ticker text searches only look at a few sampled frames, so let the
+	// decoder drop the ones it can. The binary search needs every frame.
+	if (!ctx->binary_search)
+	{
+		if (ctx->skip_frames == HARDSUBX_SKIP_NONREF)
+		{
+			ctx->codec_ctx->skip_frame = AVDISCARD_NONREF;
+		}
+		else if (ctx->skip_frames == HARDSUBX_SKIP_NONKEY)
+		{
+			// No decoded frame is used as a reference, so deblocking only costs time
+			ctx->codec_ctx->skip_frame = AVDISCARD_NONKEY;
+			ctx->codec_ctx->skip_loop_filter = AVDISCARD_ALL;
+		}
+	}
+
 	if (avcodec_open2(ctx->codec_ctx, ctx->codec, &ctx->options_dict) < 0)
 	{
 		fatal(EXIT_READ_ERROR, "Error opening input codec!\n");
@@ -71,20 +88,31 @@ int hardsubx_process_data(struct lib_hardsubx_ctx *ctx, struct lib_ccx_ctx *ctx_
 		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory to initialize frame!");
 	}
 
-	int frame_bytes = av_image_get_buffer_size(AV_PIX_FMT_RGB24, ctx->codec_ctx->width, ctx->codec_ctx->height, 16);
+	// Only the bottom of the frame, from roi_y down, is converted and searched for subtitles.
+	// roi_y is kept on a chroma row boundary so the planes can simply be offset.
+	const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(ctx->codec_ctx->pix_fmt);
+	if (!desc)
+	{
+		fatal(EXIT_READ_ERROR, "Unsupported pixel format in video stream!\n");
+	}
+	ctx->roi_y = (int)(ctx->codec_ctx->height * ctx->roi_top / 100);
+	ctx->roi_y &= ~((1 << desc->log2_chroma_h) - 1);
+	ctx->roi_height = ctx->codec_ctx->height - ctx->roi_y;
+
+	int frame_bytes = av_image_get_buffer_size(AV_PIX_FMT_RGB24, ctx->codec_ctx->width, ctx->roi_height, 16);
 	ctx->rgb_buffer = (uint8_t *)av_malloc(frame_bytes * sizeof(uint8_t));
 
 	ctx->sws_ctx = sws_getContext(
 	    ctx->codec_ctx->width,
-	    ctx->codec_ctx->height,
+	    ctx->roi_height,
 	    ctx->codec_ctx->pix_fmt,
 	    ctx->codec_ctx->width,
-	    ctx->codec_ctx->height,
+	    ctx->roi_height,
 	    AV_PIX_FMT_RGB24,
 	    SWS_BILINEAR,
 	    NULL, NULL, NULL);
 
-	av_image_fill_arrays(ctx->rgb_frame->data, ctx->rgb_frame->linesize, ctx->rgb_buffer, AV_PIX_FMT_RGB24, ctx->codec_ctx->width, ctx->codec_ctx->height, 1);
+	av_image_fill_arrays(ctx->rgb_frame->data, ctx->rgb_frame->linesize, ctx->rgb_buffer, AV_PIX_FMT_RGB24, ctx->codec_ctx->width, ctx->roi_height, 1);
 
 	// int frame_bytes = av_image_get_buffer_size(AV_PIX_FMT_RGB24, 1280, 720, 16);
 	// ctx->rgb_buffer = (uint8_t *)av_malloc(frame_bytes*sizeof(uint8_t));
@@ -114,6 +142,8 @@ int hardsubx_process_data(struct lib_hardsubx_ctx *ctx, struct lib_ccx_ctx *ctx_
 	{
 		process_hardsubx_linear_frames_and_normal_subs(ctx, enc_ctx, ctx_normal);
 	}
+	else if (ctx->binary_search)
+		hardsubx_process_frames_binary(ctx, enc_ctx);
 	else
 		hardsubx_process_frames_linear(ctx, enc_ctx);
 
@@ -229,9 +259,6 @@ struct lib_hardsubx_ctx *_init_hardsubx(struct ccx_s_options *options)
 		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory for HardsubX data structures.");
 	memset(ctx, 0, sizeof(struct lib_hardsubx_ctx));
 
-	ctx->tess_handle = TessBaseAPICreate();
-	char *pars_vec = strdup("debug_file");
-	char *pars_values = strdup("/dev/null");
 	char *tessdata_path = NULL;
 
 	char *lang = (char *)options->ocrlang;
@@ -256,28 +283,10 @@ struct lib_hardsubx_ctx *_init_hardsubx(struct ccx_s_options *options)
 		}
 	}
 
-	int ret = -1;
-
-	if (!strncmp("4.", TessVersion(), 2) || !strncmp("5.", TessVersion(), 2))
-	{
-		char tess_path[1024];
-		if (ccx_options.ocr_oem < 0)
-			ccx_options.ocr_oem = 1;
-		snprintf(tess_path, 1024, "%s%s%s", tessdata_path, "/", "tessdata");
-		ret = TessBaseAPIInit4(ctx->tess_handle, tess_path, lang, ccx_options.ocr_oem, NULL, 0, &pars_vec,
-				       &pars_values, 1, false);
-	}
-	else
-	{
-		if (ccx_options.ocr_oem < 0)
-			ccx_options.ocr_oem = 0;
-		ret = TessBaseAPIInit4(ctx->tess_handle, tessdata_path, lang, ccx_options.ocr_oem, NULL, 0, &pars_vec,
-				       &pars_values, 1, false);
-	}
-
-	free(pars_vec);
-	free(pars_values);
-	if (ret != 0)
+	ctx->tessdata_path = tessdata_path;
+	ctx->ocr_lang = lang;
+	ctx->tess_handle = hardsubx_create_tess_handle(ctx);
+	if (!ctx->tess_handle)
 	{
 		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory to initialize Tesseract");
 	}
@@ -304,6 +313,13 @@ struct lib_hardsubx_ctx *_init_hardsubx(struct ccx_s_options *options)
 	ctx->hue = options->hardsubx_hue;
 	ctx->lum_thresh = options->hardsubx_lum_thresh;
 	ctx->hardsubx_and_common = options->hardsubx_and_common;
+	ctx->binary_search = options->hardsubx_binary_search;
+	ctx->threads = options->hardsubx_threads;
+	ctx->skip_frames = options->hardsubx_skip_frames;
+	if (options->hardsubx_roi_top >= 0)
+		ctx->roi_top = options->hardsubx_roi_top;
+	else
+		ctx->roi_top = ctx->tickertext ? 92 : 75; // Ticker text sits lower than subtitles
 
 	// Initialize subtitle structure memory
 	ctx->dec_sub = (struct cc_subtitle *)malloc(sizeof(struct cc_subtitle));
@@ -312,6 +328,42 @@ struct lib_hardsubx_ctx *_init_hardsubx(struct ccx_s_options *options)
 	return ctx;
 }
 
+/**
+ * Create a Tesseract handle for ctx->ocr_lang. Every thread running OCR
+ * needs its own. Returns NULL if it cannot be initialized.
+ */
+TessBaseAPI *hardsubx_create_tess_handle(struct lib_hardsubx_ctx *ctx)
+{
+	TessBaseAPI *handle = TessBaseAPICreate();
+	char *pars_vec = "debug_file";
+	char *pars_values = "/dev/null";
+	int ret = -1;
+
+	if (!strncmp("4.", TessVersion(), 2) || !strncmp("5.", TessVersion(), 2))
+	{
+		char tess_path[1024];
+		if (ccx_options.ocr_oem < 0)
+			ccx_options.ocr_oem = 1;
+		snprintf(tess_path, 1024, "%s%s%s", ctx->tessdata_path, "/", "tessdata");
+		ret = TessBaseAPIInit4(handle, tess_path, ctx->ocr_lang, ccx_options.ocr_oem, NULL, 0, &pars_vec,
+				       &pars_values, 1, false);
+	}
+	else
+	{
+		if (ccx_options.ocr_oem < 0)
+			ccx_options.ocr_oem = 0;
+		ret = TessBaseAPIInit4(handle, ctx->tessdata_path, ctx->ocr_lang, ccx_options.ocr_oem, NULL, 0, &pars_vec,
+				       &pars_values, 1, false);
+	}
+
+	if (ret != 0)
+	{
+		TessBaseAPIDelete(handle);
+		return NULL;
+	}
+	return handle;
+}
+
 void _dinit_hardsubx(struct lib_hardsubx_ctx **ctx)
 {
 	struct lib_hardsubx_ctx *lctx = *ctx;
@@ -321,6 +373,11 @@ void _dinit_hardsubx(struct lib_hardsubx_ctx **ctx)
 	TessBaseAPIEnd(lctx->tess_handle);
 	TessBaseAPIDelete(lctx->tess_handle);
 
+	pixDestroy(&lctx->frame_im);
+	pixDestroy(&lctx->mask_im);
+	pixDestroy(&lctx->feat_im);
+	hardsubx_free_color_lut(lctx);
+
 	// Free subtitle
 	freep(lctx->dec_sub);
 	freep(ctx);
@@ -24,6 +24,29 @@ enum hardsubx_color_type
 	HARDSUBX_COLOR_CUSTOM = 7,
 };
 
+/**
+ * Subtitle colour tests of rgb_to_lab() and rgb_to_hsv(), precomputed for
+ * one lum_thresh and hue. See hardsubx_get_color_lut().
+ */
+struct hardsubx_color_lut
+{
+	// Parameters the tables were built for
+	float lum_thresh;
+	float hue;
+
+	// L > lum_thresh if lum_r[r] + lum_g[g] + lum_b[b] > lum_min
+	float lum_r[256];
+	float lum_g[256];
+	float lum_b[256];
+	float lum_min;
+
+	// Bit (r << 16 | g << 8 | b) set if the hue is within 20 degrees, NULL until needed
+	uint8_t *hue_match;
+};
+
+#define HARDSUBX_LUM_MATCH(lut, r, g, b) ((lut)->lum_r[r] + (lut)->lum_g[g] + (lut)->lum_b[b] > (lut)->lum_min)
+#define HARDSUBX_HUE_MATCH(lut, r, g, b) (((lut)->hue_match[((r) << 13) | ((g) << 5) | ((b) >> 3)] >> ((b) & 7)) & 1)
+
 enum hardsubx_ocr_mode
 {
 	HARDSUBX_OCRMODE_FRAME = 0,
@@ -31,6 +54,13 @@ enum hardsubx_ocr_mode
 	HARDSUBX_OCRMODE_LETTER = 2,
 };
 
+enum hardsubx_skip_frames
+{
+	HARDSUBX_SKIP_NONE = 0,
+	HARDSUBX_SKIP_NONREF = 1, // Frames no other frame is predicted from
+	HARDSUBX_SKIP_NONKEY = 2, // Everything but key frames
+};
+
 struct lib_hardsubx_ctx
 {
 	// The main context for hard subtitle extraction
@@ -63,6 +93,11 @@ struct lib_hardsubx_ctx
 	PIX *im;
 	TessBaseAPI *tess_handle;
 
+	// Images reused from frame to frame by _process_frame_*_basic()
+	PIX *frame_im;
+	PIX *mask_im;
+	PIX *feat_im;
+
 	// Classifier parameters
 	float cur_conf;
 	float prev_conf;
@@ -78,27 +113,47 @@ struct lib_hardsubx_ctx
 	float conf_thresh;
 	float hue;
 	float lum_thresh;
+	int binary_search;
+
+	// Colour lookup tables for lum_thresh and hue, built on first use
+	struct hardsubx_color_lut *color_lut;
+
+	// Region of interest: only rows roi_y to the bottom of the frame are decoded to RGB
+	float roi_top; // Top of the region as a percentage of the frame height
+	int roi_y;
+	int roi_height;
+
+	// OCR threads for the linear and ticker text searches, 0 for one per CPU core
+	int threads;
+	int skip_frames; // enum hardsubx_skip_frames, for the linear and ticker text searches
+	// Where ocr_lang was found, to create one Tesseract handle per thread
+	const char *tessdata_path;
+	const char *ocr_lang;
 };
 
 struct lib_hardsubx_ctx *_init_hardsubx(struct ccx_s_options *options);
 void _hardsubx_params_dump(struct ccx_s_options *options, struct lib_hardsubx_ctx *ctx);
 void hardsubx(struct ccx_s_options *options, struct lib_ccx_ctx *ctx_normal);
 void _dinit_hardsubx(struct lib_hardsubx_ctx **ctx);
+TessBaseAPI *hardsubx_create_tess_handle(struct lib_hardsubx_ctx *ctx);
 int hardsubx_process_data(struct lib_hardsubx_ctx *ctx, struct lib_ccx_ctx *ctx_normal);
 
 // hardsubx_decoder.c
 void hardsubx_process_frames_linear(struct lib_hardsubx_ctx *ctx, struct encoder_ctx *enc_ctx);
 int hardsubx_process_frames_tickertext(struct lib_hardsubx_ctx *ctx, struct encoder_ctx *enc_ctx);
-void hardsubx_process_frames_binary(struct lib_hardsubx_ctx *ctx);
+void hardsubx_process_frames_binary(struct lib_hardsubx_ctx *ctx, struct encoder_ctx *enc_ctx);
 char *_process_frame_white_basic(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int index);
 char *_process_frame_color_basic(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int index);
 void _display_frame(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int timestamp);
-char *_process_frame_tickertext(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int index);
 void process_hardsubx_linear_frames_and_normal_subs(struct lib_hardsubx_ctx *hard_ctx, struct encoder_ctx *enc_ctx, struct lib_ccx_ctx *ctx);
+void hardsubx_convert_roi(struct lib_hardsubx_ctx *ctx);
 
 // hardsubx_imgops.c
 void rgb_to_hsv(float R, float G, float B, float *H, float *S, float *V);
 void rgb_to_lab(float R, float G, float B, float *L, float *a, float *b);
+struct hardsubx_color_lut *hardsubx_get_color_lut(struct lib_hardsubx_ctx *ctx, int need_hue);
+void hardsubx_free_color_lut(struct lib_hardsubx_ctx *ctx);
+void hardsubx_match_color(struct lib_hardsubx_ctx *ctx, const uint8_t *rgb, int count, int step, int by_hue, uint8_t *match);
 
 // hardsubx_classifier.c
 char *get_ocr_text_simple(struct lib_hardsubx_ctx *ctx, PIX *image);
@@ -6,11 +6,55 @@
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 #include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
 #include <libswscale/swscale.h>
 #include <leptonica/allheaders.h>
 #include <tesseract/capi.h>
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
 #include "hardsubx.h"
 
+/**
+ * Convert the subtitle region of ctx->frame, from row roi_y to the bottom,
+ * to RGB24 in ctx->rgb_frame. Nothing outside of it is ever looked at.
+ */
+void hardsubx_convert_roi(struct lib_hardsubx_ctx *ctx)
+{
+	const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(ctx->codec_ctx->pix_fmt);
+	const uint8_t *src[4] = {NULL};
+
+	for (int p = 0; p < 4 && ctx->frame->data[p]; p++)
+	{
+		int y = ctx->roi_y;
+		if (p == 1 && (desc->flags & AV_PIX_FMT_FLAG_PAL))
+			y = 0; // data[1] is the palette
+		else if (p == 1 || p == 2)
+			y >>= desc->log2_chroma_h;
+		src[p] = ctx->frame->data[p] + y * ctx->frame->linesize[p];
+	}
+
+	sws_scale(ctx->sws_ctx, src, ctx->frame->linesize, 0, ctx->roi_height, ctx->rgb_frame->data, ctx->rgb_frame->linesize);
+}
+
+#define HARDSUBX_RGB(r, g, b) (((l_uint32)(r) << L_RED_SHIFT) | ((l_uint32)(g) << L_GREEN_SHIFT) | ((l_uint32)(b) << L_BLUE_SHIFT))
+#define HARDSUBX_WHITE HARDSUBX_RGB(255, 255, 255)
+
+/**
+ * Return *pix, (re)creating it if it does not have the requested size.
+ * Pixels of a reused image keep their values from the previous frame, so
+ * callers must write every pixel they read back later.
+ */
+static PIX *_reuse_pix(PIX **pix, int width, int height)
+{
+	if (*pix && (pixGetWidth(*pix) != width || pixGetHeight(*pix) != height))
+		pixDestroy(pix);
+	if (!*pix)
+		*pix = pixCreate(width, height, 32);
+	return *pix;
+}
+
 #ifdef DISABLE_RUST
 char *_process_frame_white_basic(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int index)
 {
@@ -23,27 +67,27 @@ char *_process_frame_white_basic(struct lib_hardsubx_ctx *ctx, AVFrame *frame, i
 	PIX *lum_im;
 	PIX *feat_im;
 	char *subtitle_text;
+	int wpl, edge_wpl;
+	struct hardsubx_color_lut *lut = hardsubx_get_color_lut(ctx, 0);
 
 	subtitle_text = NULL;
-	im = pixCreate(width, height, 32);
-	lum_im = pixCreate(width, height, 32);
-	feat_im = pixCreate(width, height, 32);
+	im = _reuse_pix(&ctx->frame_im, width, height);
+	lum_im = _reuse_pix(&ctx->mask_im, width, height);
+	feat_im = _reuse_pix(&ctx->feat_im, width, height);
+	wpl = pixGetWpl(im);
 
-	for (int i = (3 * height) / 4; i < height; i++)
+	for (int i = 0; i < height; i++)
 	{
+		const uint8_t *src = frame->data[0] + i * frame->linesize[0];
+		l_uint32 *im_line = pixGetData(im) + i * wpl;
+		l_uint32 *lum_line = pixGetData(lum_im) + i * wpl;
 		for (int j = 0; j < width; j++)
 		{
-			int p = j * 3 + i * frame->linesize[0];
-			int r = frame->data[0][p];
-			int g = frame->data[0][p + 1];
-			int b = frame->data[0][p + 2];
-			pixSetRGBPixel(im, j, i, r, g, b);
-			float L, A, B;
-			rgb_to_lab((float)r, (float)g, (float)b, &L, &A, &B);
-			if (L > ctx->lum_thresh)
-				pixSetRGBPixel(lum_im, j, i, 255, 255, 255);
-			else
-				pixSetRGBPixel(lum_im, j, i, 0, 0, 0);
+			int r = src[3 * j];
+			int g = src[3 * j + 1];
+			int b = src[3 * j + 2];
+			im_line[j] = HARDSUBX_RGB(r, g, b);
+			lum_line[j] = HARDSUBX_LUM_MATCH(lut, r, g, b) ? HARDSUBX_WHITE : 0;
 		}
 	}
 
@@ -52,19 +96,16 @@ char *_process_frame_white_basic(struct lib_hardsubx_ctx *ctx, AVFrame *frame, i
 	sobel_edge_im = pixSobelEdgeFilter(gray_im, L_VERTICAL_EDGES);
 	dilate_gray_im = pixDilateGray(sobel_edge_im, 21, 11);
 	edge_im = pixThresholdToBinary(dilate_gray_im, 50);
+	edge_wpl = pixGetWpl(edge_im);
 
-	for (int i = 3 * (height / 4); i < height; i++)
+	for (int i = 0; i < height; i++)
 	{
+		const l_uint32 *edge_line = pixGetData(edge_im) + i * edge_wpl;
+		const l_uint32 *lum_line = pixGetData(lum_im) + i * wpl;
+		l_uint32 *feat_line = pixGetData(feat_im) + i * wpl;
 		for (int j = 0; j < width; j++)
 		{
-			unsigned int p1, p2, p3;
-			pixGetPixel(edge_im, j, i, &p1);
-			// pixGetPixel(pixd,j,i,&p2);
-			pixGetPixel(lum_im, j, i, &p3);
-			if (p1 == 0 && p3 > 0)
-				pixSetRGBPixel(feat_im, j, i, 255, 255, 255);
-			else
-				pixSetRGBPixel(feat_im, j, i, 0, 0, 0);
+			feat_line[j] = !GET_DATA_BIT(edge_line, j) && lum_line[j] ? HARDSUBX_WHITE : 0;
 		}
 	}
 
@@ -98,13 +139,10 @@ char *_process_frame_white_basic(struct lib_hardsubx_ctx *ctx, AVFrame *frame, i
 			fatal(EXIT_MALFORMED_PARAMETER, "Invalid OCR Mode");
 	}
 
-	pixDestroy(&im);
 	pixDestroy(&gray_im);
 	pixDestroy(&sobel_edge_im);
 	pixDestroy(&dilate_gray_im);
 	pixDestroy(&edge_im);
-	pixDestroy(&lum_im);
-	pixDestroy(&feat_im);
 
 	return subtitle_text;
 }
@@ -122,26 +160,26 @@ char *_process_frame_color_basic(struct lib_hardsubx_ctx *ctx, AVFrame *frame, i
 	PIX *pixd;
 	PIX *feat_im;
 	char *subtitle_text = NULL;
+	int wpl, edge_wpl, pixd_wpl, edge_2_wpl;
+	struct hardsubx_color_lut *lut = hardsubx_get_color_lut(ctx, 1);
 
-	im = pixCreate(width, height, 32);
-	hue_im = pixCreate(width, height, 32);
+	im = _reuse_pix(&ctx->frame_im, width, height);
+	hue_im = _reuse_pix(&ctx->mask_im, width, height);
+	wpl = pixGetWpl(im);
 	subtitle_text = NULL;
 
 	for (int i = 0; i < height; i++)
 	{
+		const uint8_t *src = frame->data[0] + i * frame->linesize[0];
+		l_uint32 *im_line = pixGetData(im) + i * wpl;
+		l_uint32 *hue_line = pixGetData(hue_im) + i * wpl;
 		for (int j = 0; j < width; j++)
 		{
-			int p = j * 3 + i * frame->linesize[0];
-			int r = frame->data[0][p];
-			int g = frame->data[0][p + 1];
-			int b = frame->data[0][p + 2];
-			pixSetRGBPixel(im, j, i, r, g, b);
-			float H, S, V;
-			rgb_to_hsv((float)r, (float)g, (float)b, &H, &S, &V);
-			if (fabsf(H - ctx->hue) < 20)
-			{
-				pixSetRGBPixel(hue_im, j, i, r, g, b);
-			}
+			int r = src[3 * j];
+			int g = src[3 * j + 1];
+			int b = src[3 * j + 2];
+			im_line[j] = HARDSUBX_RGB(r, g, b);
+			hue_line[j] = HARDSUBX_HUE_MATCH(lut, r, g, b) ? im_line[j] : 0;
 		}
 	}
 
@@ -155,20 +193,21 @@ char *_process_frame_color_basic(struct lib_hardsubx_ctx *ctx, AVFrame *frame, i
 
 	pixSauvolaBinarize(gray_im_2, 15, 0.3, 1, NULL, NULL, NULL, &pixd);
 
-	feat_im = pixCreate(width, height, 32);
-	for (int i = 3 * (height / 4); i < height; i++)
+	feat_im = _reuse_pix(&ctx->feat_im, width, height);
+	edge_wpl = pixGetWpl(edge_im);
+	pixd_wpl = pixGetWpl(pixd);
+	edge_2_wpl = pixGetWpl(edge_im_2);
+	for (int i = 0; i < height; i++)
 	{
+		const l_uint32 *edge_line = pixGetData(edge_im) + i * edge_wpl;
+		const l_uint32 *pixd_line = pixGetData(pixd) + i * pixd_wpl;
+		const l_uint32 *edge_2_line = pixGetData(edge_im_2) + i * edge_2_wpl;
+		l_uint32 *feat_line = pixGetData(feat_im) + i * wpl;
 		for (int j = 0; j < width; j++)
 		{
-			unsigned int p1, p2, p3, p4;
-			pixGetPixel(edge_im, j, i, &p1);
-			pixGetPixel(pixd, j, i, &p2);
-			// pixGetPixel(hue_im,j,i,&p3);
-			pixGetPixel(edge_im_2, j, i, &p4);
-			if (p1 == 0 && p2 == 0 && p4 > 0) // if(p4>0&&p1==0)//if(p2==0&&p1==0&&p3>0)
-			{
-				pixSetRGBPixel(feat_im, j, i, 255, 255, 255);
-			}
+			// if(p4>0&&p1==0)//if(p2==0&&p1==0&&p3>0)
+			int is_feat = !GET_DATA_BIT(edge_line, j) && !GET_DATA_BIT(pixd_line, j) && GET_DATA_BYTE(edge_2_line, j);
+			feat_line[j] = is_feat ? HARDSUBX_WHITE : 0;
 		}
 	}
 
@@ -202,8 +241,6 @@ char *_process_frame_color_basic(struct lib_hardsubx_ctx *ctx, AVFrame *frame, i
 			fatal(EXIT_MALFORMED_PARAMETER, "Invalid OCR Mode");
 	}
 
-	pixDestroy(&im);
-	pixDestroy(&hue_im);
 	pixDestroy(&gray_im);
 	pixDestroy(&sobel_edge_im);
 	pixDestroy(&dilate_gray_im);
@@ -211,7 +248,6 @@ char *_process_frame_color_basic(struct lib_hardsubx_ctx *ctx, AVFrame *frame, i
 	pixDestroy(&gray_im_2);
 	pixDestroy(&edge_im_2);
 	pixDestroy(&pixd);
-	pixDestroy(&feat_im);
 
 	return subtitle_text;
 }
@@ -263,7 +299,7 @@ void _display_frame(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int
 	pixSauvolaBinarize(gray_im_2, 15, 0.3, 1, NULL, NULL, NULL, &pixd);
 
 	feat_im = pixCreate(width, height, 32);
-	for (int i = 3 * (height / 4); i < height; i++)
+	for (int i = 0; i < height; i++)
 	{
 		for (int j = 0; j < width; j++)
 		{
@@ -296,88 +332,522 @@ void _display_frame(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int
 	pixDestroy(&feat_im);
 }
 
-#ifdef DISABLE_RUST
-char *_process_frame_tickertext(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int index)
+#define HARDSUBX_TICKER_BATCH 8 // Ticker text samples OCRed together
+#define HARDSUBX_TICKER_GAP 16  // Blank rows between them, so no text line spans two
+
+static void _append_ticker_line(char **text, size_t *len, const char *line)
 {
-	PIX *im;
-	PIX *gray_im;
-	PIX *sobel_edge_im;
-	PIX *dilate_gray_im;
-	PIX *edge_im;
+	size_t n = strlen(line);
+	char *tmp = (char *)realloc(*text, *len + n + 1);
+	if (!tmp)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory to process ticker text");
+	memcpy(tmp + *len, line, n + 1);
+	*text = tmp;
+	*len += n;
+}
+
+/**
+ * OCR the ticker strips stacked in frame, each roi_height rows high and
+ * HARDSUBX_TICKER_GAP rows apart, with a single Tesseract call, so its page
+ * layout analysis runs once per batch instead of once per sample. The text is
+ * read per line, word or letter as ocr_mode says, dropping those below
+ * conf_thresh, and each piece goes to the strip its bounding box is centred
+ * in. Returns the text of every strip, top to bottom, separated by form feeds.
+ */
+static char *_process_frames_tickertext(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int index)
+{
+	int pitch = ctx->roi_height + HARDSUBX_TICKER_GAP;
+	int nb_strips = MIN(height / pitch, HARDSUBX_TICKER_BATCH);
+	char *strip_text[HARDSUBX_TICKER_BATCH] = {NULL};
+	size_t strip_len[HARDSUBX_TICKER_BATCH] = {0};
+	char *text = NULL;
+	size_t len = 0;
+	TessPageIteratorLevel level;
+	const char *separator;
+	uint8_t *match;
 	PIX *lum_im;
-	PIX *feat_im;
-	char *subtitle_text;
+	int wpl;
 
-	subtitle_text = NULL;
-	im = pixCreate(width, height, 32);
-	lum_im = pixCreate(width, height, 32);
-	feat_im = pixCreate(width, height, 32);
+	switch (ctx->ocr_mode)
+	{
+		case HARDSUBX_OCRMODE_WORD:
+			level = RIL_WORD;
+			separator = " ";
+			break;
+		case HARDSUBX_OCRMODE_LETTER:
+			level = RIL_SYMBOL;
+			separator = "";
+			break;
+		case HARDSUBX_OCRMODE_FRAME:
+			level = RIL_TEXTLINE;
+			separator = "";
+			break;
+		default:
+			fatal(EXIT_MALFORMED_PARAMETER, "Invalid OCR Mode");
+	}
 
-	for (int i = (92 * height) / 100; i < height; i++)
+	match = (uint8_t *)malloc(width);
+	if (!match)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory to process ticker text");
+	lum_im = _reuse_pix(&ctx->mask_im, width, height);
+	wpl = pixGetWpl(lum_im);
+	for (int i = 0; i < height; i++)
 	{
+		l_uint32 *lum_line = pixGetData(lum_im) + i * wpl;
+		hardsubx_match_color(ctx, frame->data[0] + i * frame->linesize[0], width, 1, 0, match);
 		for (int j = 0; j < width; j++)
+			lum_line[j] = match[j] ? HARDSUBX_WHITE : 0;
+	}
+	free(match);
+
+	TessBaseAPISetImage2(ctx->tess_handle, lum_im);
+	if (TessBaseAPIRecognize(ctx->tess_handle, NULL) != 0)
+	{
+		mprint("Error in Tesseract recognition, skipping frames\n");
+	}
+	else
+	{
+		TessResultIterator *it = TessBaseAPIGetIterator(ctx->tess_handle);
+		if (it != 0)
 		{
-			int p = j * 3 + i * frame->linesize[0];
-			int r = frame->data[0][p];
-			int g = frame->data[0][p + 1];
-			int b = frame->data[0][p + 2];
-			pixSetRGBPixel(im, j, i, r, g, b);
-			float L, A, B;
-			rgb_to_lab((float)r, (float)g, (float)b, &L, &A, &B);
-			if (L > ctx->lum_thresh)
-				pixSetRGBPixel(lum_im, j, i, 255, 255, 255);
-			else
-				pixSetRGBPixel(lum_im, j, i, 0, 0, 0);
+			do
+			{
+				int left, top, right, bottom;
+				char *piece = TessResultIteratorGetUTF8Text(it, level);
+				if (piece == NULL)
+					continue;
+				if (strlen(piece) > 0 && (ctx->conf_thresh <= 0 || TessResultIteratorConfidence(it, level) >= ctx->conf_thresh) &&
+				    TessPageIteratorBoundingBox((TessPageIterator *)it, level, &left, &top, &right, &bottom))
+				{
+					int strip = MIN((top + bottom) / 2 / pitch, nb_strips - 1);
+					_append_ticker_line(&strip_text[strip], &strip_len[strip], piece);
+					_append_ticker_line(&strip_text[strip], &strip_len[strip], separator);
+				}
+				TessDeleteText(piece);
+			} while (TessPageIteratorNext((TessPageIterator *)it, level));
+			TessResultIteratorDelete(it);
 		}
 	}
 
-	// Handle the edge image
-	gray_im = pixConvertRGBToGray(im, 0.0, 0.0, 0.0);
-	sobel_edge_im = pixSobelEdgeFilter(gray_im, L_VERTICAL_EDGES);
-	dilate_gray_im = pixDilateGray(sobel_edge_im, 21, 11);
-	edge_im = pixThresholdToBinary(dilate_gray_im, 50);
+	for (int i = 0; i < nb_strips; i++)
+	{
+		if (i > 0)
+			_append_ticker_line(&text, &len, "\f");
+		_append_ticker_line(&text, &len, strip_text[i] ? strip_text[i] : "");
+		free(strip_text[i]);
+	}
+
+	return text;
+}
 
-	for (int i = 92 * (height / 100); i < height; i++)
+#define HARDSUBX_GRID_COLS 64
+#define HARDSUBX_GRID_ROWS 16
+#define HARDSUBX_GRID_CELLS (HARDSUBX_GRID_COLS * HARDSUBX_GRID_ROWS)
+#define HARDSUBX_MIN_SUB_PIXELS 64 // Fewer subtitle coloured pixels than this means no subtitle
+
+/**
+ * Cheap description of the subtitle area of a frame, used to tell frames
+ * apart without OCR: the number of subtitle coloured pixels in each cell of
+ * a grid laid over the region of interest.
+ */
+struct hardsubx_frame_features
+{
+	int total;
+	uint16_t cells[HARDSUBX_GRID_CELLS];
+};
+
+// Compute the features of the frame in ctx->rgb_frame
+static void _compute_frame_features(struct lib_hardsubx_ctx *ctx, struct hardsubx_frame_features *features)
+{
+	int width = ctx->codec_ctx->width;
+	int height = ctx->roi_height;
+	int count = (width + 1) / 2;
+	int by_hue = ctx->subcolor != HARDSUBX_COLOR_WHITE;
+	uint8_t *match = (uint8_t *)malloc(count);
+
+	if (!match)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory to compare frames");
+	memset(features, 0, sizeof(*features));
+
+	// Every other pixel of every other row is plenty to tell subtitles apart
+	for (int i = 0; i < height; i += 2)
 	{
-		for (int j = 0; j < width; j++)
+		uint16_t *cells = features->cells + (i * HARDSUBX_GRID_ROWS / height) * HARDSUBX_GRID_COLS;
+
+		// Same colour test as the frame processing function the sample would be OCRed with
+		hardsubx_match_color(ctx, ctx->rgb_frame->data[0] + i * ctx->rgb_frame->linesize[0], count, 2, by_hue, match);
+		for (int k = 0; k < count; k++)
 		{
-			unsigned int p1, p2, p3;
-			pixGetPixel(edge_im, j, i, &p1);
-			// pixGetPixel(pixd,j,i,&p2);
-			pixGetPixel(lum_im, j, i, &p3);
-			if (p1 == 0 && p3 > 0)
-				pixSetRGBPixel(feat_im, j, i, 255, 255, 255);
-			else
-				pixSetRGBPixel(feat_im, j, i, 0, 0, 0);
+			if (match[k])
+			{
+				cells[2 * k * HARDSUBX_GRID_COLS / width]++;
+				features->total++;
+			}
 		}
 	}
+	free(match);
+}
 
-	// Tesseract OCR for the ticker text here
-	subtitle_text = get_ocr_text_simple(ctx, lum_im);
-	char write_path[100];
-	sprintf(write_path, "./lum_im%04d.jpg", index);
-	pixWrite(write_path, lum_im, IFF_JFIF_JPEG);
-	sprintf(write_path, "./im%04d.jpg", index);
-	pixWrite(write_path, im, IFF_JFIF_JPEG);
+static int _frame_features_distance(const struct hardsubx_frame_features *a, const struct hardsubx_frame_features *b)
+{
+	int dist = 0;
+	for (int i = 0; i < HARDSUBX_GRID_CELLS; i++)
+		dist += abs(a->cells[i] - b->cells[i]);
+	return dist;
+}
 
-	pixDestroy(&im);
-	pixDestroy(&gray_im);
-	pixDestroy(&sobel_edge_im);
-	pixDestroy(&dilate_gray_im);
-	pixDestroy(&edge_im);
-	pixDestroy(&lum_im);
-	pixDestroy(&feat_im);
+// Two frames show a different subtitle if more than a quarter of their subtitle pixels moved
+static int _frame_features_differ(const struct hardsubx_frame_features *a, const struct hardsubx_frame_features *b)
+{
+	int total = a->total > b->total ? a->total : b->total;
+	if (total < HARDSUBX_MIN_SUB_PIXELS)
+		return 0;
+	return 4 * _frame_features_distance(a, b) > total;
+}
 
-	return subtitle_text;
+/**
+ * OCR jobs of the linear and ticker text searches. With more than one
+ * thread, workers with their own copy of the context, Tesseract handle and
+ * images run them while decoding carries on. Results are handed back in the
+ * order the samples were submitted, so subtitles are merged exactly as when
+ * running on a single thread.
+ */
+typedef char *(*hardsubx_ocr_fn)(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int index);
+
+struct hardsubx_job
+{
+	AVFrame *rgb_frame; // Copy of the region of interest, only used by workers
+	int frame_numbers[HARDSUBX_TICKER_BATCH]; // Of the samples stacked in the frame, top to bottom
+	int nb_frames;
+	int64_t pts; // Of the packet the sample was decoded from
+	int ocr;     // 0 if the sample reuses the text of the last OCRed one
+	int done;
+	char *text; // OCR result, freed when the job is released
+	struct hardsubx_job *next;
+};
+
+struct hardsubx_pool;
+
+struct hardsubx_worker
+{
+	struct hardsubx_pool *pool;
+	struct lib_hardsubx_ctx ctx;
+#ifndef _WIN32
+	pthread_t thread;
+#endif
+};
+
+struct hardsubx_pool
+{
+	struct lib_hardsubx_ctx *ctx;
+	hardsubx_ocr_fn ocr;
+	int width;
+	int height;
+	int nb_workers;
+	struct hardsubx_worker *workers;
+	struct hardsubx_job **order; // Submitted jobs, oldest first, in a ring of size capacity
+	int capacity;
+	int first;
+	int count;
+	struct hardsubx_job *free_jobs;
+#ifndef _WIN32
+	pthread_mutex_t lock;
+	pthread_cond_t job_ready;
+	pthread_cond_t job_done;
+	struct hardsubx_job *head; // Waiting for a worker
+	struct hardsubx_job *tail;
+	int quit;
+#endif
+};
+
+#ifndef _WIN32
+static void *_hardsubx_worker_main(void *arg)
+{
+	struct hardsubx_worker *worker = arg;
+	struct hardsubx_pool *pool = worker->pool;
+	struct hardsubx_job *job;
+
+	pthread_mutex_lock(&pool->lock);
+	for (;;)
+	{
+		while (!pool->head && !pool->quit)
+			pthread_cond_wait(&pool->job_ready, &pool->lock);
+		if (!pool->head)
+			break;
+
+		job = pool->head;
+		pool->head = job->next;
+		if (!pool->head)
+			pool->tail = NULL;
+		pthread_mutex_unlock(&pool->lock);
+
+		job->text = pool->ocr(&worker->ctx, job->rgb_frame, pool->width, pool->height, job->frame_numbers[0]);
+
+		pthread_mutex_lock(&pool->lock);
+		job->done = 1;
+		pthread_cond_broadcast(&pool->job_done);
+	}
+	pthread_mutex_unlock(&pool->lock);
+	return NULL;
+}
+
+static void _start_hardsubx_workers(struct hardsubx_pool *pool, int nb_threads, int need_hue)
+{
+	pool->workers = (struct hardsubx_worker *)calloc(nb_threads, sizeof(struct hardsubx_worker));
+	if (!pool->workers)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory for OCR threads");
+
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->job_ready, NULL);
+	pthread_cond_init(&pool->job_done, NULL);
+
+	// The colour tables are built once and only read by the workers, pool->ctx keeps owning them
+	hardsubx_get_color_lut(pool->ctx, need_hue);
+
+	for (int i = 0; i < nb_threads; i++)
+	{
+		struct hardsubx_worker *worker = &pool->workers[i];
+		worker->pool = pool;
+		worker->ctx = *pool->ctx;
+		worker->ctx.frame_im = NULL;
+		worker->ctx.mask_im = NULL;
+		worker->ctx.feat_im = NULL;
+		worker->ctx.color_lut = pool->ctx->color_lut;
+		worker->ctx.tess_handle = hardsubx_create_tess_handle(pool->ctx);
+		if (!worker->ctx.tess_handle)
+		{
+			mprint("Failed to initialize Tesseract for OCR thread %d\n", i);
+			break;
+		}
+		if (pthread_create(&worker->thread, NULL, _hardsubx_worker_main, worker))
+		{
+			mprint("Failed to start OCR thread %d\n", i);
+			TessBaseAPIEnd(worker->ctx.tess_handle);
+			TessBaseAPIDelete(worker->ctx.tess_handle);
+			break;
+		}
+		pool->nb_workers++;
+	}
+	if (pool->nb_workers > 0)
+		mprint("Running burned-in subtitle OCR on %d threads\n", pool->nb_workers);
 }
 #endif
 
+static struct hardsubx_pool *_init_hardsubx_pool(struct lib_hardsubx_ctx *ctx, hardsubx_ocr_fn ocr, int height, int need_hue)
+{
+	struct hardsubx_pool *pool;
+	int nb_threads = ctx->threads;
+
+	pool = (struct hardsubx_pool *)calloc(1, sizeof(struct hardsubx_pool));
+	if (!pool)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory for OCR threads");
+	pool->ctx = ctx;
+	pool->ocr = ocr;
+	pool->width = ctx->codec_ctx->width;
+	pool->height = height;
+
+#ifndef _WIN32
+	if (nb_threads == 0)
+		nb_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (nb_threads > 1)
+		_start_hardsubx_workers(pool, nb_threads, need_hue);
+#endif
+
+	// Enough jobs in flight to keep every worker busy while the oldest one is waited for
+	pool->capacity = pool->nb_workers ? 2 * pool->nb_workers : 1;
+	pool->order = (struct hardsubx_job **)calloc(pool->capacity, sizeof(struct hardsubx_job *));
+	if (!pool->order)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory for OCR threads");
+	return pool;
+}
+
+static void _dinit_hardsubx_pool(struct hardsubx_pool **arg)
+{
+	struct hardsubx_pool *pool = *arg;
+	struct hardsubx_job *job;
+
+#ifndef _WIN32
+	if (pool->workers)
+	{
+		pthread_mutex_lock(&pool->lock);
+		pool->quit = 1;
+		pthread_cond_broadcast(&pool->job_ready);
+		pthread_mutex_unlock(&pool->lock);
+		for (int i = 0; i < pool->nb_workers; i++)
+		{
+			struct lib_hardsubx_ctx *wctx = &pool->workers[i].ctx;
+			pthread_join(pool->workers[i].thread, NULL);
+			TessBaseAPIEnd(wctx->tess_handle);
+			TessBaseAPIDelete(wctx->tess_handle);
+			pixDestroy(&wctx->frame_im);
+			pixDestroy(&wctx->mask_im);
+			pixDestroy(&wctx->feat_im);
+		}
+		pthread_mutex_destroy(&pool->lock);
+		pthread_cond_destroy(&pool->job_ready);
+		pthread_cond_destroy(&pool->job_done);
+	}
+#endif
+	while ((job = pool->free_jobs))
+	{
+		pool->free_jobs = job->next;
+		av_frame_free(&job->rgb_frame);
+		free(job);
+	}
+	freep(&pool->workers);
+	freep(&pool->order);
+	freep(arg);
+}
+
+/**
+ * Queue a sample of frame, the size of the pool's images, holding the given
+ * frames. If ocr is set it is OCRed, on a worker if there are any, else it
+ * will reuse the text of the last OCRed sample. After each one, take results
+ * with _next_hardsubx_result() until it returns NULL, so there is room for
+ * the next.
+ */
+static void _submit_hardsubx_job(struct hardsubx_pool *pool, AVFrame *frame, int ocr, const int *frame_numbers, int nb_frames, int64_t pts)
+{
+	struct lib_hardsubx_ctx *ctx = pool->ctx;
+	struct hardsubx_job *job = pool->free_jobs;
+
+	if (job)
+	{
+		pool->free_jobs = job->next;
+	}
+	else
+	{
+		job = (struct hardsubx_job *)calloc(1, sizeof(struct hardsubx_job));
+		if (!job)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory for OCR jobs");
+	}
+	memcpy(job->frame_numbers, frame_numbers, nb_frames * sizeof(int));
+	job->nb_frames = nb_frames;
+	job->pts = pts;
+	job->ocr = ocr;
+	job->done = 0;
+	job->text = NULL;
+	job->next = NULL;
+
+	if (!ocr || pool->nb_workers == 0)
+	{
+		if (ocr)
+			job->text = pool->ocr(ctx, frame, pool->width, pool->height, frame_numbers[0]);
+		job->done = 1;
+	}
+#ifndef _WIN32
+	else
+	{
+		if (!job->rgb_frame)
+		{
+			job->rgb_frame = av_frame_alloc();
+			if (!job->rgb_frame)
+				fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory for OCR jobs");
+			job->rgb_frame->format = AV_PIX_FMT_RGB24;
+			job->rgb_frame->width = pool->width;
+			job->rgb_frame->height = pool->height;
+			if (av_frame_get_buffer(job->rgb_frame, 0) < 0)
+				fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory for OCR jobs");
+		}
+		av_image_copy(job->rgb_frame->data, job->rgb_frame->linesize, (const uint8_t **)frame->data,
+			      frame->linesize, AV_PIX_FMT_RGB24, pool->width, pool->height);
+
+		pthread_mutex_lock(&pool->lock);
+		if (pool->tail)
+			pool->tail->next = job;
+		else
+			pool->head = job;
+		pool->tail = job;
+		pthread_cond_signal(&pool->job_ready);
+		pthread_mutex_unlock(&pool->lock);
+	}
+#endif
+
+	pool->order[(pool->first + pool->count) % pool->capacity] = job;
+	pool->count++;
+}
+
+/**
+ * Take the oldest submitted job if it is done. Waits for it if wait is set,
+ * or if no other job could be submitted. Returns NULL if there is none.
+ * Give the job back with _release_hardsubx_job().
+ */
+static struct hardsubx_job *_next_hardsubx_result(struct hardsubx_pool *pool, int wait)
+{
+	struct hardsubx_job *job;
+
+	if (!pool->count)
+		return NULL;
+	job = pool->order[pool->first];
+
+#ifndef _WIN32
+	if (pool->nb_workers > 0)
+	{
+		int done;
+		pthread_mutex_lock(&pool->lock);
+		if (wait || pool->count == pool->capacity)
+		{
+			while (!job->done)
+				pthread_cond_wait(&pool->job_done, &pool->lock);
+		}
+		done = job->done;
+		pthread_mutex_unlock(&pool->lock);
+		if (!done)
+			return NULL;
+	}
+#endif
+
+	pool->first = (pool->first + 1) % pool->capacity;
+	pool->count--;
+	return job;
+}
+
+static void _release_hardsubx_job(struct hardsubx_pool *pool, struct hardsubx_job *job)
+{
+	freep(&job->text);
+	job->next = pool->free_jobs;
+	pool->free_jobs = job;
+}
+
+static void _print_ticker_text(struct hardsubx_job *job)
+{
+	const char *text = job->text;
+
+	for (int i = 0; i < job->nb_frames; i++)
+	{
+		const char *end = text ? strchr(text, '\f') : NULL;
+		int len = text ? (end ? (int)(end - text) : (int)strlen(text)) : 0;
+
+		printf("frame_number: %d\n", job->frame_numbers[i]);
+		if (len > 0)
+			printf("%.*s\n", len, text);
+		text = end ? end + 1 : NULL;
+	}
+}
+
 int hardsubx_process_frames_tickertext(struct lib_hardsubx_ctx *ctx, struct encoder_ctx *enc_ctx)
 {
 	// Search for ticker text at the bottom of the screen, such as in Russia TV1 or stock prices
 	int cur_sec = 0, total_sec, progress;
 	int frame_number = 0;
-	char *ticker_text = NULL;
+	int next_sample = 1000; // With skipped frames, sample the first decoded frame at or after this
+	int pitch = ctx->roi_height + HARDSUBX_TICKER_GAP;
+	int batch_frames[HARDSUBX_TICKER_BATCH];
+	int nb_batch = 0;
+	int64_t batch_pts = 0;
+	AVFrame *batch;
+	struct hardsubx_pool *pool = _init_hardsubx_pool(ctx, _process_frames_tickertext, HARDSUBX_TICKER_BATCH * pitch, 0);
+	struct hardsubx_job *job;
+
+	// Samples are stacked in batch, pitch rows apart, and OCRed together
+	batch = av_frame_alloc();
+	if (!batch)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory to process ticker text");
+	batch->format = AV_PIX_FMT_RGB24;
+	batch->width = ctx->codec_ctx->width;
+	batch->height = HARDSUBX_TICKER_BATCH * pitch;
+	if (av_frame_get_buffer(batch, 0) < 0)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory to process ticker text");
 
 	while (av_read_frame(ctx->format_ctx, &ctx->packet) >= 0)
 	{
@@ -386,23 +856,22 @@ int hardsubx_process_frames_tickertext(struct lib_hardsubx_ctx *ctx, struct enco
 			frame_number++;
 			// Decode the video stream packet
 			avcodec_send_packet(ctx->codec_ctx, &ctx->packet);
-			if (avcodec_receive_frame(ctx->codec_ctx, ctx->frame) == 0 && frame_number % 1000 == 0)
+			if (avcodec_receive_frame(ctx->codec_ctx, ctx->frame) == 0 && frame_number >= next_sample)
 			{
-				// sws_scale is used to convert the pixel format to RGB24 from all other cases
-				sws_scale(
-				    ctx->sws_ctx,
-				    (uint8_t const *const *)ctx->frame->data,
-				    ctx->frame->linesize,
-				    0,
-				    ctx->codec_ctx->height,
-				    ctx->rgb_frame->data,
-				    ctx->rgb_frame->linesize);
-
-				ticker_text = _process_frame_tickertext(ctx, ctx->rgb_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, frame_number);
-				printf("frame_number: %d\n", frame_number);
-
-				if (strlen(ticker_text) > 0)
-					printf("%s\n", ticker_text);
+				next_sample = frame_number - frame_number % 1000 + 1000;
+				hardsubx_convert_roi(ctx);
+
+				if (nb_batch == 0)
+					memset(batch->data[0], 0, (size_t)batch->linesize[0] * batch->height);
+				av_image_copy_plane(batch->data[0] + (size_t)nb_batch * pitch * batch->linesize[0], batch->linesize[0],
+						    ctx->rgb_frame->data[0], ctx->rgb_frame->linesize[0], ctx->codec_ctx->width * 3, ctx->roi_height);
+				batch_frames[nb_batch++] = frame_number;
+				batch_pts = ctx->packet.pts;
+				if (nb_batch == HARDSUBX_TICKER_BATCH)
+				{
+					_submit_hardsubx_job(pool, batch, 1, batch_frames, nb_batch, batch_pts);
+					nb_batch = 0;
+				}
 
 				cur_sec = (int)convert_pts_to_s(ctx->packet.pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
 				total_sec = (int)convert_pts_to_s(ctx->format_ctx->duration, AV_TIME_BASE_Q);
@@ -411,23 +880,248 @@ int hardsubx_process_frames_tickertext(struct lib_hardsubx_ctx *ctx, struct enco
 			}
 		}
 		av_packet_unref(&ctx->packet);
+
+		while ((job = _next_hardsubx_result(pool, 0)))
+		{
+			_print_ticker_text(job);
+			_release_hardsubx_job(pool, job);
+		}
 	}
+	if (nb_batch > 0)
+		_submit_hardsubx_job(pool, batch, 1, batch_frames, nb_batch, batch_pts);
+	while ((job = _next_hardsubx_result(pool, 1)))
+	{
+		_print_ticker_text(job);
+		_release_hardsubx_job(pool, job);
+	}
+	_dinit_hardsubx_pool(&pool);
+	av_frame_free(&batch);
+
 	activity_progress(100, cur_sec / 60, cur_sec % 60);
 	return 0;
 }
 
-void hardsubx_process_frames_linear(struct lib_hardsubx_ctx *ctx, struct encoder_ctx *enc_ctx)
+/**
+ * Whether two OCR results are the same subtitle line, that is, their edit
+ * distance is under 20% of the length of the shorter one. The distance is
+ * only computed up to that bound.
+ */
+static int _is_same_subtitle_text(const char *text, const char *prev_text)
 {
-	// Do an exhaustive linear search over the video
+	size_t len = strlen(text);
+	size_t prev_len = strlen(prev_text);
+	double max_dist = 0.2 * MIN(len, prev_len);
+
+	return levenshtein_dist_char_bounded(text, prev_text, len, prev_len, (unsigned)max_dist) < max_dist;
+}
 
-	int prev_sub_encoded = 1; // Previous seen subtitle encoded or not
+/**
+ * Burned-in subtitles found by a linear search running on its own thread,
+ * alongside the normal caption extraction. They are encoded by the thread
+ * running the caption extraction, see _encode_burned_in_subs().
+ */
+struct hardsubx_sub
+{
+	char *text;
+	int64_t begin_time;
+	int64_t end_time;
+	struct hardsubx_sub *next;
+};
+
+struct hardsubx_sub_queue
+{
+	struct lib_hardsubx_ctx *ctx;
+	struct hardsubx_sub *head;
+	struct hardsubx_sub *tail;
+	int64_t progress; // No subtitle queued from now on begins before this
+	int done;	  // Nothing more will be queued
+#ifndef _WIN32
+	pthread_mutex_t lock;
+	pthread_cond_t progressed;
+	pthread_t thread;
+#endif
+};
+
+static void _queue_burned_in_sub(struct hardsubx_sub_queue *queue, char *text, int64_t begin_time, int64_t end_time)
+{
+	struct hardsubx_sub *sub = (struct hardsubx_sub *)malloc(sizeof(struct hardsubx_sub));
+	if (!sub)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory for burned-in subtitles");
+	sub->text = text;
+	sub->begin_time = begin_time;
+	sub->end_time = end_time;
+	sub->next = NULL;
+
+#ifndef _WIN32
+	pthread_mutex_lock(&queue->lock);
+#endif
+	if (queue->tail)
+		queue->tail->next = sub;
+	else
+		queue->head = sub;
+	queue->tail = sub;
+#ifndef _WIN32
+	pthread_mutex_unlock(&queue->lock);
+#endif
+}
+
+static void _set_burned_in_progress(struct hardsubx_sub_queue *queue, int64_t progress, int done)
+{
+#ifndef _WIN32
+	pthread_mutex_lock(&queue->lock);
+#endif
+	queue->progress = progress;
+	queue->done = done;
+#ifndef _WIN32
+	pthread_cond_broadcast(&queue->progressed);
+	pthread_mutex_unlock(&queue->lock);
+#endif
+}
+
+// Subtitle being built by the linear search
+struct hardsubx_linear_state
+{
+	int prev_sub_encoded;			// Previous seen subtitle encoded or not
+	int64_t prev_begin_time, prev_end_time;	// Begin and end time of previous seen subtitle
+	char *prev_subtitle_text;		// Previously seen subtitle text
+	char *ocr_text;				// Text of the last OCRed sample
+	struct hardsubx_sub_queue *queue;	// Subtitles go there instead of the encoder if set
+};
+
+static void _emit_linear_subtitle(struct lib_hardsubx_ctx *ctx, struct encoder_ctx *enc_ctx, struct hardsubx_linear_state *state)
+{
+	if (state->queue)
+	{
+		_queue_burned_in_sub(state->queue, state->prev_subtitle_text, state->prev_begin_time, state->prev_end_time);
+		return;
+	}
+	add_cc_sub_text(ctx->dec_sub, state->prev_subtitle_text, state->prev_begin_time, state->prev_end_time, "", "BURN", CCX_ENC_UTF_8);
+	encode_sub(enc_ctx, ctx->dec_sub);
+}
+
+// OCR a sample of the linear search
+static char *_ocr_linear_sample(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int index)
+{
+	char *subtitle_text;
+
+	// Send the frame to other functions for processing
+	if (ctx->subcolor == HARDSUBX_COLOR_WHITE)
+	{
+		subtitle_text = _process_frame_white_basic(ctx, frame, width, height, index);
+	}
+	else
+	{
+		subtitle_text = _process_frame_color_basic(ctx, frame, width, height, index);
+	}
+	return subtitle_text;
+}
+
+// Merge the text of a sample into the subtitles, in the order of the samples
+static void _merge_linear_sample(struct lib_hardsubx_ctx *ctx, struct encoder_ctx *enc_ctx, struct hardsubx_linear_state *state, struct hardsubx_job *job)
+{
+	AVRational time_base = ctx->format_ctx->streams[ctx->video_stream_id]->time_base;
+	char *sample_text;   // Copy of the text of current sample, freed on return
+	char *subtitle_text; // Subtitle text of current sample
 	int dist = 0;
+
+	if (job->ocr)
+	{
+		freep(&state->ocr_text);
+		if (job->text)
+			state->ocr_text = strdup(job->text);
+	}
+	// Otherwise the subtitle area is unchanged since the last OCR, so is its text
+	sample_text = state->ocr_text ? strdup(state->ocr_text) : NULL;
+	subtitle_text = sample_text;
+
+	if ((!subtitle_text && !state->prev_subtitle_text) || (subtitle_text && !strlen(subtitle_text) && !state->prev_subtitle_text))
+	{
+		state->prev_end_time = convert_pts_to_ms(job->pts, time_base);
+	}
+
+	if (subtitle_text)
+	{
+		char *double_enter = strstr(subtitle_text, "\n\n");
+		if (double_enter != NULL)
+			*(double_enter) = '\0';
+	}
+
+	if (!state->prev_sub_encoded && state->prev_subtitle_text)
+	{
+		if (subtitle_text)
+		{
+			if (_is_same_subtitle_text(subtitle_text, state->prev_subtitle_text))
+			{
+				dist = -1;
+				subtitle_text = NULL;
+				state->prev_end_time = convert_pts_to_ms(job->pts, time_base);
+			}
+		}
+		if (dist != -1)
+		{
+			_emit_linear_subtitle(ctx, enc_ctx, state);
+			state->prev_begin_time = state->prev_end_time + 1;
+			state->prev_subtitle_text = NULL;
+			state->prev_sub_encoded = 1;
+			state->prev_end_time = convert_pts_to_ms(job->pts, time_base);
+			if (subtitle_text)
+			{
+				state->prev_subtitle_text = strdup(subtitle_text);
+				state->prev_sub_encoded = 0;
+			}
+		}
+	}
+
+	// if(ctx->conf_thresh > 0)
+	// {
+	// 	if(ctx->cur_conf >= ctx->prev_conf)
+	// 	{
+	// 		prev_subtitle_text = strdup(subtitle_text);
+	// 		ctx->prev_conf = ctx->cur_conf;
+	// 	}
+	// }
+	// else
+	// {
+	// 	prev_subtitle_text = strdup(subtitle_text);
+	// }
+
+	if (!state->prev_subtitle_text && subtitle_text)
+	{
+		state->prev_begin_time = state->prev_end_time + 1;
+		state->prev_end_time = convert_pts_to_ms(job->pts, time_base);
+		state->prev_subtitle_text = strdup(subtitle_text);
+		state->prev_sub_encoded = 0;
+	}
+
+	if (state->queue)
+	{
+		// The pending subtitle keeps its begin time, a new one begins after prev_end_time
+		if (!state->prev_sub_encoded && state->prev_subtitle_text)
+			_set_burned_in_progress(state->queue, state->prev_begin_time, 0);
+		else
+			_set_burned_in_progress(state->queue, state->prev_end_time + 1, 0);
+	}
+	free(sample_text);
+}
+
+static void _process_frames_linear(struct lib_hardsubx_ctx *ctx, struct encoder_ctx *enc_ctx, struct hardsubx_sub_queue *queue)
+{
+	// Do an exhaustive linear search over the video
+
+	struct hardsubx_linear_state state = {1, 0, 0, NULL, NULL, queue};
 	int cur_sec = 0, total_sec, progress;
 	int frame_number = 0;
-	int64_t prev_begin_time = 0, prev_end_time = 0; // Begin and end time of previous seen subtitle
 	int64_t prev_packet_pts = 0;
-	char *subtitle_text = NULL;	 // Subtitle text of current frame
-	char *prev_subtitle_text = NULL; // Previously seen subtitle text
+	struct hardsubx_frame_features *ocr_features, *features, *tmp;
+	int have_ocr = 0;
+	struct hardsubx_pool *pool;
+	struct hardsubx_job *job;
+
+	ocr_features = malloc(sizeof(struct hardsubx_frame_features));
+	features = malloc(sizeof(struct hardsubx_frame_features));
+	if (!ocr_features || !features)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory to process burned-in subtitles");
+	pool = _init_hardsubx_pool(ctx, _ocr_linear_sample, ctx->roi_height, ctx->subcolor != HARDSUBX_COLOR_WHITE);
 
 	while (av_read_frame(ctx->format_ctx, &ctx->packet) >= 0)
 	{
@@ -437,136 +1131,154 @@ void hardsubx_process_frames_linear(struct lib_hardsubx_ctx *ctx, struct encoder
 
 			// Decode the video stream packet
 			avcodec_send_packet(ctx->codec_ctx, &ctx->packet);
-			if (avcodec_receive_frame(ctx->codec_ctx, ctx->frame) == 0 && frame_number % 25 == 0)
+			// When frames are skipped, every decoded one is a candidate; min_sub_duration still spaces the samples
+			if (avcodec_receive_frame(ctx->codec_ctx, ctx->frame) == 0 && (ctx->skip_frames || frame_number % 25 == 0))
 			{
 				float diff = (float)convert_pts_to_ms(ctx->packet.pts - prev_packet_pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
 				if (fabsf(diff) < 1000 * ctx->min_sub_duration) // If the minimum duration of a subtitle line is exceeded, process packet
 					continue;
 
-				// sws_scale is used to convert the pixel format to RGB24 from all other cases
-				sws_scale(
-				    ctx->sws_ctx,
-				    (uint8_t const *const *)ctx->frame->data,
-				    ctx->frame->linesize,
-				    0,
-				    ctx->codec_ctx->height,
-				    ctx->rgb_frame->data,
-				    ctx->rgb_frame->linesize);
-
-				// Send the frame to other functions for processing
-				if (ctx->subcolor == HARDSUBX_COLOR_WHITE)
-				{
-					subtitle_text = _process_frame_white_basic(ctx, ctx->rgb_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, frame_number);
-				}
-				else
+				hardsubx_convert_roi(ctx);
+				_compute_frame_features(ctx, features);
+
+				// Only OCR if the subtitle area changed since the last OCRed sample
+				int ocr = !have_ocr || _frame_features_differ(ocr_features, features);
+				if (ocr)
 				{
-					subtitle_text = _process_frame_color_basic(ctx, ctx->rgb_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, frame_number);
+					tmp = ocr_features;
+					ocr_features = features;
+					features = tmp;
+					have_ocr = 1;
 				}
-				_display_frame(ctx, ctx->rgb_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, frame_number);
+				_submit_hardsubx_job(pool, ctx->rgb_frame, ocr, &frame_number, 1, ctx->packet.pts);
 
 				cur_sec = (int)convert_pts_to_s(ctx->packet.pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
 				total_sec = (int)convert_pts_to_s(ctx->format_ctx->duration, AV_TIME_BASE_Q);
 				progress = (cur_sec * 100) / total_sec;
-				activity_progress(progress, cur_sec / 60, cur_sec % 60);
-
-				if ((!subtitle_text && !prev_subtitle_text) || (subtitle_text && !strlen(subtitle_text) && !prev_subtitle_text))
-				{
-					prev_end_time = convert_pts_to_ms(ctx->packet.pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
-				}
-
-				if (subtitle_text)
-				{
-					char *double_enter = strstr(subtitle_text, "\n\n");
-					if (double_enter != NULL)
-						*(double_enter) = '\0';
-				}
-
-				if (!prev_sub_encoded && prev_subtitle_text)
-				{
-					if (subtitle_text)
-					{
-						dist = edit_distance(subtitle_text, prev_subtitle_text, (int)strlen(subtitle_text), (int)strlen(prev_subtitle_text));
-						if (dist < (0.2 * MIN(strlen(subtitle_text), strlen(prev_subtitle_text))))
-						{
-							dist = -1;
-							subtitle_text = NULL;
-							prev_end_time = convert_pts_to_ms(ctx->packet.pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
-						}
-					}
-					if (dist != -1)
-					{
-						add_cc_sub_text(ctx->dec_sub, prev_subtitle_text, prev_begin_time, prev_end_time, "", "BURN", CCX_ENC_UTF_8);
-						encode_sub(enc_ctx, ctx->dec_sub);
-						prev_begin_time = prev_end_time + 1;
-						prev_subtitle_text = NULL;
-						prev_sub_encoded = 1;
-						prev_end_time = convert_pts_to_ms(ctx->packet.pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
-						if (subtitle_text)
-						{
-							prev_subtitle_text = strdup(subtitle_text);
-							prev_sub_encoded = 0;
-						}
-					}
-					dist = 0;
-				}
+				if (!queue) // Else the caption extraction reports progress
+					activity_progress(progress, cur_sec / 60, cur_sec % 60);
 
-				// if(ctx->conf_thresh > 0)
-				// {
-				// 	if(ctx->cur_conf >= ctx->prev_conf)
-				// 	{
-				// 		prev_subtitle_text = strdup(subtitle_text);
-				// 		ctx->prev_conf = ctx->cur_conf;
-				// 	}
-				// }
-				// else
-				// {
-				// 	prev_subtitle_text = strdup(subtitle_text);
-				// }
-
-				if (!prev_subtitle_text && subtitle_text)
+				while ((job = _next_hardsubx_result(pool, 0)))
 				{
-					prev_begin_time = prev_end_time + 1;
-					prev_end_time = convert_pts_to_ms(ctx->packet.pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
-					prev_subtitle_text = strdup(subtitle_text);
-					prev_sub_encoded = 0;
+					_merge_linear_sample(ctx, enc_ctx, &state, job);
+					_release_hardsubx_job(pool, job);
 				}
 				prev_packet_pts = ctx->packet.pts;
 			}
 		}
 		av_packet_unref(&ctx->packet);
 	}
+	while ((job = _next_hardsubx_result(pool, 1)))
+	{
+		_merge_linear_sample(ctx, enc_ctx, &state, job);
+		_release_hardsubx_job(pool, job);
+	}
+	_dinit_hardsubx_pool(&pool);
 
-	if (!prev_sub_encoded)
+	if (!state.prev_sub_encoded)
 	{
-		add_cc_sub_text(ctx->dec_sub, prev_subtitle_text, prev_begin_time, prev_end_time, "", "BURN", CCX_ENC_UTF_8);
-		encode_sub(enc_ctx, ctx->dec_sub);
-		prev_sub_encoded = 1;
+		_emit_linear_subtitle(ctx, enc_ctx, &state);
+		state.prev_sub_encoded = 1;
 	}
-	activity_progress(100, cur_sec / 60, cur_sec % 60);
+	freep(&state.ocr_text);
+	free(ocr_features);
+	free(features);
+	if (!queue)
+		activity_progress(100, cur_sec / 60, cur_sec % 60);
+}
+
+void hardsubx_process_frames_linear(struct lib_hardsubx_ctx *ctx, struct encoder_ctx *enc_ctx)
+{
+	_process_frames_linear(ctx, enc_ctx, NULL);
+}
+
+static void *_burned_in_thread_main(void *arg)
+{
+	struct hardsubx_sub_queue *queue = arg;
+	_process_frames_linear(queue->ctx, NULL, queue);
+	_set_burned_in_progress(queue, INT64_MAX, 1);
+	return NULL;
+}
+
+/**
+ * Encode the queued burned-in subtitles starting at or before up_to, all of
+ * them if up_to is negative. Wait for the search to get past up_to first, so
+ * none that starts earlier can still come.
+ */
+static void _encode_burned_in_subs(struct hardsubx_sub_queue *queue, struct encoder_ctx *enc_ctx, LLONG up_to)
+{
+	struct hardsubx_sub *sub;
+
+#ifndef _WIN32
+	pthread_mutex_lock(&queue->lock);
+	while (!queue->done && (up_to < 0 || queue->progress <= up_to))
+		pthread_cond_wait(&queue->progressed, &queue->lock);
+	pthread_mutex_unlock(&queue->lock);
+#endif
+	for (;;)
+	{
+#ifndef _WIN32
+		pthread_mutex_lock(&queue->lock);
+#endif
+		sub = queue->head;
+		if (sub && (up_to < 0 || sub->begin_time <= up_to))
+		{
+			queue->head = sub->next;
+			if (!queue->head)
+				queue->tail = NULL;
+		}
+		else
+		{
+			sub = NULL;
+		}
+#ifndef _WIN32
+		pthread_mutex_unlock(&queue->lock);
+#endif
+		if (!sub)
+			break;
+
+		add_cc_sub_text(queue->ctx->dec_sub, sub->text, sub->begin_time, sub->end_time, "", "BURN", CCX_ENC_UTF_8);
+		encode_sub(enc_ctx, queue->ctx->dec_sub);
+		free(sub->text);
+		free(sub);
+	}
+}
+
+static LLONG _caption_start_time(struct cc_subtitle *sub)
+{
+	if (sub->type == CC_608 && sub->nb_data > 0)
+		return ((struct eia608_screen *)sub->data)->start_time;
+	return sub->start_time;
+}
+
+// Called before each caption is encoded, so the output stays in order of start time
+static void _merge_burned_in_subs(void *arg, struct encoder_ctx *enc_ctx, struct cc_subtitle *sub)
+{
+	_encode_burned_in_subs((struct hardsubx_sub_queue *)arg, enc_ctx, _caption_start_time(sub));
 }
 
 void process_hardsubx_linear_frames_and_normal_subs(struct lib_hardsubx_ctx *hard_ctx, struct encoder_ctx *enc_ctx, struct lib_ccx_ctx *ctx)
 {
+	// The burned-in subtitles are searched on their own thread, with their own reader of the
+	// input, while this thread extracts the normal captions. Only the output is shared: before
+	// each caption is encoded, the burned-in subtitles starting before it are, waiting for the
+	// search to get there if needed.
+
 	// variables for cc extraction
 	struct lib_cc_decode *dec_ctx = NULL;
 	enum ccx_stream_mode_enum stream_mode;
 	struct demuxer_data *datalist = NULL;
 	struct demuxer_data *data_node = NULL;
 	int (*get_more_data)(struct lib_ccx_ctx *c, struct demuxer_data **d);
-	int ret;
+	int ret = 0;
 	int caps = 0;
 
 	uint64_t min_pts = UINT64_MAX;
 
-	// variables for burnt-in subtitle extraction
-	int prev_sub_encoded_hard = 1; // Previous seen burnt-in subtitle encoded or not
-	int dist = 0;
-	int cur_sec = 0, total_sec, progress;
-	int frame_number = 0;
-	int64_t prev_begin_time_hard = 0, prev_end_time_hard = 0; // Begin and end time of previous seen burnt-in subtitle
-	int64_t prev_packet_pts_hard = 0;
-	char *subtitle_text_hard = NULL;      // Subtitle text of current frame (burnt_in)
-	char *prev_subtitle_text_hard = NULL; // Previously seen burnt-in subtitle text
+	// burnt-in subtitle extraction
+	struct hardsubx_sub_queue queue;
+	struct lib_cc_decode *dec;
+	int threaded = 0;
 
 	stream_mode = ctx->demux_ctx->get_stream_mode(ctx->demux_ctx);
 
@@ -610,259 +1322,329 @@ void process_hardsubx_linear_frames_and_normal_subs(struct lib_hardsubx_ctx *har
 		default:
 			fatal(CCX_COMMON_EXIT_BUG_BUG, "In general_loop: Impossible value for stream_mode");
 	}
-	end_of_file = 0;
-	int status = 0;
-
-	int last_cc_encoded = 0;
+	memset(&queue, 0, sizeof(queue));
+	queue.ctx = hard_ctx;
+#ifndef _WIN32
+	pthread_mutex_init(&queue.lock, NULL);
+	pthread_cond_init(&queue.progressed, NULL);
+	threaded = !pthread_create(&queue.thread, NULL, _burned_in_thread_main, &queue);
+#endif
+	if (!threaded)
+	{
+		// Find all burned-in subtitles first, they are still merged with the captions below
+		_burned_in_thread_main(&queue);
+	}
 
-	while (true)
+	// Decoders are created inside process_non_multiprogram_general_loop(), which encodes their first
+	// captions in the same call, so the merge hook has to be in the settings they are created with
+	ctx->dec_global_setting->before_encode = _merge_burned_in_subs;
+	ctx->dec_global_setting->before_encode_arg = &queue;
+	list_for_each_entry(dec, &ctx->dec_ctx_head, list, struct lib_cc_decode)
 	{
+		dec->before_encode = _merge_burned_in_subs;
+		dec->before_encode_arg = &queue;
+	}
+
+	end_of_file = 0;
 
-		if (status < 0 && end_of_file == 1)
+	while (!terminate_asap && !end_of_file && is_decoder_processed_enough(ctx) == CCX_FALSE && ret != CCX_EINVAL)
+	{
+		position_sanity_check(ctx->demux_ctx);
+		ret = get_more_data(ctx, &datalist);
+		if (ret == CCX_EOF)
 		{
-			// status <= 0 implies either something is wrong or eof
-			break;
+			end_of_file = 1;
 		}
-		if ((!terminate_asap && !end_of_file && is_decoder_processed_enough(ctx) == CCX_FALSE) && ret != CCX_EINVAL)
+
+		if (datalist)
 		{
 			position_sanity_check(ctx->demux_ctx);
-			ret = get_more_data(ctx, &datalist);
-			if (ret == CCX_EOF)
+
+			if (!ctx->multiprogram)
 			{
-				end_of_file = 1;
+				int ret = process_non_multiprogram_general_loop(ctx,
+										&datalist,
+										&data_node,
+										&dec_ctx,
+										&enc_ctx,
+										&min_pts,
+										ret,
+										&caps);
 			}
-
-			if (datalist)
+			if (ctx->live_stream)
 			{
-				position_sanity_check(ctx->demux_ctx);
-
-				if (!ctx->multiprogram)
-				{
-
-					if (dec_ctx == NULL || hard_ctx->dec_sub->start_time >= (dec_ctx->dec_sub).start_time || status < 0)
-					{
-						int ret = process_non_multiprogram_general_loop(ctx,
-												&datalist,
-												&data_node,
-												&dec_ctx,
-												&enc_ctx,
-												&min_pts,
-												ret,
-												&caps);
-					}
-				}
-				if (ctx->live_stream)
+				int cur_sec = (int)(get_fts(dec_ctx->timing, dec_ctx->current_field) / 1000);
+				int th = cur_sec / 10;
+				if (ctx->last_reported_progress != th)
 				{
-					int cur_sec = (int)(get_fts(dec_ctx->timing, dec_ctx->current_field) / 1000);
-					int th = cur_sec / 10;
-					if (ctx->last_reported_progress != th)
-					{
-						activity_progress(-1, cur_sec / 60, cur_sec % 60);
-						ctx->last_reported_progress = th;
-					}
+					activity_progress(-1, cur_sec / 60, cur_sec % 60);
+					ctx->last_reported_progress = th;
 				}
-				else
+			}
+			else
+			{
+				if (ctx->total_inputsize > 255) // Less than 255 leads to division by zero below.
 				{
-					if (ctx->total_inputsize > 255) // Less than 255 leads to division by zero below.
+					int progress = (int)((((ctx->total_past + ctx->demux_ctx->past) >> 8) * 100) / (ctx->total_inputsize >> 8));
+					if (ctx->last_reported_progress != progress)
 					{
-						int progress = (int)((((ctx->total_past + ctx->demux_ctx->past) >> 8) * 100) / (ctx->total_inputsize >> 8));
-						if (ctx->last_reported_progress != progress)
-						{
-							LLONG t = get_fts(dec_ctx->timing, dec_ctx->current_field);
-							if (!t && ctx->demux_ctx->global_timestamp_inited)
-								t = ctx->demux_ctx->global_timestamp - ctx->demux_ctx->min_global_timestamp;
-							int cur_sec = (int)(t / 1000);
-							activity_progress(progress, cur_sec / 60, cur_sec % 60);
-							ctx->last_reported_progress = progress;
-						}
+						LLONG t = get_fts(dec_ctx->timing, dec_ctx->current_field);
+						if (!t && ctx->demux_ctx->global_timestamp_inited)
+							t = ctx->demux_ctx->global_timestamp - ctx->demux_ctx->min_global_timestamp;
+						int cur_sec = (int)(t / 1000);
+						activity_progress(progress, cur_sec / 60, cur_sec % 60);
+						ctx->last_reported_progress = progress;
 					}
 				}
+			}
 
-				// void segment_output_file(struct lib_ccx_ctx *ctx, struct lib_cc_decode *dec_ctx);
-				segment_output_file(ctx, dec_ctx);
+			// void segment_output_file(struct lib_ccx_ctx *ctx, struct lib_cc_decode *dec_ctx);
+			segment_output_file(ctx, dec_ctx);
 
-				if (ccx_options.send_to_srv)
-					net_check_conn();
-			}
+			if (ccx_options.send_to_srv)
+				net_check_conn();
 		}
-		if (end_of_file && !last_cc_encoded)
+	}
+
+	if (dec_ctx)
+	{
+		// the last closed caption needs to be encoded separately
+		enc_ctx = update_encoder_list(ctx);
+		flush_cc_decode(dec_ctx, &dec_ctx->dec_sub);
+		if (dec_ctx->dec_sub.got_output)
+			_merge_burned_in_subs(&queue, enc_ctx, &dec_ctx->dec_sub);
+		encode_sub(enc_ctx, &dec_ctx->dec_sub);
+	}
+	ctx->dec_global_setting->before_encode = NULL;
+	ctx->dec_global_setting->before_encode_arg = NULL;
+	list_for_each_entry(dec, &ctx->dec_ctx_head, list, struct lib_cc_decode)
+	{
+		dec->before_encode = NULL;
+		dec->before_encode_arg = NULL;
+	}
+
+#ifndef _WIN32
+	if (threaded)
+		pthread_join(queue.thread, NULL);
+#endif
+	_encode_burned_in_subs(&queue, enc_ctx, -1);
+#ifndef _WIN32
+	pthread_mutex_destroy(&queue.lock);
+	pthread_cond_destroy(&queue.progressed);
+#endif
+}
+
+// Decode the next video frame into ctx->frame. Returns -1 at the end of the stream.
+static int _decode_next_frame(struct lib_hardsubx_ctx *ctx, int64_t *pts)
+{
+	while (1)
+	{
+		int ret = avcodec_receive_frame(ctx->codec_ctx, ctx->frame);
+		if (ret == 0)
 		{
-			// the last closed caption needs to be encoded separately
-			// if EOF file has been hit for cc
-			// then encode one last time
-			enc_ctx = update_encoder_list(ctx);
-			flush_cc_decode(dec_ctx, &dec_ctx->dec_sub);
-			encode_sub(enc_ctx, &dec_ctx->dec_sub);
-			last_cc_encoded = 1;
+			*pts = ctx->frame->best_effort_timestamp;
+			if (*pts == AV_NOPTS_VALUE)
+				*pts = ctx->frame->pts;
+			if (*pts == AV_NOPTS_VALUE)
+				continue;
+			return 0;
 		}
-		if (hard_ctx->dec_sub->start_time <= (dec_ctx->dec_sub).start_time || end_of_file == 1)
+		if (ret != AVERROR(EAGAIN))
+			return -1;
+
+		if (av_read_frame(ctx->format_ctx, &ctx->packet) < 0)
 		{
-			status = av_read_frame(hard_ctx->format_ctx, &hard_ctx->packet);
+			// Drain the frames still held by the decoder
+			avcodec_send_packet(ctx->codec_ctx, NULL);
+			continue;
+		}
+		if (ctx->packet.stream_index == ctx->video_stream_id)
+			avcodec_send_packet(ctx->codec_ctx, &ctx->packet);
+		av_packet_unref(&ctx->packet);
+	}
+}
 
-			if (status >= 0 && hard_ctx->packet.stream_index == hard_ctx->video_stream_id)
-			{
-				frame_number++;
+// Decode the first frame at or after target into ctx->frame
+static int _seek_to_pts(struct lib_hardsubx_ctx *ctx, int64_t target, int64_t *pts)
+{
+	if (av_seek_frame(ctx->format_ctx, ctx->video_stream_id, target, AVSEEK_FLAG_BACKWARD) < 0)
+		return -1;
+	avcodec_flush_buffers(ctx->codec_ctx);
 
-				avcodec_send_packet(hard_ctx->codec_ctx, &hard_ctx->packet);
-				if (avcodec_receive_frame(hard_ctx->codec_ctx,
-							  hard_ctx->frame) == 0 &&
-				    frame_number % 25 == 0)
-				{
-					float diff = (float)convert_pts_to_ms(hard_ctx->packet.pts - prev_packet_pts_hard,
-									      hard_ctx->format_ctx->streams[hard_ctx->video_stream_id]->time_base);
+	while (_decode_next_frame(ctx, pts) == 0)
+	{
+		if (*pts >= target)
+			return 0;
+	}
+	return -1;
+}
 
-					if (fabsf(diff) >= 1000 * hard_ctx->min_sub_duration)
-					{
+/**
+ * Find the first frame after lo that looks like the sample at hi rather
+ * than the one at lo. Leaves the decoder at an arbitrary position.
+ */
+static int64_t _bisect_change(struct lib_hardsubx_ctx *ctx, int64_t lo, int64_t hi, int64_t frame_duration,
+			      const struct hardsubx_frame_features *before, const struct hardsubx_frame_features *after)
+{
+	struct hardsubx_frame_features *probe;
+	int64_t end = hi; // Frames in (lo, end) have not been looked at yet
+	int64_t pts;
 
-						// sws_scale is used to convert the pixel format to RGB24 from all other cases
-						sws_scale(
-						    hard_ctx->sws_ctx,
-						    (uint8_t const *const *)hard_ctx->frame->data,
-						    hard_ctx->frame->linesize,
-						    0,
-						    hard_ctx->codec_ctx->height,
-						    hard_ctx->rgb_frame->data,
-						    hard_ctx->rgb_frame->linesize);
-
-						if (hard_ctx->subcolor == HARDSUBX_COLOR_WHITE)
-						{
-							subtitle_text_hard = _process_frame_white_basic(hard_ctx,
-													hard_ctx->rgb_frame,
-													hard_ctx->codec_ctx->width,
-													hard_ctx->codec_ctx->height,
-													frame_number);
-						}
-						else
-						{
-							subtitle_text_hard = _process_frame_color_basic(hard_ctx,
-													hard_ctx->rgb_frame,
-													hard_ctx->codec_ctx->width,
-													hard_ctx->codec_ctx->height,
-													frame_number);
-						}
-
-						_display_frame(hard_ctx, hard_ctx->rgb_frame, hard_ctx->codec_ctx->width, hard_ctx->codec_ctx->height, frame_number);
-						cur_sec = (int)convert_pts_to_s(hard_ctx->packet.pts, hard_ctx->format_ctx->streams[hard_ctx->video_stream_id]->time_base);
-						total_sec = (int)convert_pts_to_s(hard_ctx->format_ctx->duration, AV_TIME_BASE_Q);
-						progress = (cur_sec * 100) / total_sec;
-						activity_progress(progress, cur_sec / 60, cur_sec % 60);
-						// progress on burnt-in extraction
-						if ((!subtitle_text_hard && !prev_subtitle_text_hard) || (subtitle_text_hard && !strlen(subtitle_text_hard) && !prev_subtitle_text_hard))
-						{
-							prev_end_time_hard = convert_pts_to_ms(hard_ctx->packet.pts, hard_ctx->format_ctx->streams[hard_ctx->video_stream_id]->time_base);
-						}
-
-						if (subtitle_text_hard)
-						{
-							char *double_enter = strstr(subtitle_text_hard, "\n\n");
-							if (double_enter != NULL)
-								*(double_enter) = '\0';
-						}
-
-						if (!prev_sub_encoded_hard && prev_subtitle_text_hard)
-						{
-							if (subtitle_text_hard)
-							{
-								dist = edit_distance(subtitle_text_hard, prev_subtitle_text_hard, (int)strlen(subtitle_text_hard), (int)strlen(prev_subtitle_text_hard));
-								if (dist < (0.2 * MIN(strlen(subtitle_text_hard), strlen(prev_subtitle_text_hard))))
-								{
-									dist = -1;
-									subtitle_text_hard = NULL;
-									prev_end_time_hard = convert_pts_to_ms(hard_ctx->packet.pts, hard_ctx->format_ctx->streams[hard_ctx->video_stream_id]->time_base);
-								}
-							}
-							if (dist != -1)
-							{
-								add_cc_sub_text(hard_ctx->dec_sub, prev_subtitle_text_hard, prev_begin_time_hard, prev_end_time_hard, "", "BURN", CCX_ENC_UTF_8);
-								encode_sub(enc_ctx, hard_ctx->dec_sub);
-								prev_begin_time_hard = prev_end_time_hard + 1;
-								prev_subtitle_text_hard = NULL;
-								prev_sub_encoded_hard = 1;
-								prev_end_time_hard = convert_pts_to_ms(hard_ctx->packet.pts, hard_ctx->format_ctx->streams[hard_ctx->video_stream_id]->time_base);
-								if (subtitle_text_hard)
-								{
-									prev_subtitle_text_hard = strdup(subtitle_text_hard);
-									prev_sub_encoded_hard = 0;
-								}
-							}
-							dist = 0;
-						}
-
-						if (!prev_subtitle_text_hard && subtitle_text_hard)
-						{
-							prev_begin_time_hard = prev_end_time_hard + 1;
-							prev_end_time_hard = convert_pts_to_ms(hard_ctx->packet.pts, hard_ctx->format_ctx->streams[hard_ctx->video_stream_id]->time_base);
-							prev_subtitle_text_hard = strdup(subtitle_text_hard);
-							prev_sub_encoded_hard = 0;
-						}
-						prev_packet_pts_hard = hard_ctx->packet.pts;
-					}
-				}
-			}
-			av_packet_unref(&hard_ctx->packet);
-		}
-	}
-	if (!prev_sub_encoded_hard)
+	probe = malloc(sizeof(struct hardsubx_frame_features));
+	if (!probe)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory for binary search");
+
+	while (end - lo > frame_duration)
 	{
-		add_cc_sub_text(hard_ctx->dec_sub, prev_subtitle_text_hard, prev_begin_time_hard, prev_end_time_hard, "", "BURN", CCX_ENC_UTF_8);
-		encode_sub(enc_ctx, hard_ctx->dec_sub);
-		prev_sub_encoded_hard = 1;
+		int64_t mid = lo + (end - lo) / 2;
+		if (_seek_to_pts(ctx, mid, &pts) < 0)
+			break;
+		if (pts >= end)
+		{
+			// No frame in [mid, end)
+			end = mid;
+			continue;
+		}
+
+		hardsubx_convert_roi(ctx);
+		_compute_frame_features(ctx, probe);
+		if (_frame_features_distance(probe, before) <= _frame_features_distance(probe, after))
+			lo = pts;
+		else
+			hi = end = pts;
 	}
-	activity_progress(100, cur_sec / 60, cur_sec % 60);
+
+	free(probe);
+	return hi;
 }
 
-void hardsubx_process_frames_binary(struct lib_hardsubx_ctx *ctx)
+void hardsubx_process_frames_binary(struct lib_hardsubx_ctx *ctx, struct encoder_ctx *enc_ctx)
 {
-	// Do a binary search over the input video for faster processing
-	// printf("Duration: %d\n", (int)ctx->format_ctx->duration);
-	int seconds_time = 0;
-	for (seconds_time = 0; seconds_time < 20; seconds_time++)
+	// Sample the video every min_sub_duration seconds, comparing the subtitle area of
+	// consecutive samples. Only where it changed, bisect for the exact first frame of
+	// the new subtitle and OCR it, so OCR runs once per subtitle instead of every second.
+	AVStream *stream;
+	struct hardsubx_frame_features *prev, *cur, *tmp;
+	int64_t step, frame_duration = 1;
+	int64_t pts, prev_pts = 0, last_pts = 0;
+	int have_prev = 0;
+	int cur_sec = 0, total_sec, progress;
+	int64_t prev_begin_time = 0;	 // Begin time of previous seen subtitle
+	char *subtitle_text = NULL;	 // Subtitle text of current sample
+	char *prev_subtitle_text = NULL; // Previously seen subtitle text
+
+	if (!ctx->format_ctx->pb || !(ctx->format_ctx->pb->seekable & AVIO_SEEKABLE_NORMAL))
+	{
+		mprint("Input is not seekable, binary search not possible. Falling back to linear search.\n");
+		hardsubx_process_frames_linear(ctx, enc_ctx);
+		return;
+	}
+
+	stream = ctx->format_ctx->streams[ctx->video_stream_id];
+	if (stream->avg_frame_rate.num > 0 && stream->avg_frame_rate.den > 0)
+	{
+		frame_duration = av_rescale_q(1, av_inv_q(stream->avg_frame_rate), stream->time_base);
+		if (frame_duration < 1)
+			frame_duration = 1;
+	}
+	step = av_rescale_q((int64_t)(ctx->min_sub_duration * AV_TIME_BASE), AV_TIME_BASE_Q, stream->time_base);
+	if (step < frame_duration)
+		step = frame_duration;
+
+	prev = malloc(sizeof(struct hardsubx_frame_features));
+	cur = malloc(sizeof(struct hardsubx_frame_features));
+	if (!prev || !cur)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory for binary search");
+
+	while (_decode_next_frame(ctx, &pts) == 0)
 	{
-		int64_t seek_time = seconds_time * AV_TIME_BASE;
-		seek_time = av_rescale_q(seek_time, AV_TIME_BASE_Q, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
+		last_pts = pts;
+		if (have_prev && pts < prev_pts + step)
+			continue;
+
+		hardsubx_convert_roi(ctx);
+		_compute_frame_features(ctx, cur);
+
+		cur_sec = (int)convert_pts_to_s(pts, stream->time_base);
+		total_sec = (int)convert_pts_to_s(ctx->format_ctx->duration, AV_TIME_BASE_Q);
+		progress = total_sec ? (cur_sec * 100) / total_sec : 0;
+		activity_progress(progress, cur_sec / 60, cur_sec % 60);
+
+		if (have_prev && !_frame_features_differ(prev, cur))
+		{
+			tmp = prev;
+			prev = cur;
+			cur = tmp;
+			prev_pts = pts;
+			continue;
+		}
+
+		int64_t begin = pts;
+		if (have_prev)
+		{
+			begin = _bisect_change(ctx, prev_pts, pts, frame_duration, prev, cur);
+
+			// Go back to the sample, OCR it and carry on scanning from there
+			if (_seek_to_pts(ctx, pts, &pts) < 0)
+				break;
+			hardsubx_convert_roi(ctx);
+		}
+
+		subtitle_text = NULL;
+		if (cur->total >= HARDSUBX_MIN_SUB_PIXELS)
+		{
+			if (ctx->subcolor == HARDSUBX_COLOR_WHITE)
+				subtitle_text = _process_frame_white_basic(ctx, ctx->rgb_frame, ctx->codec_ctx->width, ctx->roi_height, 0);
+			else
+				subtitle_text = _process_frame_color_basic(ctx, ctx->rgb_frame, ctx->codec_ctx->width, ctx->roi_height, 0);
+		}
+		if (subtitle_text)
+		{
+			char *double_enter = strstr(subtitle_text, "\n\n");
+			if (double_enter != NULL)
+				*(double_enter) = '\0';
+			if (!strlen(subtitle_text))
+				freep(&subtitle_text);
+		}
 
-		int ret = av_seek_frame(ctx->format_ctx, ctx->video_stream_id, seek_time, AVSEEK_FLAG_BACKWARD);
-		// printf("%d\n", ret);
-		// if(ret < 0)
-		// {
-		// 	printf("seeking back\n");
-		// 	ret = av_seek_frame(ctx->format_ctx, -1, seek_time, AVSEEK_FLAG_BACKWARD);
-		// }
-		if (ret >= 0)
+		int64_t begin_time = convert_pts_to_ms(begin, stream->time_base);
+		int same_text = 0;
+		if (prev_subtitle_text && subtitle_text)
+		{
+			same_text = _is_same_subtitle_text(subtitle_text, prev_subtitle_text);
+		}
+		if (!same_text)
 		{
-			while (av_read_frame(ctx->format_ctx, &ctx->packet) >= 0)
+			if (prev_subtitle_text)
 			{
-				if (ctx->packet.stream_index == ctx->video_stream_id)
-				{
-					avcodec_send_packet(ctx->codec_ctx, &ctx->packet);
-					if (avcodec_receive_frame(ctx->codec_ctx, ctx->frame) == 0)
-					{
-						// printf("%d\n", seek_time);
-						if (ctx->packet.pts < seek_time)
-							continue;
-						// printf("GOT FRAME: %d\n",ctx->packet.pts);
-						// sws_scale is used to convert the pixel format to RGB24 from all other cases
-						sws_scale(
-						    ctx->sws_ctx,
-						    (uint8_t const *const *)ctx->frame->data,
-						    ctx->frame->linesize,
-						    0,
-						    ctx->codec_ctx->height,
-						    ctx->rgb_frame->data,
-						    ctx->rgb_frame->linesize);
-						// Send the frame to other functions for processing
-						_display_frame(ctx, ctx->rgb_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, seconds_time);
-						break;
-					}
-				}
-				av_packet_unref(&ctx->packet);
+				add_cc_sub_text(ctx->dec_sub, prev_subtitle_text, prev_begin_time, begin_time - 1, "", "BURN", CCX_ENC_UTF_8);
+				encode_sub(enc_ctx, ctx->dec_sub);
+				free(prev_subtitle_text);
 			}
+			prev_subtitle_text = subtitle_text;
+			prev_begin_time = begin_time;
 		}
 		else
 		{
-			printf("Seeking to timestamp failed\n");
+			free(subtitle_text);
 		}
+
+		tmp = prev;
+		prev = cur;
+		cur = tmp;
+		prev_pts = pts;
+		have_prev = 1;
 	}
+
+	if (prev_subtitle_text)
+	{
+		add_cc_sub_text(ctx->dec_sub, prev_subtitle_text, prev_begin_time, convert_pts_to_ms(last_pts, stream->time_base), "", "BURN", CCX_ENC_UTF_8);
+		encode_sub(enc_ctx, ctx->dec_sub);
+		free(prev_subtitle_text);
+	}
+	free(prev);
+	free(cur);
+	activity_progress(100, cur_sec / 60, cur_sec % 60);
 }
 
 #endif
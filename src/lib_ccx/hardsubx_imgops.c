@@ -113,4 +113,104 @@ void rgb_to_lab(float R, float G, float B, float *L, float *a, float *b)
 		*b = YELLOW;
 }
 
+static void build_lum_tables(struct hardsubx_color_lut *lut, float lum_thresh)
+{
+	// The L of rgb_to_lab() only depends on Y, which is a weighted sum of R, G and B
+	for (int v = 0; v < 256; v++)
+	{
+		lut->lum_r[v] = 0.212671f * v / 255;
+		lut->lum_g[v] = 0.715160f * v / 255;
+		lut->lum_b[v] = 0.072169f * v / 255;
+	}
+
+	// L is clamped to BLACK from below, so L > lum_thresh always holds for lum_thresh < BLACK
+	if (lum_thresh < BLACK)
+		lut->lum_min = -1.0f;
+	else
+		lut->lum_min = powf((lum_thresh + 16.0f) / 116.0f, 3.0f);
+	lut->lum_thresh = lum_thresh;
+}
+
+static void build_hue_table(struct hardsubx_color_lut *lut, float hue)
+{
+	if (!lut->hue_match)
+	{
+		lut->hue_match = malloc(1 << 21);
+		if (!lut->hue_match)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory for the hue lookup table");
+	}
+	memset(lut->hue_match, 0, 1 << 21);
+
+	for (int r = 0; r < 256; r++)
+	{
+		for (int g = 0; g < 256; g++)
+		{
+			for (int b = 0; b < 256; b++)
+			{
+				float H, S, V;
+				rgb_to_hsv((float)r, (float)g, (float)b, &H, &S, &V);
+				if (fabsf(H - hue) < 20)
+					lut->hue_match[(r << 13) | (g << 5) | (b >> 3)] |= 1 << (b & 7);
+			}
+		}
+	}
+	lut->hue = hue;
+}
+
+/**
+ * Return the colour lookup tables for the current lum_thresh and hue of
+ * ctx, building them on first use and rebuilding them if either changed.
+ * The 2 MB hue table is only built if need_hue is set.
+ */
+struct hardsubx_color_lut *hardsubx_get_color_lut(struct lib_hardsubx_ctx *ctx, int need_hue)
+{
+	struct hardsubx_color_lut *lut = ctx->color_lut;
+
+	if (!lut)
+	{
+		lut = calloc(1, sizeof(struct hardsubx_color_lut));
+		if (!lut)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory for the colour lookup tables");
+		build_lum_tables(lut, ctx->lum_thresh);
+		ctx->color_lut = lut;
+	}
+	else if (lut->lum_thresh != ctx->lum_thresh)
+	{
+		build_lum_tables(lut, ctx->lum_thresh);
+	}
+
+	if (need_hue && (!lut->hue_match || lut->hue != ctx->hue))
+		build_hue_table(lut, ctx->hue);
+
+	return lut;
+}
+
+void hardsubx_free_color_lut(struct lib_hardsubx_ctx *ctx)
+{
+	if (!ctx->color_lut)
+		return;
+	free(ctx->color_lut->hue_match);
+	freep(&ctx->color_lut);
+}
+
+/**
+ * Set match[k] if pixel k * step of the packed RGB row rgb has the subtitle
+ * colour, for k < count: an L above lum_thresh, or a hue within 20 degrees of
+ * hue if by_hue is set. Lets code shared by both builds test colours exactly
+ * as the frame processing functions do.
+ */
+void hardsubx_match_color(struct lib_hardsubx_ctx *ctx, const uint8_t *rgb, int count, int step, int by_hue, uint8_t *match)
+{
+	struct hardsubx_color_lut *lut = hardsubx_get_color_lut(ctx, by_hue);
+
+	for (int k = 0; k < count; k++)
+	{
+		const uint8_t *p = rgb + 3 * k * step;
+		if (by_hue)
+			match[k] = HARDSUBX_HUE_MATCH(lut, p[0], p[1], p[2]);
+		else
+			match[k] = HARDSUBX_LUM_MATCH(lut, p[0], p[1], p[2]);
+	}
+}
+
 #endif
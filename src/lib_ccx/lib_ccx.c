@@ -5,6 +5,7 @@
 #include "dvb_subtitle_decoder.h"
 #include "ccx_decoders_708.h"
 #include "ccx_decoders_isdb.h"
+#include "ocr.h"
 
 struct ccx_common_logging_t ccx_common_logging;
 static struct ccx_decoders_common_settings_t *init_decoder_setting(
@@ -33,6 +34,8 @@ static struct ccx_decoders_common_settings_t *init_decoder_setting(
 	setting->hauppauge_mode = opt->hauppauge_mode;
 	setting->xds_write_to_file = opt->transcript_settings.xds;
 	setting->ocr_quantmode = opt->ocr_quantmode;
+	setting->before_encode = NULL;
+	setting->before_encode_arg = NULL;
 
 	return setting;
 }
@@ -78,17 +81,22 @@ static int init_ctx_outbase(struct ccx_s_options *opt, struct lib_ccx_ctx *ctx)
 	return 0;
 }
 
-struct encoder_ctx *get_encoder_by_pn(struct lib_ccx_ctx *ctx, int pn)
+struct encoder_ctx *get_encoder_by_stream(struct lib_ccx_ctx *ctx, int pn, int pid)
 {
 	struct encoder_ctx *enc_ctx;
 	list_for_each_entry(enc_ctx, &ctx->enc_ctx_head, list, struct encoder_ctx)
 	{
-		if (enc_ctx && enc_ctx->program_number == pn)
+		if (enc_ctx && enc_ctx->program_number == pn && enc_ctx->stream_pid == pid)
 			return enc_ctx;
 	}
 	return NULL;
 }
 
+struct encoder_ctx *get_encoder_by_pn(struct lib_ccx_ctx *ctx, int pn)
+{
+	return get_encoder_by_stream(ctx, pn, 0);
+}
+
 struct lib_ccx_ctx *init_libraries(struct ccx_s_options *opt)
 {
 	int ret = 0;
@@ -225,7 +233,7 @@ void dinit_libraries(struct lib_ccx_ctx **ctx)
 
 		flush_cc_decode(dec_ctx, &dec_ctx->dec_sub);
 		cfts = get_fts(dec_ctx->timing, dec_ctx->current_field);
-		enc_ctx = get_encoder_by_pn(lctx, dec_ctx->program_number);
+		enc_ctx = get_encoder_by_stream(lctx, dec_ctx->program_number, dec_ctx->stream_pid);
 		if (enc_ctx && dec_ctx->dec_sub.got_output == CCX_TRUE)
 		{
 			encode_sub(enc_ctx, &dec_ctx->dec_sub);
@@ -245,6 +253,9 @@ void dinit_libraries(struct lib_ccx_ctx **ctx)
 	freep(&lctx->freport.data_from_608);
 	freep(&lctx->freport.data_from_708);
 	ccx_demuxer_delete(&lctx->demux_ctx);
+#ifdef ENABLE_OCR
+	free_ocr_registry();
+#endif
 	dinit_decoder_setting(&lctx->dec_global_setting);
 	freep(&ccx_options.enc_cfg.output_filename);
 	freep(&lctx->basefilename);
@@ -435,3 +446,93 @@ struct encoder_ctx *update_encoder_list(struct lib_ccx_ctx *ctx)
 {
 	return update_encoder_list_cinfo(ctx, NULL);
 }
+
+/**
+ * Decoder bound to a single DVB stream, used with --dvblang all for every
+ * DVB stream other than the one picked by get_best_stream().
+ */
+struct lib_cc_decode *update_decoder_list_stream(struct lib_ccx_ctx *ctx, struct cap_info *cinfo)
+{
+	struct lib_cc_decode *dec_ctx;
+
+	list_for_each_entry(dec_ctx, &ctx->dec_ctx_head, list, struct lib_cc_decode)
+	{
+		if (dec_ctx->stream_pid == cinfo->pid)
+			return dec_ctx;
+	}
+
+	ctx->dec_global_setting->program_number = cinfo->program_number;
+	ctx->dec_global_setting->codec = cinfo->codec;
+	ctx->dec_global_setting->private_data = cinfo->codec_private_data;
+	dec_ctx = init_cc_decode(ctx->dec_global_setting);
+	if (!dec_ctx)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In update_decoder_list_stream: Not enough memory allocating dec_ctx\n");
+	dec_ctx->stream_pid = cinfo->pid;
+	list_add_tail(&(dec_ctx->list), &(ctx->dec_ctx_head));
+
+	// DVB related
+	dec_ctx->prev = NULL;
+	dec_ctx->dec_sub.prev = NULL;
+
+	return dec_ctx;
+}
+
+/**
+ * Encoder matching update_decoder_list_stream(). The output is named after
+ * the stream language, with the PID appended if that name is already taken.
+ */
+struct encoder_ctx *update_encoder_list_stream(struct lib_ccx_ctx *ctx, struct cap_info *cinfo, const char *lang)
+{
+	struct encoder_ctx *enc_ctx;
+	struct encoder_ctx *iter;
+	struct encoder_cfg cfg;
+	char suffix[32];
+
+	if (ctx->write_format == CCX_OF_NULL)
+		return NULL;
+
+	list_for_each_entry(enc_ctx, &ctx->enc_ctx_head, list, struct encoder_ctx)
+	{
+		if (enc_ctx->stream_pid == cinfo->pid)
+			return enc_ctx;
+	}
+
+	const char *extension = get_file_extension(ccx_options.enc_cfg.write_format);
+	if (!extension)
+		return NULL;
+
+	cfg = ccx_options.enc_cfg;
+	cfg.program_number = cinfo->program_number;
+	cfg.in_format = 1;
+	snprintf(suffix, sizeof(suffix), "_%s", lang);
+	cfg.output_filename = create_outfilename(ctx->basefilename, suffix, extension);
+	list_for_each_entry(iter, &ctx->enc_ctx_head, list, struct encoder_ctx)
+	{
+		if (iter->out && iter->out[0].filename && cfg.output_filename && !strcmp(iter->out[0].filename, cfg.output_filename))
+		{
+			free(cfg.output_filename);
+			snprintf(suffix, sizeof(suffix), "_%s_%d", lang, cinfo->pid);
+			cfg.output_filename = create_outfilename(ctx->basefilename, suffix, extension);
+			break;
+		}
+	}
+	if (!cfg.output_filename)
+		return NULL;
+
+	enc_ctx = init_encoder(&cfg);
+	if (!enc_ctx)
+	{
+		free(cfg.output_filename);
+		return NULL;
+	}
+	mprint("Extracting DVB stream %d (%s) to %s\n", cinfo->pid, lang, cfg.output_filename);
+	free(cfg.output_filename);
+
+	enc_ctx->stream_pid = cinfo->pid;
+	list_add_tail(&(enc_ctx->list), &(ctx->enc_ctx_head));
+
+	// DVB related
+	enc_ctx->prev = NULL;
+	enc_ctx->write_previous = 0;
+	return enc_ctx;
+}
@@ -54,6 +54,7 @@ struct ccx_s_teletext_config
 	// uint8_t se_mode : 1;                                    // search engine compatible mode => Uses CCExtractor's write_format
 	// uint64_t utc_refvalue;                                  // UTC referential value => Moved to ccx_decoders_common, so can be used for other decoders (608/xds) too
 	uint16_t user_page;                                        // Page selected by user, which MIGHT be different to 'page' depending on autodetection stuff
+	int all_pages;                                             // Also extract every other subtitle page, each to its own output file
 	int dolevdist;											   // 0=Don't attempt to correct errors
 	int levdistmincnt, levdistmaxpct;                          // Means 2 fails or less is "the same", 10% or less is also "the same"
 	struct ccx_boundary_time extraction_start, extraction_end; // Segment we actually process
@@ -271,6 +272,7 @@ int hex_to_int (char high, char low);
 int hex_string_to_int(char* string, int len);
 void timestamp_to_srttime(uint64_t timestamp, char *buffer);
 int levenshtein_dist (const uint64_t *s1, const uint64_t *s2, unsigned s1len, unsigned s2len);
+int levenshtein_dist_bounded (const uint64_t *s1, const uint64_t *s2, unsigned s1len, unsigned s2len, unsigned max);
 void millis_to_date (uint64_t timestamp, char *buffer, enum ccx_output_date_format date_format, char millis_separator);
 void signal_handler(int sig_type);
 struct encoder_ctx* change_filename(struct encoder_ctx*);
@@ -282,7 +284,7 @@ void m_signal(int sig, void (*func)(int));
 void buffered_seek (struct ccx_demuxer *ctx, int offset);
 extern void build_parity_table(void);
 
-int tlt_process_pes_packet(struct lib_cc_decode *dec_ctx, uint8_t *buffer, uint16_t size, struct cc_subtitle *sub, int sentence_cap);
+int tlt_process_pes_packet(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, uint8_t *buffer, uint16_t size, struct cc_subtitle *sub);
 void* telxcc_init(void);
 void telxcc_close(void **ctx, struct cc_subtitle *sub);
 void tlt_read_rcwt(void *codec, unsigned char *buf, struct cc_subtitle *sub);
@@ -320,6 +322,9 @@ struct lib_cc_decode *update_decoder_list(struct lib_ccx_ctx *ctx);
 struct encoder_ctx *update_encoder_list_cinfo(struct lib_ccx_ctx *ctx, struct cap_info* cinfo);
 struct encoder_ctx * update_encoder_list(struct lib_ccx_ctx *ctx);
 struct encoder_ctx *get_encoder_by_pn(struct lib_ccx_ctx *ctx, int pn);
+struct encoder_ctx *get_encoder_by_stream(struct lib_ccx_ctx *ctx, int pn, int pid);
+struct lib_cc_decode *update_decoder_list_stream(struct lib_ccx_ctx *ctx, struct cap_info *cinfo);
+struct encoder_ctx *update_encoder_list_stream(struct lib_ccx_ctx *ctx, struct cap_info *cinfo, const char *lang);
 int process_non_multiprogram_general_loop(struct lib_ccx_ctx* ctx, 
 											struct demuxer_data **datalist,
 											struct demuxer_data **data_node,
@@ -9,10 +9,34 @@
 #include "ccx_encoders_helpers.h"
 #include "ccx_encoders_spupng.h"
 #include "ocr.h"
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/* Broadcasters keep re-sending the same subtitle bitmap on every display
+ * set, so remember the text of the last few bitmaps we OCR'ed. */
+#define OCR_CACHE_SIZE 16
+
+struct ocr_cache_entry
+{
+	uint64_t hash;
+	int w;
+	int h;
+	int nb_colors;
+	int bgcolor;
+	int quantmode;
+	uint64_t last_used; // 0 if the slot is empty
+	char *text;
+};
 
 struct ocrCtx
 {
 	TessBaseAPI *api;
+	struct ocr_cache_entry cache[OCR_CACHE_SIZE];
+	uint64_t cache_clock;
+	unsigned int cache_hits;
+	unsigned int cache_misses;
 };
 
 struct transIntensity
@@ -79,6 +103,10 @@ static int search_language_pack(const char *dir_name, const char *lang_name)
 void delete_ocr(void **arg)
 {
 	struct ocrCtx *ctx = *arg;
+	if (ctx->cache_hits || ctx->cache_misses)
+		dbg_print(CCX_DMT_VERBOSE, "OCR cache: %u hits, %u misses\n", ctx->cache_hits, ctx->cache_misses);
+	for (int i = 0; i < OCR_CACHE_SIZE; i++)
+		freep(&ctx->cache[i].text);
 	TessBaseAPIEnd(ctx->api);
 	TessBaseAPIDelete(ctx->api);
 	freep(arg);
@@ -126,6 +154,7 @@ void *init_ocr(int lang_index)
 	ctx = (struct ocrCtx *)malloc(sizeof(struct ocrCtx));
 	if (!ctx)
 		return NULL;
+	memset(ctx, 0, sizeof(struct ocrCtx));
 
 	if (ccx_options.ocrlang)
 		lang = ccx_options.ocrlang;
@@ -194,6 +223,182 @@ fail:
 	return NULL;
 }
 
+/*
+ * Process-wide registry of OCR contexts. Loading traineddata is slow and
+ * takes a lot of memory, so contexts are handed back to the registry
+ * instead of being deleted and reused by the next decoder that needs the
+ * same language. A context is only used by one thread at a time, and only
+ * held for a single OCR call.
+ *
+ * The Tesseract C API cannot share a loaded model between TessBaseAPI
+ * handles, so a language is loaded once more only when OCR calls actually
+ * overlap, and at most once per CPU core. Past that, callers wait for a
+ * context to be released. Loading is done without the registry lock, so
+ * other languages and loaded copies stay available meanwhile.
+ */
+struct ocr_registry_entry
+{
+	char *lang;
+	void *ctx; // NULL if the language could not be loaded
+	int in_use;
+	int loading; // Set while the context is being loaded, ctx is not set yet
+	struct ocr_registry_entry *next;
+};
+
+static struct ocr_registry_entry *ocr_registry = NULL;
+#ifndef _WIN32
+static pthread_mutex_t ocr_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t ocr_registry_changed = PTHREAD_COND_INITIALIZER; // A context was released or loaded
+#endif
+
+static int max_ocr_contexts(void)
+{
+#ifndef _WIN32
+	static int max = 0;
+	if (!max)
+	{
+		long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		max = cores > 0 ? (int)cores : 1;
+	}
+	return max;
+#else
+	return 1;
+#endif
+}
+
+static void lock_ocr_registry(void)
+{
+#ifndef _WIN32
+	pthread_mutex_lock(&ocr_registry_lock);
+#endif
+}
+
+static void unlock_ocr_registry(void)
+{
+#ifndef _WIN32
+	pthread_mutex_unlock(&ocr_registry_lock);
+#endif
+}
+
+void *acquire_ocr(int lang_index)
+{
+	struct ocr_registry_entry *entry, **link;
+	const char *lang;
+	void *ctx = NULL;
+	int extra_failed = 0; // Loading one more copy failed, wait for the loaded ones instead
+
+	if (ccx_options.ocrlang)
+		lang = ccx_options.ocrlang;
+	else
+		lang = language[lang_index ? lang_index : 1];
+
+	lock_ocr_registry();
+	for (;;)
+	{
+		int loaded = 0;
+		int loading = 0;
+		for (entry = ocr_registry; entry; entry = entry->next)
+		{
+			if (strcmp(entry->lang, lang))
+				continue;
+			if (entry->loading)
+			{
+				loading = 1;
+				continue;
+			}
+			if (!entry->ctx)
+				goto end; // The first copy failed to load, don't try again
+			if (!entry->in_use)
+			{
+				entry->in_use = 1;
+				ctx = entry->ctx;
+				goto end;
+			}
+			loaded++;
+		}
+		if (loading || extra_failed || loaded >= max_ocr_contexts())
+		{
+#ifndef _WIN32
+			// Every copy of the language is busy, and no other one is to be loaded now
+			pthread_cond_wait(&ocr_registry_changed, &ocr_registry_lock);
+			continue;
+#else
+			if (extra_failed)
+				goto end;
+#endif
+		}
+
+		// The placeholder keeps the language from being loaded twice at once
+		entry = (struct ocr_registry_entry *)malloc(sizeof(struct ocr_registry_entry));
+		if (!entry)
+			goto end;
+		entry->lang = strdup(lang);
+		entry->ctx = NULL;
+		entry->in_use = 1;
+		entry->loading = 1;
+		entry->next = ocr_registry;
+		ocr_registry = entry;
+		unlock_ocr_registry();
+
+		ctx = init_ocr(lang_index);
+
+		lock_ocr_registry();
+		entry->ctx = ctx;
+		entry->loading = 0;
+#ifndef _WIN32
+		pthread_cond_broadcast(&ocr_registry_changed);
+#endif
+		// Only a failed first copy stays registered, to mark the language as not loadable
+		if (ctx || !loaded)
+			break;
+		for (link = &ocr_registry; *link != entry; link = &(*link)->next)
+			;
+		*link = entry->next;
+		free(entry->lang);
+		free(entry);
+		extra_failed = 1;
+	}
+end:
+	unlock_ocr_registry();
+	return ctx;
+}
+
+void release_ocr(void **arg)
+{
+	struct ocr_registry_entry *entry;
+
+	if (!*arg)
+		return;
+	lock_ocr_registry();
+	for (entry = ocr_registry; entry; entry = entry->next)
+	{
+		if (entry->ctx == *arg)
+			entry->in_use = 0;
+	}
+#ifndef _WIN32
+	pthread_cond_broadcast(&ocr_registry_changed);
+#endif
+	unlock_ocr_registry();
+	*arg = NULL;
+}
+
+void free_ocr_registry(void)
+{
+	struct ocr_registry_entry *entry;
+
+	lock_ocr_registry();
+	while (ocr_registry)
+	{
+		entry = ocr_registry;
+		ocr_registry = entry->next;
+		if (entry->ctx)
+			delete_ocr(&entry->ctx);
+		free(entry->lang);
+		free(entry);
+	}
+	unlock_ocr_registry();
+}
+
 /*
  * The return value **has** to be freed:
  *
@@ -232,6 +437,70 @@ BOX *ignore_alpha_at_edge(png_byte *alpha, unsigned char *indata, int w, int h,
 	return cropWindow;
 }
 
+/**
+ * Build the image handed to Tesseract in a single pass over the indexed
+ * bitmap: 8-bit gray looked up per palette entry, already cropped to the
+ * columns ignore_alpha_at_edge() would keep. Gives the same pixels as
+ * composing the RGBA image, cropping it and running pixConvertRGBToGray(),
+ * without the two intermediate 32-bit images.
+ */
+static PIX *prepare_ocr_pix(png_color *palette, png_byte *alpha, unsigned char *indata, int w, int h, int nb_colors)
+{
+	uint8_t gray[256] = {0};
+	uint8_t visible[256] = {0};
+	int start = w, end = 0, nb_visible = 0;
+	PIX *pix;
+	l_uint32 *data;
+	int wpl;
+
+	for (int i = 0; i < nb_colors && i < 256; i++)
+	{
+		gray[i] = (uint8_t)(L_RED_WEIGHT * palette[i].red + L_GREEN_WEIGHT * palette[i].green +
+				    L_BLUE_WEIGHT * palette[i].blue + 0.5);
+		visible[i] = alpha[i] != 0;
+	}
+
+	// Leftmost and rightmost visible columns, border columns excluded
+	for (int i = 0; i < h; i++)
+	{
+		const unsigned char *row = indata + i * w;
+		int first = 1, last;
+
+		while (first < w - 1 && !visible[row[first]])
+			first++;
+		if (first >= w - 1)
+			continue;
+		for (last = w - 2; last > first && !visible[row[last]]; last--)
+			;
+		nb_visible += last > first ? 2 : 1;
+		if (first < start)
+			start = first;
+		if (last > end)
+			end = last;
+	}
+	// ignore_alpha_at_edge() only moves the right edge past the first visible pixel
+	if (nb_visible < 2)
+		end = 0;
+	if (nb_visible == 0)
+		start = 0;
+	if (end - start <= 0 || h - 1 <= 0)
+		return NULL;
+
+	pix = pixCreate(end - start, h - 1, 8);
+	if (!pix)
+		return NULL;
+	data = pixGetData(pix);
+	wpl = pixGetWpl(pix);
+	for (int i = 0; i < h - 1; i++)
+	{
+		const unsigned char *src = indata + i * w + start;
+		l_uint32 *line = data + i * wpl;
+		for (int j = 0; j < end - start; j++)
+			SET_DATA_BYTE(line, j, gray[src[j]]);
+	}
+	return pix;
+}
+
 void debug_tesseract(struct ocrCtx *ctx, char *dump_path)
 {
 #ifdef OCR_DEBUG
@@ -268,65 +537,18 @@ char *ocr_bitmap(void *arg, png_color *palette, png_byte *alpha, unsigned char *
 	// uncomment the below lines to output raw image as debug.png iteratively
 	// save_spupng("debug.png", indata, w, h, palette, alpha, 16);
 
-	PIX *pix = NULL;
-	PIX *cpix = NULL;
 	PIX *cpix_gs = NULL; // Grayscale version
 	PIX *color_pix = NULL;
 	PIX *color_pix_out = NULL;
+	BOX *crop_points = NULL;
 	int i, j, index;
 	unsigned int wpl;
 	unsigned int *data, *ppixel;
 	BOOL tess_ret = FALSE;
 	struct ocrCtx *ctx = arg;
-	pix = pixCreate(w, h, 32);
-	color_pix = pixCreate(w, h, 32);
-	if (pix == NULL || color_pix == NULL)
-	{
-		return NULL;
-	}
-	wpl = pixGetWpl(pix);
-	data = pixGetData(pix);
-#if LEPTONICA_VERSION > 69
-	pixSetSpp(pix, 4);
-	pixSetSpp(color_pix, 4);
-#endif
-	for (i = 0; i < h; i++)
-	{
-		ppixel = data + i * wpl;
-		for (j = 0; j < w; j++)
-		{
-			index = indata[i * w + (j)];
-			composeRGBPixel(palette[index].red, palette[index].green, palette[index].blue, ppixel);
-			SET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL, alpha[index]);
-			ppixel++;
-		}
-	}
-	BOX *temp = ignore_alpha_at_edge(alpha, indata, w, h, pix, &cpix);
-	boxDestroy(&temp);
-
-	// For the unquantized bitmap
-	wpl = pixGetWpl(color_pix);
-	data = pixGetData(color_pix);
-	for (i = 0; i < h; i++)
-	{
-		ppixel = data + i * wpl;
-		for (j = 0; j < w; j++)
-		{
-			index = copy->data[i * w + (j)];
-			composeRGBPixel(copy->palette[index].red, copy->palette[index].green, copy->palette[index].blue, ppixel);
-			SET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL, copy->alpha[index]);
-			ppixel++;
-		}
-	}
 
-	BOX *crop_points = ignore_alpha_at_edge(copy->alpha, copy->data, w, h, color_pix, &color_pix_out);
-
-	l_int32 x, y, _w, _h;
-
-	boxGetGeometry(crop_points, &x, &y, &_w, &_h);
-
-	// Converting image to grayscale for OCR to avoid issues with transparency
-	cpix_gs = pixConvertRGBToGray(cpix, 0.0, 0.0, 0.0);
+	// Grayscale for OCR to avoid issues with transparency
+	cpix_gs = prepare_ocr_pix(palette, alpha, indata, w, h, copy->nb_colors);
 
 	if (cpix_gs == NULL)
 		tess_ret = -1;
@@ -339,11 +561,7 @@ char *ocr_bitmap(void *arg, png_color *palette, png_byte *alpha, unsigned char *
 		{
 			mprint("\nIn ocr_bitmap: Failed to perform OCR. Skipped.\n");
 
-			pixDestroy(&pix);
-			pixDestroy(&cpix);
 			pixDestroy(&cpix_gs);
-			pixDestroy(&color_pix);
-			pixDestroy(&color_pix_out);
 
 			return NULL;
 		}
@@ -366,6 +584,37 @@ char *ocr_bitmap(void *arg, png_color *palette, png_byte *alpha, unsigned char *
 		int written_tag = 0;
 		TessResultIterator *ri = 0;
 		TessPageIteratorLevel level = RIL_WORD;
+
+		// The unquantized bitmap is only needed here
+		color_pix = pixCreate(w, h, 32);
+		if (color_pix == NULL)
+		{
+			pixDestroy(&cpix_gs);
+			return text_out;
+		}
+#if LEPTONICA_VERSION > 69
+		pixSetSpp(color_pix, 4);
+#endif
+		wpl = pixGetWpl(color_pix);
+		data = pixGetData(color_pix);
+		for (i = 0; i < h; i++)
+		{
+			ppixel = data + i * wpl;
+			for (j = 0; j < w; j++)
+			{
+				index = copy->data[i * w + (j)];
+				composeRGBPixel(copy->palette[index].red, copy->palette[index].green, copy->palette[index].blue, ppixel);
+				SET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL, copy->alpha[index]);
+				ppixel++;
+			}
+		}
+
+		crop_points = ignore_alpha_at_edge(copy->alpha, copy->data, w, h, color_pix, &color_pix_out);
+
+		l_int32 x, y, _w, _h;
+
+		boxGetGeometry(crop_points, &x, &y, &_w, &_h);
+
 		TessBaseAPISetImage2(ctx->api, color_pix_out);
 		tess_ret = TessBaseAPIRecognize(ctx->api, NULL);
 		if (tess_ret != 0)
@@ -687,8 +936,6 @@ char *ocr_bitmap(void *arg, png_color *palette, png_byte *alpha, unsigned char *
 	// End Color Detection
 	boxDestroy(&crop_points);
 
-	pixDestroy(&pix);
-	pixDestroy(&cpix);
 	pixDestroy(&cpix_gs);
 	pixDestroy(&color_pix);
 	pixDestroy(&color_pix_out);
@@ -886,11 +1133,84 @@ end:
 	return ret;
 }
 
+/**
+ * FNV-1a over everything that affects the OCR result of a bitmap:
+ * its size, palette and pixels.
+ */
+static uint64_t hash_rect(struct cc_bitmap *rect)
+{
+	uint64_t hash = FNV1A_64_INIT;
+
+	hash = fnv1a_64(hash, &rect->w, sizeof(rect->w));
+	hash = fnv1a_64(hash, &rect->h, sizeof(rect->h));
+	hash = fnv1a_64(hash, rect->data1, (size_t)rect->nb_colors * 4);
+	hash = fnv1a_64(hash, rect->data0, (size_t)rect->w * rect->h);
+	return hash;
+}
+
+static struct ocr_cache_entry *ocr_cache_lookup(struct ocrCtx *ctx, struct cc_bitmap *rect, uint64_t hash, int bgcolor, int ocr_quantmode)
+{
+	for (int i = 0; i < OCR_CACHE_SIZE; i++)
+	{
+		struct ocr_cache_entry *entry = &ctx->cache[i];
+		if (entry->last_used && entry->hash == hash && entry->w == rect->w && entry->h == rect->h &&
+		    entry->nb_colors == rect->nb_colors && entry->bgcolor == bgcolor && entry->quantmode == ocr_quantmode)
+			return entry;
+	}
+	return NULL;
+}
+
+static void ocr_cache_insert(struct ocrCtx *ctx, struct cc_bitmap *rect, uint64_t hash, int bgcolor, int ocr_quantmode, const char *text)
+{
+	struct ocr_cache_entry *victim = &ctx->cache[0];
+
+	// Take an empty slot if there is one, the least recently used otherwise
+	for (int i = 0; i < OCR_CACHE_SIZE && victim->last_used; i++)
+	{
+		if (ctx->cache[i].last_used < victim->last_used)
+			victim = &ctx->cache[i];
+	}
+
+	freep(&victim->text);
+	victim->text = text ? strdup(text) : NULL;
+	victim->hash = hash;
+	victim->w = rect->w;
+	victim->h = rect->h;
+	victim->nb_colors = rect->nb_colors;
+	victim->bgcolor = bgcolor;
+	victim->quantmode = ocr_quantmode;
+	victim->last_used = ++ctx->cache_clock;
+}
+
+void ocr_cache_stats(void *arg, unsigned int *hits, unsigned int *misses)
+{
+	struct ocrCtx *ctx = arg;
+	*hits = ctx ? ctx->cache_hits : 0;
+	*misses = ctx ? ctx->cache_misses : 0;
+}
+
 int ocr_rect(void *arg, struct cc_bitmap *rect, char **str, int bgcolor, int ocr_quantmode)
 {
 	int ret = 0;
 	png_color *palette = NULL;
 	png_byte *alpha = NULL;
+	struct ocrCtx *ctx = arg;
+	struct ocr_cache_entry *cached;
+	uint64_t hash = 0;
+
+	if (rect->w > 0 && rect->h > 0)
+	{
+		hash = hash_rect(rect);
+		cached = ocr_cache_lookup(ctx, rect, hash, bgcolor, ocr_quantmode);
+		if (cached)
+		{
+			ctx->cache_hits++;
+			cached->last_used = ++ctx->cache_clock;
+			*str = cached->text ? strdup(cached->text) : NULL;
+			return 0;
+		}
+		ctx->cache_misses++;
+	}
 
 	struct image_copy *copy;
 	copy = (struct image_copy *)malloc(sizeof(struct image_copy));
@@ -927,10 +1247,7 @@ int ocr_rect(void *arg, struct cc_bitmap *rect, char **str, int bgcolor, int ocr
 	}
 
 	copy->data = (unsigned char *)malloc(sizeof(unsigned char) * size);
-	for (int i = 0; i < size; i++)
-	{
-		copy->data[i] = rect->data0[i];
-	}
+	memcpy(copy->data, rect->data0, size);
 
 	switch (ocr_quantmode)
 	{
@@ -956,6 +1273,8 @@ int ocr_rect(void *arg, struct cc_bitmap *rect, char **str, int bgcolor, int ocr
 	}
 
 	*str = ocr_bitmap(arg, palette, alpha, rect->data0, rect->w, rect->h, copy);
+	if (size > 0)
+		ocr_cache_insert(ctx, rect, hash, bgcolor, ocr_quantmode, *str);
 
 end:
 	freep(&palette);
@@ -967,6 +1286,201 @@ end:
 	return ret;
 }
 
+/*
+ * OCR pool: runs ocr_rect() on worker threads, each one with its own
+ * TessBaseAPI, so the decoder doesn't stall while Tesseract works. The
+ * caller owns the bitmaps and must call ocr_pool_wait() before it reads
+ * their ocr_text or frees them.
+ */
+struct ocr_job
+{
+	struct cc_bitmap *rect;
+	int bgcolor;
+	int quantmode;
+	struct ocr_job *next;
+};
+
+struct ocrPool;
+
+struct ocr_worker
+{
+	struct ocrPool *pool;
+#ifndef _WIN32
+	pthread_t thread;
+#endif
+};
+
+struct ocrPool
+{
+	int lang_index;
+	int nb_threads; // Requested, threads are started on the first job
+	int started;
+	int nb_workers;
+	struct ocr_worker *workers;
+#ifndef _WIN32
+	pthread_mutex_t lock;
+	pthread_cond_t job_ready;
+	pthread_cond_t all_done;
+	struct ocr_job *head;
+	struct ocr_job *tail;
+	int pending; // Jobs queued or running
+	int quit;
+#endif
+};
+
+static void run_ocr_job(struct ocrPool *pool, struct ocr_job *job)
+{
+	char *str = NULL;
+	void *ocr_ctx = acquire_ocr(pool->lang_index);
+
+	if (ocr_ctx && ocr_rect(ocr_ctx, job->rect, &str, job->bgcolor, job->quantmode) >= 0)
+		job->rect->ocr_text = str;
+	else
+		job->rect->ocr_text = NULL;
+	release_ocr(&ocr_ctx);
+}
+
+#ifndef _WIN32
+static void *ocr_worker_main(void *arg)
+{
+	struct ocr_worker *worker = arg;
+	struct ocrPool *pool = worker->pool;
+	struct ocr_job *job;
+
+	pthread_mutex_lock(&pool->lock);
+	for (;;)
+	{
+		while (!pool->head && !pool->quit)
+			pthread_cond_wait(&pool->job_ready, &pool->lock);
+		if (!pool->head)
+			break;
+
+		job = pool->head;
+		pool->head = job->next;
+		if (!pool->head)
+			pool->tail = NULL;
+		pthread_mutex_unlock(&pool->lock);
+
+		run_ocr_job(pool, job);
+		free(job);
+
+		pthread_mutex_lock(&pool->lock);
+		if (--pool->pending == 0)
+			pthread_cond_broadcast(&pool->all_done);
+	}
+	pthread_mutex_unlock(&pool->lock);
+	return NULL;
+}
+#endif
+
+static void start_ocr_pool(struct ocrPool *pool)
+{
+	pool->started = 1;
+#ifndef _WIN32
+	if (pool->nb_threads > 0)
+		pool->workers = (struct ocr_worker *)calloc(pool->nb_threads, sizeof(struct ocr_worker));
+	for (int i = 0; pool->workers && i < pool->nb_threads; i++)
+	{
+		struct ocr_worker *worker = &pool->workers[i];
+		worker->pool = pool;
+		if (pthread_create(&worker->thread, NULL, ocr_worker_main, worker))
+		{
+			mprint("Failed to start OCR thread %d\n", i);
+			break;
+		}
+		pool->nb_workers++;
+	}
+#endif
+}
+
+void *init_ocr_pool(int lang_index, int nb_threads)
+{
+	struct ocrPool *pool;
+
+	pool = (struct ocrPool *)malloc(sizeof(struct ocrPool));
+	if (!pool)
+		return NULL;
+	memset(pool, 0, sizeof(struct ocrPool));
+	pool->lang_index = lang_index;
+	pool->nb_threads = nb_threads;
+
+#ifndef _WIN32
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->job_ready, NULL);
+	pthread_cond_init(&pool->all_done, NULL);
+#endif
+	return pool;
+}
+
+void delete_ocr_pool(void **arg)
+{
+	struct ocrPool *pool = *arg;
+	if (!pool)
+		return;
+
+#ifndef _WIN32
+	pthread_mutex_lock(&pool->lock);
+	pool->quit = 1;
+	pthread_cond_broadcast(&pool->job_ready);
+	pthread_mutex_unlock(&pool->lock);
+	for (int i = 0; i < pool->nb_workers; i++)
+		pthread_join(pool->workers[i].thread, NULL);
+	pthread_mutex_destroy(&pool->lock);
+	pthread_cond_destroy(&pool->job_ready);
+	pthread_cond_destroy(&pool->all_done);
+#endif
+	freep(&pool->workers);
+	freep(arg);
+}
+
+int ocr_pool_submit(void *arg, struct cc_bitmap *rect, int bgcolor, int ocr_quantmode)
+{
+	struct ocrPool *pool = arg;
+	struct ocr_job job = {rect, bgcolor, ocr_quantmode, NULL};
+
+	rect->ocr_text = NULL;
+	if (!pool->started)
+		start_ocr_pool(pool);
+	if (pool->nb_workers == 0)
+	{
+		// No threads, OCR synchronously
+		run_ocr_job(pool, &job);
+		return 0;
+	}
+
+#ifndef _WIN32
+	struct ocr_job *queued = (struct ocr_job *)malloc(sizeof(struct ocr_job));
+	if (!queued)
+		return -1;
+	*queued = job;
+
+	pthread_mutex_lock(&pool->lock);
+	if (pool->tail)
+		pool->tail->next = queued;
+	else
+		pool->head = queued;
+	pool->tail = queued;
+	pool->pending++;
+	pthread_cond_signal(&pool->job_ready);
+	pthread_mutex_unlock(&pool->lock);
+#endif
+	return 0;
+}
+
+void ocr_pool_wait(void *arg)
+{
+#ifndef _WIN32
+	struct ocrPool *pool = arg;
+	if (!pool || pool->nb_workers == 0)
+		return;
+
+	pthread_mutex_lock(&pool->lock);
+	while (pool->pending)
+		pthread_cond_wait(&pool->all_done, &pool->lock);
+	pthread_mutex_unlock(&pool->lock);
+#endif
+}
+
 /**
  * Call back function used while sorting rectangle by y position
  * if both rectangle have same y position then x position is considered
@@ -15,8 +15,16 @@ struct image_copy //A copy of the original OCR image, used for color detection
 void delete_ocr (void** arg);
 char* probe_tessdata_location(const char *lang);
 void* init_ocr(int lang_index);
+void *acquire_ocr(int lang_index);
+void release_ocr(void **arg);
+void free_ocr_registry(void);
 char* ocr_bitmap(void* arg, png_color *palette,png_byte *alpha, unsigned char* indata,int w, int h, struct image_copy *copy);
 int ocr_rect(void* arg, struct cc_bitmap *rect, char **str, int bgcolor, int ocr_quantmode);
+void ocr_cache_stats(void *arg, unsigned int *hits, unsigned int *misses);
+void *init_ocr_pool(int lang_index, int nb_threads);
+void delete_ocr_pool(void **arg);
+int ocr_pool_submit(void *arg, struct cc_bitmap *rect, int bgcolor, int ocr_quantmode);
+void ocr_pool_wait(void *arg);
 char *paraof_ocrtext(struct cc_subtitle *sub, struct encoder_ctx *context);
 
 #endif
@@ -658,6 +658,10 @@ void print_usage(void)
 	mprint("                       stream will be processed. e.g. 'eng' for English.\n");
 	mprint("                       If there are multiple languages, only this specified\n");
 	mprint("                       language stream will be processed (default).\n");
+	mprint("                       Use 'all' to extract every DVB subtitle stream in a\n");
+	mprint("                       single pass. The first one goes to the usual output\n");
+	mprint("                       file, each of the others to a file named after its\n");
+	mprint("                       language, e.g. output_fre.srt.\n");
 	mprint("             --ocrlang: Manually select the name of the Tesseract .traineddata\n");
 	mprint("                       file. Helpful if you want to OCR a caption stream of\n");
 	mprint("                       one language with the data of another language.\n");
@@ -835,6 +839,8 @@ void print_usage(void)
 	mprint("          --tpage page: Use this page for subtitles (if this parameter\n");
 	mprint("                       is not used, try to autodetect). In Spain the\n");
 	mprint("                       page is always 888, may vary in other countries.\n");
+	mprint("                       Use --tpage all to extract every subtitle page in a\n");
+	mprint("                       single pass, each to its own output file.\n");
 	mprint("            --tverbose: Enable verbose mode in the teletext decoder.\n\n");
 	mprint("            --teletext: Force teletext mode even if teletext is not detected.\n");
 	mprint("                       If used, you should also pass --datapid to specify\n");
@@ -925,6 +931,34 @@ void print_usage(void)
 	mprint("                     Italic detection automatically enforces the OCR mode \n");
 	mprint("                     to be word-wise");
 	mprint("\n");
+	mprint("    --binary-search : Sample the video every --min-sub-duration seconds\n");
+	mprint("                     and bisect around changes of the subtitle area to\n");
+	mprint("                     find exact start and end frames, instead of\n");
+	mprint("                     running OCR on every second of the video.\n");
+	mprint("                     Much faster on long videos.\n");
+	mprint("\n");
+	mprint("          --roi-top : Top of the region searched for subtitles, as a\n");
+	mprint("                     percentage of the frame height. Only this region\n");
+	mprint("                     is converted and processed, so smaller regions are\n");
+	mprint("                     faster. Default is 75 (bottom quarter), or 92 with\n");
+	mprint("                     --tickertext.\n");
+	mprint("                     e.g. --roi-top 60\n");
+	mprint("\n");
+	mprint(" --hardsubx-threads : Number of threads running OCR in the linear and\n");
+	mprint("                     ticker text searches. Each one has its own\n");
+	mprint("                     Tesseract instance. 0 uses one per CPU core.\n");
+	mprint("                     Default is 1. The output does not depend on it.\n");
+	mprint("                     e.g. --hardsubx-threads 4\n");
+	mprint("\n");
+	mprint("      --skip-frames : Do not decode the frames the linear and ticker\n");
+	mprint("                     text searches do not need, so decoding costs\n");
+	mprint("                     depend on the sampling rate, not the frame rate.\n");
+	mprint("                     nonref skips frames no other frame depends on,\n");
+	mprint("                     nonkey only decodes key frames, which only\n");
+	mprint("                     works if they are closer than --min-sub-duration.\n");
+	mprint("                     e.g. --skip-frames none (default), --skip-frames nonref,\n");
+	mprint("                     --skip-frames nonkey\n");
+	mprint("\n");
 	mprint("      --conf-thresh : Specify the classifier confidence threshold between\n");
 	mprint("                      1 and 100.\n");
 	mprint("                     Try and use a threshold which works for you if you get \n");
@@ -1436,6 +1470,79 @@ int parse_parameters(struct ccx_s_options *opt, int argc, char *argv[])
 				opt->hardsubx_detect_italics = 1;
 				continue;
 			}
+			if (strcmp(argv[i], "--binary-search") == 0)
+			{
+				opt->hardsubx_binary_search = 1;
+				continue;
+			}
+			if (strcmp(argv[i], "--roi-top") == 0)
+			{
+				if (i < argc - 1)
+				{
+					i++;
+
+					opt->hardsubx_roi_top = atof(argv[i]);
+					if (opt->hardsubx_roi_top < 0.0 || opt->hardsubx_roi_top >= 100.0)
+					{
+						fatal(EXIT_MALFORMED_PARAMETER, "--roi-top has an invalid value supplied\nValid values are in [0.0,100.0)\n");
+					}
+
+					continue;
+				}
+				else
+				{
+					fatal(EXIT_MALFORMED_PARAMETER, "--roi-top has no argument.\n");
+				}
+			}
+			if (strcmp(argv[i], "--hardsubx-threads") == 0)
+			{
+				if (i < argc - 1)
+				{
+					i++;
+
+					opt->hardsubx_threads = atoi(argv[i]);
+					if (opt->hardsubx_threads < 0)
+					{
+						fatal(EXIT_MALFORMED_PARAMETER, "--hardsubx-threads has an invalid value supplied\n");
+					}
+
+					continue;
+				}
+				else
+				{
+					fatal(EXIT_MALFORMED_PARAMETER, "--hardsubx-threads has no argument.\n");
+				}
+			}
+			if (strcmp(argv[i], "--skip-frames") == 0)
+			{
+				if (i < argc - 1)
+				{
+					i++;
+
+					if (strcmp(argv[i], "none") == 0)
+					{
+						opt->hardsubx_skip_frames = HARDSUBX_SKIP_NONE;
+					}
+					else if (strcmp(argv[i], "nonref") == 0)
+					{
+						opt->hardsubx_skip_frames = HARDSUBX_SKIP_NONREF;
+					}
+					else if (strcmp(argv[i], "nonkey") == 0)
+					{
+						opt->hardsubx_skip_frames = HARDSUBX_SKIP_NONKEY;
+					}
+					else
+					{
+						fatal(EXIT_MALFORMED_PARAMETER, "--skip-frames has an invalid value.\nValid values are {none,nonref,nonkey}\n");
+					}
+
+					continue;
+				}
+				else
+				{
+					fatal(EXIT_MALFORMED_PARAMETER, "--skip-frames has no argument.\nValid values are {none,nonref,nonkey}\n");
+				}
+			}
 			if (strcmp(argv[i], "--conf-thresh") == 0)
 			{
 				if (i < argc - 1)
@@ -1653,6 +1760,12 @@ int parse_parameters(struct ccx_s_options *opt, int argc, char *argv[])
 			{
 				i++;
 
+				if (strcmp(argv[i], "all") == 0)
+				{
+					opt->dvb_all_streams = 1;
+					continue;
+				}
+
 				opt->dvblang = (char *)malloc(sizeof(argv[i]));
 				sprintf(opt->dvblang, "%s", argv[i]);
 				for (int char_index = 0; char_index < strlen(opt->dvblang); char_index++)
@@ -2468,6 +2581,11 @@ int parse_parameters(struct ccx_s_options *opt, int argc, char *argv[])
 			if (i < argc - 1)
 			{
 				i++;
+				if (strcmp(argv[i], "all") == 0)
+				{
+					tlt_config.all_pages = 1;
+					continue;
+				}
 				tlt_config.page = atoi_hex(argv[i]);
 				tlt_config.user_page = tlt_config.page;
 				continue;
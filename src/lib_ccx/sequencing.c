@@ -16,9 +16,38 @@ void init_hdcc(struct lib_cc_decode *ctx)
 		ctx->cc_fts[j] = 0;
 	}
 	memset(ctx->cc_data_pkts, 0, SORTBUF * (31 * 3 + 1));
+	ctx->cc_seq_filled_count = 0;
 	ctx->has_ccdata_buffered = 0;
 }
 
+// Like init_hdcc(), but only resets the slots that were filled since
+// the last flush.
+static void reset_hdcc(struct lib_cc_decode *ctx)
+{
+	for (int i = 0; i < ctx->cc_seq_filled_count; i++)
+	{
+		int seq = ctx->cc_seq_filled[i];
+		ctx->cc_data_count[seq] = 0;
+		ctx->cc_fts[seq] = 0;
+	}
+	ctx->cc_seq_filled_count = 0;
+	ctx->has_ccdata_buffered = 0;
+}
+
+// Remember that slot seq_index holds data, keeping the list sorted.
+// Usually only a handful of slots are filled between flushes.
+static void mark_hdcc_filled(struct lib_cc_decode *ctx, int seq_index)
+{
+	int i = ctx->cc_seq_filled_count;
+	while (i > 0 && ctx->cc_seq_filled[i - 1] > seq_index)
+	{
+		ctx->cc_seq_filled[i] = ctx->cc_seq_filled[i - 1];
+		i--;
+	}
+	ctx->cc_seq_filled[i] = seq_index;
+	ctx->cc_seq_filled_count++;
+}
+
 // Buffer caption blocks for later sorting/flushing.
 void store_hdcc(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, unsigned char *cc_data, int cc_count, int sequence_number, LLONG current_fts_now, struct cc_subtitle *sub)
 {
@@ -65,10 +94,14 @@ void store_hdcc(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, unsi
 					process_hdcc(enc_ctx, dec_ctx, sub);
 				}
 			}
+			if (dec_ctx->cc_data_count[seq_index] == 0)
+				mark_hdcc_filled(dec_ctx, seq_index);
 			dec_ctx->cc_fts[seq_index] = current_fts_now; // CFS: Maybe do even if there's no data?
 			dec_ctx->cc_data_count[seq_index] = 0;
 			memcpy(dec_ctx->cc_data_pkts[seq_index] + dec_ctx->cc_data_count[seq_index] * 3, cc_data, cc_count * 3 + 1);
 		}
+		else if (dec_ctx->cc_data_count[seq_index] == 0)
+			mark_hdcc_filled(dec_ctx, seq_index);
 		dec_ctx->cc_data_count[seq_index] += cc_count;
 	}
 	// DEBUG STUFF
@@ -98,8 +131,11 @@ void process_hdcc(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, st
 
 	dbg_print(CCX_DMT_VERBOSE, "Flush HD caption blocks\n");
 
-	for (int seq = 0; seq < SORTBUF; seq++)
+	// Only visit the filled slots. Empty slots have neither data nor
+	// fts, so skipping them does not change the reset_cb decision below.
+	for (int i = 0; i < dec_ctx->cc_seq_filled_count; i++)
 	{
+		int seq = dec_ctx->cc_seq_filled[i];
 
 		// We rely on this.
 		if (dec_ctx->in_bufferdatatype == CCX_H264)
@@ -146,5 +182,5 @@ void process_hdcc(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, st
 	dec_ctx->timing->fts_now = store_fts_now;
 
 	// Now that we are done, clean up.
-	init_hdcc(dec_ctx);
+	reset_hdcc(dec_ctx);
 }
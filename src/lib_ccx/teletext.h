@@ -17,6 +17,13 @@ typedef struct {
 	uint8_t tainted; // 1 = text variable contains any data
 } teletext_page_t;
 
+// current charset (charset can be -- and always is -- changed during transmission)
+struct s_primary_charset {
+	uint8_t current;
+	uint8_t g0_m29;
+	uint8_t g0_x28;
+};
+
 // application states -- flags for notices that should be printed only once
 struct s_states {
 	uint8_t programme_info_processed;
@@ -97,9 +104,23 @@ struct TeletextCtx
 	int64_t delta;
 	uint32_t t0;
 
+	// Charset state of the page being decoded; with --tpage all every page
+	// context has its own, as each page may use a different national subset
+	int de_ctr; // a keeps count of packets with flag subtitle ON and data packets
+	int default_g0_charset; // g0_charsets_type
+	struct s_primary_charset primary_charset;
+	uint16_t g0_latin[96]; // Latin G0 primary set with the national subset in use
+
 	int sentence_cap;//Set to 1 if -sc is passed
 	int new_sentence;
 	int splitbysentence;
+
+	// --tpage all: every subtitle page other than tlt_config.page gets its own context
+	// (with 'page' set) in the next_page list, decoding into its own subtitle and output.
+	struct TeletextCtx *next_page;
+	struct cc_subtitle page_sub;
+	struct encoder_ctx *page_enc;
+	struct encoder_ctx *enc_ctx; // Encoder of the main output, which the page outputs are named after
 };
 
 int tlt_print_seen_pages(struct lib_cc_decode *dec_ctx);
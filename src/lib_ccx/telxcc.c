@@ -49,7 +49,6 @@ int _CRT_fmode = _O_BINARY;
 #endif
 
 uint64_t last_pes_pts = 0; // PTS of last PES packet (debug purposes)
-static int de_ctr = 0;	   // a keeps count of packets with flag subtitle ON and data packets
 static const char *TTXT_COLOURS[8] = {
     // black,   red,       green,     yellow,    blue,      magenta,   cyan,      white
     "#000000", "#ff0000", "#00ff00", "#ffff00", "#0000ff", "#ff00ff", "#00ffff", "#ffffff"};
@@ -73,15 +72,6 @@ struct ccx_s_teletext_config tlt_config = {0};
 // macro -- output only when increased verbosity was turned on
 #define VERBOSE_ONLY if (tlt_config.verbose == YES)
 
-// current charset (charset can be -- and always is -- changed during transmission)
-struct s_primary_charset
-{
-	uint8_t current;
-	uint8_t g0_m29;
-	uint8_t g0_x28;
-} primary_charset = {
-    0x00, UNDEFINED, UNDEFINED};
-
 // entities, used in colour mode, to replace unsafe HTML tag chars
 struct
 {
@@ -119,14 +109,12 @@ typedef enum
 	HEBREW
 } g0_charsets_type;
 
-g0_charsets_type default_g0_charset;
-
 // Note: All characters are encoded in UCS-2
 
 // --- G0 ----------------------------------------------------------------------
 
-// G0 charsets
-uint16_t G0[5][96] = {
+// G0 charsets, the Latin one before any national subset is applied, see TeletextCtx.g0_latin
+const uint16_t G0[5][96] = {
     {// Latin G0 Primary Set
      0x0020, 0x0021, 0x0022, 0x00a3, 0x0024, 0x0025, 0x0026, 0x0027, 0x0028, 0x0029, 0x002a, 0x002b, 0x002c, 0x002d, 0x002e, 0x002f,
      0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037, 0x0038, 0x0039, 0x003a, 0x003b, 0x003c, 0x003d, 0x003e, 0x003f,
@@ -369,52 +357,50 @@ uint8_t unham_8_4(uint8_t a)
 // ETS 300 706, chapter 8.3
 uint32_t unham_24_18(uint32_t a)
 {
-	uint8_t test = 0;
-
 	// Tests A-F correspond to bits 0-6 respectively in 'test'.
-	for (uint8_t i = 0; i < 23; i++)
-		test ^= ((a >> i) & 0x01) * (i + 33);
-	// Only parity bit is tested for bit 24
-	test ^= ((a >> 23) & 0x01) * 32;
+	uint8_t test = UNHAM_24_18_PAR[0][a & 0xff] ^ UNHAM_24_18_PAR[1][(a >> 8) & 0xff] ^ UNHAM_24_18_PAR[2][(a >> 16) & 0xff];
+	uint32_t err = UNHAM_24_18_ERR[test];
 
-	if ((test & 0x1f) != 0x1f)
-	{
-		// Not all tests A-E correct
-		if ((test & 0x20) == 0x20)
-		{
-			// F correct: Double error
-			return 0xffffffff;
-		}
-		// Test F incorrect: Single error
-		a ^= 1 << (30 - test);
-	}
+	// Test F correct but not all tests A-E correct: Double error
+	if (err == 0xffffffff)
+		return 0xffffffff;
+	// Test F incorrect: Single error
+	a ^= err;
 
 	return (a & 0x000004) >> 2 | (a & 0x000070) >> 3 | (a & 0x007f00) >> 4 | (a & 0x7f0000) >> 5;
 }
 
+// Decodes count consecutive triplets of data (least significant byte first) into triplets.
+// Uncorrectable triplets are set to 0xffffffff, like unham_24_18().
+void unham_24_18_triplets(const uint8_t *data, uint32_t *triplets, int count)
+{
+	for (int j = 0; j < count; j++, data += 3)
+		triplets[j] = unham_24_18((data[2] << 16) | (data[1] << 8) | data[0]);
+}
+
 // Default G0 Character Set
-void set_g0_charset(uint32_t triplet)
+void set_g0_charset(struct TeletextCtx *ctx, uint32_t triplet)
 {
 	// ETS 300 706, Table 32
 	if ((triplet & 0x3c00) == 0x1000)
 	{
 		if ((triplet & 0x0380) == 0x0000)
-			default_g0_charset = CYRILLIC1;
+			ctx->default_g0_charset = CYRILLIC1;
 		else if ((triplet & 0x0380) == 0x0200)
-			default_g0_charset = CYRILLIC2;
+			ctx->default_g0_charset = CYRILLIC2;
 		else if ((triplet & 0x0380) == 0x0280)
-			default_g0_charset = CYRILLIC3;
+			ctx->default_g0_charset = CYRILLIC3;
 		else
-			default_g0_charset = LATIN;
+			ctx->default_g0_charset = LATIN;
 	}
 	else
-		default_g0_charset = LATIN;
+		ctx->default_g0_charset = LATIN;
 }
 
 // Latin National Subset Selection
-void remap_g0_charset(uint8_t c)
+void remap_g0_charset(struct TeletextCtx *ctx, uint8_t c)
 {
-	if (c != primary_charset.current)
+	if (c != ctx->primary_charset.current)
 	{
 		uint8_t m = G0_LATIN_NATIONAL_SUBSETS_MAP[c];
 		if (m == 0xff)
@@ -424,9 +410,9 @@ void remap_g0_charset(uint8_t c)
 		else
 		{
 			for (uint8_t j = 0; j < 13; j++)
-				G0[LATIN][G0_LATIN_NATIONAL_SUBSETS_POSITIONS[j]] = G0_LATIN_NATIONAL_SUBSETS[m].characters[j];
+				ctx->g0_latin[G0_LATIN_NATIONAL_SUBSETS_POSITIONS[j]] = G0_LATIN_NATIONAL_SUBSETS[m].characters[j];
 			VERBOSE_ONLY fprintf(stderr, "- Using G0 Latin National Subset ID 0x%1x.%1x (%s)\n", (c >> 3), (c & 0x7), G0_LATIN_NATIONAL_SUBSETS[m].language);
-			primary_charset.current = c;
+			ctx->primary_charset.current = c;
 		}
 	}
 }
@@ -456,7 +442,7 @@ void ucs2_to_utf8(char *r, uint16_t ch)
 }
 
 // check parity and translate any reasonable teletext character into ucs2
-uint16_t telx_to_ucs2(uint8_t c)
+uint16_t telx_to_ucs2(struct TeletextCtx *ctx, uint8_t c)
 {
 	if (PARITY_8[c] == 0)
 	{
@@ -465,8 +451,10 @@ uint16_t telx_to_ucs2(uint8_t c)
 	}
 
 	uint16_t r = c & 0x7f;
-	if (r >= 0x20)
-		r = G0[default_g0_charset][r - 0x20];
+	if (r >= 0x20 && ctx->default_g0_charset == LATIN)
+		r = ctx->g0_latin[r - 0x20];
+	else if (r >= 0x20)
+		r = G0[ctx->default_g0_charset][r - 0x20];
 	return r;
 }
 
@@ -510,13 +498,70 @@ void telx_case_fix(struct TeletextCtx *context)
 	telx_correct_case(context->page_buffer_cur);
 }
 
+// Page (BCD) decoded by ctx: its own page in --tpage all mode, the configured one otherwise
+static uint16_t tlt_page(struct TeletextCtx *ctx)
+{
+	return ctx->page ? ctx->page : tlt_config.page;
+}
+
+// --tpage all: start decoding page (BCD) in its own context, unless that is already done
+static void tlt_add_page(struct TeletextCtx *ctx, uint16_t page)
+{
+	struct TeletextCtx **last;
+
+	for (last = &ctx->next_page; *last; last = &(*last)->next_page)
+	{
+		if ((*last)->page == page)
+			return;
+	}
+
+	*last = telxcc_init();
+	if (!*last)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In tlt_add_page: Out of memory allocating teletext context.\n");
+	(*last)->page = page;
+	(*last)->sentence_cap = ctx->sentence_cap;
+	(*last)->enc_ctx = ctx->enc_ctx;
+	mprint("- Teletext page %03x will be extracted to its own output\n", page);
+}
+
+// --tpage all: write the output of a page context, to a file named after the main output
+static void tlt_encode_page(struct TeletextCtx *page_ctx)
+{
+	if (!page_ctx->page_sub.got_output)
+		return;
+
+	if (!page_ctx->page_enc)
+	{
+		struct encoder_cfg cfg = ccx_options.enc_cfg;
+		char suffix[8];
+
+		cfg.in_format = 2;
+		cfg.output_filename = NULL;
+		if (page_ctx->enc_ctx->out && page_ctx->enc_ctx->out[0].filename)
+		{
+			char *basefilename = get_basename(page_ctx->enc_ctx->out[0].filename);
+			snprintf(suffix, sizeof(suffix), "_p%03x", page_ctx->page);
+			cfg.output_filename = create_outfilename(basefilename, suffix, get_file_extension(cfg.write_format));
+			free(basefilename);
+		}
+		page_ctx->page_enc = init_encoder(&cfg);
+		free(cfg.output_filename);
+		if (!page_ctx->page_enc)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In tlt_encode_page: Out of memory allocating encoder.\n");
+		page_ctx->page_enc->timing = page_ctx->enc_ctx->timing;
+	}
+
+	encode_sub(page_ctx->page_enc, &page_ctx->page_sub);
+	page_ctx->page_sub.got_output = 0;
+}
+
 void telxcc_dump_prev_page(struct TeletextCtx *ctx, struct cc_subtitle *sub)
 {
 	char info[4];
 	if (!ctx->page_buffer_prev)
 		return;
 
-	snprintf(info, 4, "%.3u", bcd_page_to_int(tlt_config.page));
+	snprintf(info, 4, "%.3u", bcd_page_to_int(tlt_page(ctx)));
 	add_cc_sub_text(sub, ctx->page_buffer_prev, ctx->prev_show_timestamp,
 			ctx->prev_hide_timestamp, info, "TLT", CCX_ENC_UTF_8);
 
@@ -552,7 +597,8 @@ int fuzzy_memcmp(const char *c1, const char *c2, const uint64_t *ucs2_buf1, unsi
 		max = tlt_config.levdistmincnt;
 
 	// For the second string, only take the first chars (up to the first string length, that's upto).
-	l = (size_t)levenshtein_dist(ucs2_buf1, ucs2_buf2, ucs2_buf1_len, upto);
+	// Only whether the distance exceeds max matters, so the computation may stop early.
+	l = (size_t)levenshtein_dist_bounded(ucs2_buf1, ucs2_buf2, ucs2_buf1_len, upto, max);
 	int res = (l > max);
 	dbg_print(CCX_DMT_LEVENSHTEIN, "\rLEV | %s | %s | Max: %d | Calc: %d | Match: %d\n", c1, c2, max, l, !res);
 	return res;
@@ -889,7 +935,7 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 		uint8_t c;
 		ctx->cc_map[i] |= flag_subtitle << (m - 1);
 
-		if ((flag_subtitle == YES) && (i < 0xff))
+		if ((ctx->page == 0) && (flag_subtitle == YES) && (i < 0xff))
 		{
 			int thisp = (m << 8) | (unham_8_4(packet->data[1]) << 4) | unham_8_4(packet->data[0]);
 			char t1[10];
@@ -901,11 +947,17 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 				mprint("\rNotice: Teletext page with possible subtitles detected: %03d\n", thisp);
 			}
 		}
-		if ((tlt_config.page == 0) && (flag_subtitle == YES) && (i < 0xff))
+		if ((tlt_page(ctx) == 0) && (flag_subtitle == YES) && (i < 0xff))
 		{
 			tlt_config.page = (m << 8) | (unham_8_4(packet->data[1]) << 4) | unham_8_4(packet->data[0]);
 			mprint("- No teletext page specified, first received suitable page is %03x, not guaranteed\n", tlt_config.page);
 		}
+		if (tlt_config.all_pages && (ctx->page == 0) && ctx->enc_ctx && (flag_subtitle == YES) && (i < 0xff))
+		{
+			uint16_t thisp = (m << 8) | (unham_8_4(packet->data[1]) << 4) | unham_8_4(packet->data[0]);
+			if (thisp != tlt_config.page)
+				tlt_add_page(ctx, thisp);
+		}
 
 		// Page number and control bits
 		page_number = (m << 8) | (unham_8_4(packet->data[1]) << 4) | unham_8_4(packet->data[0]);
@@ -924,19 +976,19 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 		ctx->transmission_mode = (transmission_mode_t)(unham_8_4(packet->data[7]) & 0x01);
 
 		// FIXME: Well, this is not ETS 300 706 kosher, however we are interested in DATA_UNIT_EBU_TELETEXT_SUBTITLE only
-		if ((ctx->transmission_mode == TRANSMISSION_MODE_PARALLEL) && (data_unit_id != DATA_UNIT_EBU_TELETEXT_SUBTITLE) && !(de_ctr && flag_subtitle && ctx->receiving_data == YES))
+		if ((ctx->transmission_mode == TRANSMISSION_MODE_PARALLEL) && (data_unit_id != DATA_UNIT_EBU_TELETEXT_SUBTITLE) && !(ctx->de_ctr && flag_subtitle && ctx->receiving_data == YES))
 			return;
 
-		if ((ctx->receiving_data == YES) && (((ctx->transmission_mode == TRANSMISSION_MODE_SERIAL) && (PAGE(page_number) != PAGE(tlt_config.page))) ||
-						     ((ctx->transmission_mode == TRANSMISSION_MODE_PARALLEL) && (PAGE(page_number) != PAGE(tlt_config.page)) && (m == MAGAZINE(tlt_config.page)))))
+		if ((ctx->receiving_data == YES) && (((ctx->transmission_mode == TRANSMISSION_MODE_SERIAL) && (PAGE(page_number) != PAGE(tlt_page(ctx)))) ||
+						     ((ctx->transmission_mode == TRANSMISSION_MODE_PARALLEL) && (PAGE(page_number) != PAGE(tlt_page(ctx))) && (m == MAGAZINE(tlt_page(ctx))))))
 		{
 			ctx->receiving_data = NO;
-			if (!(de_ctr && flag_subtitle))
+			if (!(ctx->de_ctr && flag_subtitle))
 				return;
 		}
 
 		// Page transmission is terminated, however now we are waiting for our new page
-		if (page_number != tlt_config.page && !(de_ctr && flag_subtitle && ctx->receiving_data == YES))
+		if (page_number != tlt_page(ctx) && !(ctx->de_ctr && flag_subtitle && ctx->receiving_data == YES))
 			return;
 
 		// Now we have the begining of page transmission; if there is page_buffer pending, process it
@@ -948,7 +1000,7 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 				for (uint8_t it = 0; it < 40; it++)
 				{
 					if (ctx->page_buffer.text[yt][it] != 0x00 && ctx->page_buffer.g2_char_present[yt][it] == 0)
-						ctx->page_buffer.text[yt][it] = telx_to_ucs2(ctx->page_buffer.text[yt][it]);
+						ctx->page_buffer.text[yt][it] = telx_to_ucs2(ctx, ctx->page_buffer.text[yt][it]);
 				}
 			}
 			// it would be nice, if subtitle hides on previous video frame, so we contract 40 ms (1 frame @25 fps)
@@ -958,7 +1010,7 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 				ctx->page_buffer.hide_timestamp = 0;
 			}
 			process_page(ctx, &ctx->page_buffer, sub);
-			de_ctr = 0;
+			ctx->de_ctr = 0;
 		}
 
 		ctx->page_buffer.show_timestamp = timestamp;
@@ -967,11 +1019,11 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 		memset(ctx->page_buffer.g2_char_present, 0x00, sizeof(ctx->page_buffer.g2_char_present));
 		ctx->page_buffer.tainted = NO;
 		ctx->receiving_data = YES;
-		if (default_g0_charset == LATIN) // G0 Character National Option Sub-sets selection required only for Latin Character Sets
+		if (ctx->default_g0_charset == LATIN) // G0 Character National Option Sub-sets selection required only for Latin Character Sets
 		{
-			primary_charset.g0_x28 = UNDEFINED;
-			c = (primary_charset.g0_m29 != UNDEFINED) ? primary_charset.g0_m29 : charset;
-			remap_g0_charset(c);
+			ctx->primary_charset.g0_x28 = UNDEFINED;
+			c = (ctx->primary_charset.g0_m29 != UNDEFINED) ? ctx->primary_charset.g0_m29 : charset;
+			remap_g0_charset(ctx, c);
 		}
 		/*
 		// I know -- not needed; in subtitles we will never need disturbing teletext page status bar
@@ -982,7 +1034,7 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 		}
 		*/
 	}
-	else if ((m == MAGAZINE(tlt_config.page)) && (y >= 1) && (y <= 23) && (ctx->receiving_data == YES))
+	else if ((m == MAGAZINE(tlt_page(ctx))) && (y >= 1) && (y <= 23) && (ctx->receiving_data == YES))
 	{
 		// ETS 300 706, chapter 9.4.1: Packets X/26 at presentation Levels 1.5, 2.5, 3.5 are used for addressing
 		// a character location and overwriting the existing character defined on the Level 1 page
@@ -995,17 +1047,16 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 				ctx->page_buffer.text[y][i] = packet->data[i];
 		}
 		ctx->page_buffer.tainted = YES;
-		--de_ctr;
+		--ctx->de_ctr;
 	}
-	else if ((m == MAGAZINE(tlt_config.page)) && (y == 26) && (ctx->receiving_data == YES))
+	else if ((m == MAGAZINE(tlt_page(ctx))) && (y == 26) && (ctx->receiving_data == YES))
 	{
 		// ETS 300 706, chapter 12.3.2: X/26 definition
 		uint8_t x26_row = 0;
 		uint8_t x26_col = 0;
 
-		uint32_t triplets[13] = {0};
-		for (uint8_t i = 1, j = 0; i < 40; i += 3, j++)
-			triplets[j] = unham_24_18((packet->data[i + 2] << 16) | (packet->data[i + 1] << 8) | packet->data[i]);
+		uint32_t triplets[13];
+		unham_24_18_triplets(packet->data + 1, triplets, 13);
 
 		for (uint8_t j = 0; j < 13; j++)
 		{
@@ -1055,7 +1106,7 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 				x26_col = address;
 				if (data == 64) // check for @ symbol
 				{
-					remap_g0_charset(0);
+					remap_g0_charset(ctx, 0);
 					ctx->page_buffer.text[x26_row][x26_col] = 0x40;
 				}
 			}
@@ -1073,13 +1124,13 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 					ctx->page_buffer.text[x26_row][x26_col] = G2_ACCENTS[mode - 0x11][data - 71];
 				// other
 				else
-					ctx->page_buffer.text[x26_row][x26_col] = telx_to_ucs2(data);
+					ctx->page_buffer.text[x26_row][x26_col] = telx_to_ucs2(ctx, data);
 
 				ctx->page_buffer.g2_char_present[x26_row][x26_col] = 1;
 			}
 		}
 	}
-	else if ((m == MAGAZINE(tlt_config.page)) && (y == 28) && (ctx->receiving_data == YES))
+	else if ((m == MAGAZINE(tlt_page(ctx))) && (y == 28) && (ctx->receiving_data == YES))
 	{
 		// TODO:
 		//   ETS 300 706, chapter 9.4.7: Packet X/28/4
@@ -1101,17 +1152,17 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 				if ((triplet0 & 0x0f) == 0x00)
 				{
 					// ETS 300 706, Table 32
-					set_g0_charset(triplet0); // Deciding G0 Character Set
-					if (default_g0_charset == LATIN)
+					set_g0_charset(ctx, triplet0); // Deciding G0 Character Set
+					if (ctx->default_g0_charset == LATIN)
 					{
-						primary_charset.g0_x28 = (triplet0 & 0x3f80) >> 7;
-						remap_g0_charset(primary_charset.g0_x28);
+						ctx->primary_charset.g0_x28 = (triplet0 & 0x3f80) >> 7;
+						remap_g0_charset(ctx, ctx->primary_charset.g0_x28);
 					}
 				}
 			}
 		}
 	}
-	else if ((m == MAGAZINE(tlt_config.page)) && (y == 29))
+	else if ((m == MAGAZINE(tlt_page(ctx))) && (y == 29))
 	{
 		// TODO:
 		//   ETS 300 706, chapter 9.5.1 Packet M/29/0
@@ -1133,21 +1184,21 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 				// ETS 300 706, table 13: Coding of Packet M/29/4
 				if ((triplet0 & 0xff) == 0x00)
 				{
-					set_g0_charset(triplet0);
-					if (default_g0_charset == LATIN)
+					set_g0_charset(ctx, triplet0);
+					if (ctx->default_g0_charset == LATIN)
 					{
-						primary_charset.g0_m29 = (triplet0 & 0x3f80) >> 7;
+						ctx->primary_charset.g0_m29 = (triplet0 & 0x3f80) >> 7;
 						// X/28 takes precedence over M/29
-						if (primary_charset.g0_x28 == UNDEFINED)
+						if (ctx->primary_charset.g0_x28 == UNDEFINED)
 						{
-							remap_g0_charset(primary_charset.g0_m29);
+							remap_g0_charset(ctx, ctx->primary_charset.g0_m29);
 						}
 					}
 				}
 			}
 		}
 	}
-	else if ((m == 8) && (y == 30))
+	else if ((m == 8) && (y == 30) && (ctx->page == 0))
 	{
 		// ETS 300 706, chapter 9.8: Broadcast Service Data Packets
 		if (ctx->states.programme_info_processed == NO)
@@ -1161,7 +1212,7 @@ void process_telx_packet(struct TeletextCtx *ctx, data_unit_t data_unit_id, tele
 				for (uint8_t i = 20; i < 40; i++)
 				{
 					char u[4] = {0, 0, 0, 0};
-					uint8_t c = telx_to_ucs2(packet->data[i]);
+					uint8_t c = telx_to_ucs2(ctx, packet->data[i]);
 					// strip any control codes from PID, eg. TVP station
 					if (c < 0x20)
 						continue;
@@ -1278,7 +1329,7 @@ void set_tlt_delta(struct lib_cc_decode *dec_ctx, uint64_t pts)
 		}
 	}
 }
-int tlt_process_pes_packet(struct lib_cc_decode *dec_ctx, uint8_t *buffer, uint16_t size, struct cc_subtitle *sub, int sentence_cap)
+int tlt_process_pes_packet(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, uint8_t *buffer, uint16_t size, struct cc_subtitle *sub)
 {
 	uint64_t pes_prefix;
 	uint8_t pes_stream_id;
@@ -1302,13 +1353,14 @@ int tlt_process_pes_packet(struct lib_cc_decode *dec_ctx, uint8_t *buffer, uint1
 	uint32_t t = 0;
 	uint16_t i;
 	struct TeletextCtx *ctx = dec_ctx->private_data;
-	ctx->sentence_cap = sentence_cap;
 
 	if (!ctx)
 	{
 		mprint("Teletext: Context cant be NULL, use telxcc_init\n");
 		return CCX_EINVAL;
 	}
+	ctx->sentence_cap = enc_ctx->sentence_cap;
+	ctx->enc_ctx = enc_ctx;
 
 	ctx->tlt_packet_counter++;
 	if (size < 6)
@@ -1482,6 +1534,13 @@ int tlt_process_pes_packet(struct lib_cc_decode *dec_ctx, uint8_t *buffer, uint1
 				{
 					// FIXME: This explicit type conversion could be a problem some day -- do not need to be platform independent
 					process_telx_packet(ctx, (data_unit_t)data_unit_id, (teletext_packet_payload_t *)&buffer[i], ctx->last_timestamp, sub);
+					// --tpage all: the other subtitle pages are decoded from the same packets
+					for (struct TeletextCtx *page_ctx = ctx->next_page; page_ctx; page_ctx = page_ctx->next_page)
+					{
+						page_ctx->tlt_packet_counter++;
+						process_telx_packet(page_ctx, (data_unit_t)data_unit_id, (teletext_packet_payload_t *)&buffer[i], ctx->last_timestamp, &page_ctx->page_sub);
+						tlt_encode_page(page_ctx);
+					}
 				}
 			}
 		}
@@ -1533,6 +1592,19 @@ void *telxcc_init(void)
 	ctx->new_sentence = 0;
 	ctx->splitbysentence = 0;
 
+	ctx->de_ctr = 0;
+	ctx->default_g0_charset = LATIN;
+	ctx->primary_charset.current = 0x00;
+	ctx->primary_charset.g0_m29 = UNDEFINED;
+	ctx->primary_charset.g0_x28 = UNDEFINED;
+	memcpy(ctx->g0_latin, G0[LATIN], sizeof(ctx->g0_latin));
+
+	ctx->page = 0;
+	ctx->next_page = NULL;
+	memset(&ctx->page_sub, 0, sizeof(struct cc_subtitle));
+	ctx->page_enc = NULL;
+	ctx->enc_ctx = NULL;
+
 	return ctx;
 }
 
@@ -1550,7 +1622,19 @@ void telxcc_close(void **ctx, struct cc_subtitle *sub)
 	if (!ttext)
 		return;
 
-	mprint("\nTeletext decoder: %" PRIu32 " packets processed \n", ttext->tlt_packet_counter);
+	// --tpage all: flush the other pages to their own outputs
+	while (ttext->next_page)
+	{
+		struct TeletextCtx *page_ctx = ttext->next_page;
+
+		ttext->next_page = page_ctx->next_page;
+		page_ctx->next_page = NULL;
+		page_ctx->last_timestamp = ttext->last_timestamp;
+		telxcc_close((void **)&page_ctx, &page_ctx->page_sub);
+	}
+
+	if (ttext->page == 0)
+		mprint("\nTeletext decoder: %" PRIu32 " packets processed \n", ttext->tlt_packet_counter);
 	if (tlt_config.write_format != CCX_OF_RCWT && sub)
 	{
 		// output any pending close caption
@@ -1562,7 +1646,7 @@ void telxcc_close(void **ctx, struct cc_subtitle *sub)
 				for (uint8_t it = 0; it < 40; it++)
 				{
 					if (ttext->page_buffer.text[yt][it] != 0x00 && ttext->page_buffer.g2_char_present[yt][it] == 0)
-						ttext->page_buffer.text[yt][it] = telx_to_ucs2(ttext->page_buffer.text[yt][it]);
+						ttext->page_buffer.text[yt][it] = telx_to_ucs2(ttext, ttext->page_buffer.text[yt][it]);
 				}
 			}
 			// this time we do not subtract any frames, there will be no more frames
@@ -1572,6 +1656,11 @@ void telxcc_close(void **ctx, struct cc_subtitle *sub)
 
 		telxcc_dump_prev_page(ttext, sub);
 	}
+	if (ttext->page)
+	{
+		tlt_encode_page(ttext);
+		dinit_encoder(&ttext->page_enc, ttext->last_timestamp);
+	}
 	freep(&ttext->ucs2_buffer_cur);
 	freep(&ttext->page_buffer_cur);
 	freep(ctx);
@@ -40,9 +40,13 @@ int need_cap_info(struct ccx_demuxer *ctx, int program_number)
 void ignore_other_stream(struct ccx_demuxer *ctx, int pid)
 {
 	struct cap_info *iter;
+	struct cap_info *best = get_cinfo(ctx, pid);
+	// With --dvblang all the other DVB streams are decoded alongside the best one
+	int keep_dvb = ccx_options.dvb_all_streams && best && best->codec == CCX_CODEC_DVB;
+
 	list_for_each_entry(iter, &ctx->cinfo_tree.all_stream, all_stream, struct cap_info)
 	{
-		if (iter->pid != pid)
+		if (iter->pid != pid && !(keep_dvb && iter->codec == CCX_CODEC_DVB))
 			iter->ignore = 1;
 	}
 }
@@ -171,7 +175,7 @@ static void *init_private_data(enum ccx_code_type codec)
 		case CCX_CODEC_TELETEXT:
 			return telxcc_init();
 		case CCX_CODEC_DVB:
-			return dvbsub_init_decoder(NULL, 0);
+			return dvbsub_init_decoder(NULL);
 		default:
 			return NULL;
 	}
@@ -13,6 +13,8 @@ volatile sig_atomic_t change_filename_requested = 0;
 extern int ccxr_verify_crc32(uint8_t *buf, int len);
 extern int ccxr_levenshtein_dist(const uint64_t *s1, const uint64_t *s2, unsigned s1len, unsigned s2len);
 extern int ccxr_levenshtein_dist_char(const char *s1, const char *s2, unsigned s1len, unsigned s2len);
+extern int ccxr_levenshtein_dist_bounded(const uint64_t *s1, const uint64_t *s2, unsigned s1len, unsigned s2len, unsigned max);
+extern int ccxr_levenshtein_dist_char_bounded(const char *s1, const char *s2, unsigned s1len, unsigned s2len, unsigned max);
 extern void ccxr_timestamp_to_srttime(uint64_t timestamp, char *buffer);
 extern void ccxr_timestamp_to_vtttime(uint64_t timestamp, char *buffer);
 extern void ccxr_millis_to_date(uint64_t timestamp, char *buffer, enum ccx_output_date_format date_format, char millis_separator);
@@ -98,6 +100,18 @@ int verify_crc32(uint8_t *buf, int len)
 	return crc ? CCX_FALSE : CCX_TRUE;
 }
 
+/**
+ * Continue a 64-bit FNV-1a hash over len bytes of data.
+ * Start a new hash with FNV1A_64_INIT.
+ */
+uint64_t fnv1a_64(uint64_t hash, const void *data, size_t len)
+{
+	const uint8_t *p = data;
+	for (size_t i = 0; i < len; i++)
+		hash = (hash ^ p[i]) * 0x100000001b3ULL;
+	return hash;
+}
+
 int stringztoms(const char *s, struct ccx_boundary_time *bt)
 {
 #ifndef DISABLE_RUST
@@ -224,6 +238,27 @@ int levenshtein_dist_char(const char *s1, const char *s2, unsigned s1len, unsign
 	return v;
 }
 
+// Same as levenshtein_dist(), but may stop as soon as the distance is known to be
+// greater than max. Returns the distance if it is at most max, max + 1 otherwise.
+int levenshtein_dist_bounded(const uint64_t *s1, const uint64_t *s2, unsigned s1len, unsigned s2len, unsigned max)
+{
+#ifndef DISABLE_RUST
+	return ccxr_levenshtein_dist_bounded(s1, s2, s1len, s2len, max);
+#endif
+	unsigned v = levenshtein_dist(s1, s2, s1len, s2len);
+	return v > max ? max + 1 : v;
+}
+
+// Same as levenshtein_dist_char(), see levenshtein_dist_bounded().
+int levenshtein_dist_char_bounded(const char *s1, const char *s2, unsigned s1len, unsigned s2len, unsigned max)
+{
+#ifndef DISABLE_RUST
+	return ccxr_levenshtein_dist_char_bounded(s1, s2, s1len, s2len, max);
+#endif
+	unsigned v = levenshtein_dist_char(s1, s2, s1len, s2len);
+	return v > max ? max + 1 : v;
+}
+
 void millis_to_date(uint64_t timestamp, char *buffer, enum ccx_output_date_format date_format, char millis_separator)
 {
 #ifndef DISABLE_RUST
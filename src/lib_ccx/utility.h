@@ -30,6 +30,8 @@ volatile extern sig_atomic_t change_filename_requested;
 extern int ccxr_verify_crc32(uint8_t *buf, int len);
 extern int ccxr_levenshtein_dist(const uint64_t *s1, const uint64_t *s2, unsigned s1len, unsigned s2len);
 extern int ccxr_levenshtein_dist_char(const char *s1, const char *s2, unsigned s1len, unsigned s2len);
+extern int ccxr_levenshtein_dist_bounded(const uint64_t *s1, const uint64_t *s2, unsigned s1len, unsigned s2len, unsigned max);
+extern int ccxr_levenshtein_dist_char_bounded(const char *s1, const char *s2, unsigned s1len, unsigned s2len, unsigned max);
 extern void ccxr_timestamp_to_srttime(uint64_t timestamp, char *buffer);
 extern void ccxr_timestamp_to_vtttime(uint64_t timestamp, char *buffer);
 extern void ccxr_millis_to_date(uint64_t timestamp, char *buffer, enum ccx_output_date_format date_format, char millis_separator);
@@ -37,6 +39,7 @@ extern int ccxr_stringztoms(const char *s, struct ccx_boundary_time *bt);
 #endif
 
 int levenshtein_dist_char (const char *s1, const char *s2, unsigned s1len, unsigned s2len);
+int levenshtein_dist_char_bounded (const char *s1, const char *s2, unsigned s1len, unsigned s2len, unsigned max);
 void init_boundary_time (struct ccx_boundary_time *bt);
 void print_error (int mode, const char *fmt, ...);
 int stringztoms (const char *s, struct ccx_boundary_time *bt);
@@ -44,6 +47,8 @@ char *get_basename(char *filename);
 const char *get_file_extension(const enum ccx_output_format write_format);
 char *create_outfilename(const char *basename, const char *suffix, const char *extension);
 int verify_crc32(uint8_t *buf, int len);
+#define FNV1A_64_INIT 0xcbf29ce484222325ULL
+uint64_t fnv1a_64(uint64_t hash, const void *data, size_t len);
 size_t utf16_to_utf8(unsigned short utf16_char, unsigned char *out);
 LLONG change_timebase(LLONG val, struct ccx_rational cur_tb, struct ccx_rational dest_tb);
 char *str_reallocncat(char *dst, char *src);
@@ -5,7 +5,7 @@ use std::path::PathBuf;
 use crate::common::{
     DataSource, Language, OutputFormat, SelectCodec, StreamMode, StreamType, DTVCC_MAX_SERVICES,
 };
-use crate::hardsubx::{ColorHue, OcrMode};
+use crate::hardsubx::{ColorHue, OcrMode, SkipFrames};
 use crate::time::units::{Timestamp, TimestampFormat};
 use crate::util::encoding::Encoding;
 use crate::util::log::{DebugMessageFlag, DebugMessageMask, OutputTarget};
@@ -451,6 +451,8 @@ pub struct Options {
     pub hardsubx_and_common: bool,
     /// The name of the language stream for DVB
     pub dvblang: Option<Language>,
+    /// true if every DVB subtitle stream is to be extracted, each to its own output
+    pub dvb_all_streams: bool,
     /// The name of the .traineddata file to be loaded with tesseract
     pub ocrlang: PathBuf,
     /// The Tesseract OEM mode, could be 0 (default), 1 or 2
@@ -470,6 +472,12 @@ pub struct Options {
     pub hardsubx_ocr_mode: OcrMode,
     pub hardsubx_min_sub_duration: Timestamp,
     pub hardsubx_detect_italics: bool,
+    pub hardsubx_binary_search: bool,
+    /// Top of the subtitle region in percent of the frame height, if not the default
+    pub hardsubx_roi_top: Option<f64>,
+    /// Threads running OCR for burned-in subtitles, 0 for one per CPU core
+    pub hardsubx_threads: u32,
+    pub hardsubx_skip_frames: SkipFrames,
     pub hardsubx_conf_thresh: f64,
     pub hardsubx_hue: ColorHue,
     pub hardsubx_lum_thresh: f64,
@@ -589,6 +597,7 @@ impl Default for Options {
             hardsubx: Default::default(),
             hardsubx_and_common: Default::default(),
             dvblang: Default::default(),
+            dvb_all_streams: Default::default(),
             ocrlang: Default::default(),
             ocr_oem: -1,
             psm: 3,
@@ -598,6 +607,10 @@ impl Default for Options {
             hardsubx_ocr_mode: Default::default(),
             hardsubx_min_sub_duration: Timestamp::from_millis(500),
             hardsubx_detect_italics: Default::default(),
+            hardsubx_binary_search: Default::default(),
+            hardsubx_roi_top: Default::default(),
+            hardsubx_threads: 1,
+            hardsubx_skip_frames: Default::default(),
             hardsubx_conf_thresh: Default::default(),
             hardsubx_hue: Default::default(),
             hardsubx_lum_thresh: 95.0,
@@ -6,6 +6,17 @@ pub enum OcrMode {
     Letter = 2,
 }
 
+/// Frames the decoder may drop in the linear and ticker text searches.
+#[derive(Default, Debug, Clone, Copy)]
+pub enum SkipFrames {
+    #[default]
+    None = 0,
+    /// Frames no other frame is predicted from
+    NonRef = 1,
+    /// Everything but key frames
+    NonKey = 2,
+}
+
 #[derive(Default, Debug, Clone, Copy)]
 pub enum ColorHue {
     #[default]
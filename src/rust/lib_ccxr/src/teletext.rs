@@ -40,10 +40,12 @@ use std::sync::RwLock;
 use crate::common::OutputFormat;
 use crate::subtitle::Subtitle;
 use crate::time::units::{Timestamp, TimestampFormat};
-use crate::util::bits::{decode_hamming_24_18, decode_hamming_8_4, get_parity};
+use crate::util::bits::{
+    decode_hamming_24_18, decode_hamming_24_18_triplets, decode_hamming_8_4, get_parity,
+};
 use crate::util::encoders_helper::telx_correct_case;
 use crate::util::encoding::{Ucs2Char, Ucs2String};
-use crate::util::levenshtein::levenshtein;
+use crate::util::levenshtein::levenshtein_bounded;
 use crate::util::log::{debug, info, logger, DebugMessageFlag};
 
 /// UTC referential value.
@@ -730,6 +732,8 @@ pub struct TeletextConfig {
     pub page: Cell<TeletextPageNumber>,
     /// Page selected by user, which MIGHT be different to `page` depending on autodetection stuff
     pub user_page: u16,
+    /// Also extract every other subtitle page in the same pass
+    pub all_pages: bool,
     /// false = Don't attempt to correct errors
     pub dolevdist: bool,
     /// Means 2 fails or less is "the same"
@@ -755,6 +759,7 @@ impl Default for TeletextConfig {
             verbose: true,
             page: TeletextPageNumber(0).into(),
             user_page: 0,
+            all_pages: false,
             dolevdist: false,
             levdistmincnt: 0,
             levdistmaxpct: 0,
@@ -832,6 +837,14 @@ pub struct TeletextContext<'a> {
     g0_charset: G0Charset,
 
     de_ctr: i32, // a keeps count of packets with flag subtitle ON and data packets
+
+    // Page decoded by this context if it is not `config.page`
+    page: Option<TeletextPageNumber>,
+    // Contexts decoding every other subtitle page when `config.all_pages` is set
+    other_pages: Vec<TeletextContext<'a>>,
+    // Subtitles extracted by this context if it is one of `other_pages`, kept
+    // apart so every page can be written to its own output
+    page_subtitles: Vec<Subtitle>,
 }
 
 impl<'a> TeletextContext<'a> {
@@ -870,9 +883,33 @@ impl<'a> TeletextContext<'a> {
             new_sentence: false,
             g0_charset: G0Charset::new(config.verbose),
             de_ctr: 0,
+            page: None,
+            other_pages: Vec::new(),
+            page_subtitles: Vec::new(),
         }
     }
 
+    /// Returns the page decoded by this context.
+    fn page(&self) -> TeletextPageNumber {
+        self.page.unwrap_or_else(|| self.config.page.get())
+    }
+
+    /// Starts decoding `page` in its own context, unless that is already done.
+    fn add_page(&mut self, page: TeletextPageNumber) {
+        if self.other_pages.iter().any(|ctx| ctx.page == Some(page)) {
+            return;
+        }
+
+        let mut ctx = TeletextContext::new(self.config);
+        ctx.page = Some(page);
+        ctx.sentence_cap = self.sentence_cap;
+        info!(
+            "- Teletext page {} will be extracted in the same pass\n",
+            page
+        );
+        self.other_pages.push(ctx);
+    }
+
     /// Fix the case for the sentences stored in `page_buffer_cur`.
     ///
     /// This method will convert the first character of a sentence to uppercase and the rest of the
@@ -931,7 +968,7 @@ impl<'a> TeletextContext<'a> {
             page_buffer_prev.into(),
             self.prev_show_timestamp,
             self.prev_hide_timestamp,
-            Some(format!("{:03}", self.config.page.get().bcd_page_to_u16())),
+            Some(format!("{:03}", self.page().bcd_page_to_u16())),
             "TLT".into(),
         ))
     }
@@ -1230,6 +1267,9 @@ impl<'a> TeletextContext<'a> {
     }
 
     /// Process the teletext `packet` and append the extracted subtitles in `subtitles`.
+    ///
+    /// If [`TeletextConfig::all_pages`] is set, every other subtitle page is extracted too,
+    /// each into a list of its own. See [`TeletextContext::take_page_subtitles`].
     pub fn process_telx_packet(
         &mut self,
         data_unit: DataUnit,
@@ -1237,6 +1277,41 @@ impl<'a> TeletextContext<'a> {
         timestamp: Timestamp,
         subtitles: &mut Vec<Subtitle>,
         capitalization_list: &[String],
+    ) {
+        self.decode_telx_packet(data_unit, packet, timestamp, subtitles, capitalization_list);
+
+        // The other subtitle pages are decoded from the same packets
+        for ctx in self.other_pages.iter_mut() {
+            let mut page_subtitles = std::mem::take(&mut ctx.page_subtitles);
+            ctx.tlt_packet_counter += 1;
+            ctx.decode_telx_packet(
+                data_unit,
+                packet,
+                timestamp,
+                &mut page_subtitles,
+                capitalization_list,
+            );
+            ctx.page_subtitles = page_subtitles;
+        }
+    }
+
+    /// Takes the subtitles extracted so far from the pages other than
+    /// [`TeletextConfig::page`], for the caller to write each page to its own output.
+    pub fn take_page_subtitles(&mut self) -> Vec<(TeletextPageNumber, Vec<Subtitle>)> {
+        self.other_pages
+            .iter_mut()
+            .filter(|ctx| !ctx.page_subtitles.is_empty())
+            .map(|ctx| (ctx.page(), std::mem::take(&mut ctx.page_subtitles)))
+            .collect()
+    }
+
+    fn decode_telx_packet(
+        &mut self,
+        data_unit: DataUnit,
+        packet: &TeletextPacketPayload,
+        timestamp: Timestamp,
+        subtitles: &mut Vec<Subtitle>,
+        capitalization_list: &[String],
     ) {
         // variable names conform to ETS 300 706, chapter 7.1.2
         let address = (decode_hamming_8_4(packet.address[1]).unwrap() << 4)
@@ -1261,7 +1336,7 @@ impl<'a> TeletextContext<'a> {
 
             let flag_subtitle = flag_subtitle != 0;
 
-            if flag_subtitle && (i < 0xff) {
+            if self.page.is_none() && flag_subtitle && (i < 0xff) {
                 let mut thisp = ((m as u32) << 8)
                     | ((decode_hamming_8_4(packet.data[1]).unwrap() as u32) << 4)
                     | (decode_hamming_8_4(packet.data[0]).unwrap() as u32);
@@ -1275,7 +1350,7 @@ impl<'a> TeletextContext<'a> {
                     );
                 }
             }
-            if (self.config.page.get() == 0.into()) && flag_subtitle && (i < 0xff) {
+            if (self.page() == 0.into()) && flag_subtitle && (i < 0xff) {
                 self.config.page.replace(
                     (((m as u16) << 8)
                         | ((decode_hamming_8_4(packet.data[1]).unwrap() as u16) << 4)
@@ -1284,6 +1359,15 @@ impl<'a> TeletextContext<'a> {
                 );
                 info!("- No teletext page specified, first received suitable page is {}, not guaranteed\n", self.config.page.get());
             }
+            if self.config.all_pages && self.page.is_none() && flag_subtitle && (i < 0xff) {
+                let thisp: TeletextPageNumber = (((m as u16) << 8)
+                    | ((decode_hamming_8_4(packet.data[1]).unwrap() as u16) << 4)
+                    | (decode_hamming_8_4(packet.data[0]).unwrap() as u16))
+                    .into();
+                if thisp != self.config.page.get() {
+                    self.add_page(thisp);
+                }
+            }
 
             // Page number and control bits
             let page_number: TeletextPageNumber = (((m as u16) << 8)
@@ -1321,10 +1405,10 @@ impl<'a> TeletextContext<'a> {
 
             if self.receiving_data
                 && (((self.transmission_mode == TransmissionMode::Serial)
-                    && (page_number.page() != self.config.page.get().page()))
+                    && (page_number.page() != self.page().page()))
                     || ((self.transmission_mode == TransmissionMode::Parallel)
-                        && (page_number.page() != self.config.page.get().page())
-                        && (m == self.config.page.get().magazine())))
+                        && (page_number.page() != self.page().page())
+                        && (m == self.page().magazine())))
             {
                 self.receiving_data = false;
                 if !(self.de_ctr != 0 && flag_subtitle) {
@@ -1333,7 +1417,7 @@ impl<'a> TeletextContext<'a> {
             }
 
             // Page transmission is terminated, however now we are waiting for our new page
-            if page_number != self.config.page.get()
+            if page_number != self.page()
                 && !(self.de_ctr != 0 && flag_subtitle && self.receiving_data)
             {
                 return;
@@ -1382,10 +1466,7 @@ impl<'a> TeletextContext<'a> {
                 //page_buffer.tainted = YES;
             }
             */
-        } else if (m == self.config.page.get().magazine())
-            && (1..=23).contains(&y)
-            && self.receiving_data
-        {
+        } else if (m == self.page().magazine()) && (1..=23).contains(&y) && self.receiving_data {
             // ETS 300 706, chapter 9.4.1: Packets X/26 at presentation Levels 1.5, 2.5, 3.5 are used for addressing
             // a character location and overwriting the existing character defined on the Level 1 page
             // ETS 300 706, annex B.2.2: Packets with Y = 26 shall be transmitted before any packets with Y = 1 to Y = 25;
@@ -1398,19 +1479,12 @@ impl<'a> TeletextContext<'a> {
             }
             self.page_buffer.tainted = true;
             self.de_ctr -= 1;
-        } else if (m == self.config.page.get().magazine()) && (y == 26) && self.receiving_data {
+        } else if (m == self.page().magazine()) && (y == 26) && self.receiving_data {
             // ETS 300 706, chapter 12.3.2: X/26 definition
             let mut x26_row: u8 = 0;
 
-            let mut triplets: [u32; 13] = [0; 13];
-            for (j, triplet) in triplets.iter_mut().enumerate() {
-                *triplet = decode_hamming_24_18(
-                    ((packet.data[j * 3 + 3] as u32) << 16)
-                        | ((packet.data[j * 3 + 2] as u32) << 8)
-                        | (packet.data[j * 3 + 1] as u32),
-                )
-                .unwrap_or(0xffffffff);
-            }
+            let triplets = decode_hamming_24_18_triplets::<13>(&packet.data[1..])
+                .map(|triplet| triplet.unwrap_or(0xffffffff));
 
             for triplet in triplets {
                 // invalid data (HAM24/18 uncorrectable error detected), skip group
@@ -1470,7 +1544,7 @@ impl<'a> TeletextContext<'a> {
                     self.page_buffer.g2_char_present[x26_row as usize][address as usize] = true;
                 }
             }
-        } else if (m == self.config.page.get().magazine()) && (y == 28) && self.receiving_data {
+        } else if (m == self.page().magazine()) && (y == 28) && self.receiving_data {
             // TODO:
             //   ETS 300 706, chapter 9.4.7: Packet X/28/4
             //   Where packets 28/0 and 28/4 are both transmitted as part of a page, packet 28/0 takes precedence over 28/4 for all but the colour map entry coding.
@@ -1495,7 +1569,7 @@ impl<'a> TeletextContext<'a> {
                     debug!(msg_type = DebugMessageFlag::TELETEXT; "! Unrecoverable data error; UNHAM24/18()={:04x}\n", 0xffffffffu32);
                 }
             }
-        } else if (m == self.config.page.get().magazine()) && (y == 29) {
+        } else if (m == self.page().magazine()) && (y == 29) {
             // TODO:
             //   ETS 300 706, chapter 9.5.1 Packet M/29/0
             //   Where M/29/0 and M/29/4 are transmitted for the same magazine, M/29/0 takes precedence over M/29/4.
@@ -1520,7 +1594,7 @@ impl<'a> TeletextContext<'a> {
                     debug!(msg_type = DebugMessageFlag::TELETEXT; "! Unrecoverable data error; UNHAM24/18()={:04x}\n", 0xffffffffu32);
                 }
             }
-        } else if (m == 8) && (y == 30) {
+        } else if (m == 8) && (y == 30) && self.page.is_none() {
             // ETS 300 706, chapter 9.8: Broadcast Service Data Packets
             if !self.states.programme_info_processed {
                 // ETS 300 706, chapter 9.8.1: Packet 8/30 Format 1
@@ -1589,11 +1663,31 @@ impl<'a> TeletextContext<'a> {
     }
 
     /// Consumes the [`TeletextContext`] and appends the pending extracted subtitles in `subtitles`.
-    pub fn close(mut self, subtitles: Option<&mut Vec<Subtitle>>, capitalization_list: &[String]) {
-        info!(
-            "\nTeletext decoder: {} packets processed \n",
-            self.tlt_packet_counter
-        );
+    ///
+    /// Returns the subtitles of the other pages not taken yet with
+    /// [`TeletextContext::take_page_subtitles`], pending ones included.
+    pub fn close(
+        mut self,
+        subtitles: Option<&mut Vec<Subtitle>>,
+        capitalization_list: &[String],
+    ) -> Vec<(TeletextPageNumber, Vec<Subtitle>)> {
+        let mut pages = Vec::new();
+        for mut ctx in std::mem::take(&mut self.other_pages) {
+            let page = ctx.page();
+            let mut page_subtitles = std::mem::take(&mut ctx.page_subtitles);
+            ctx.last_timestamp = self.last_timestamp;
+            ctx.close(Some(&mut page_subtitles), capitalization_list);
+            if !page_subtitles.is_empty() {
+                pages.push((page, page_subtitles));
+            }
+        }
+
+        if self.page.is_none() {
+            info!(
+                "\nTeletext decoder: {} packets processed \n",
+                self.tlt_packet_counter
+            );
+        }
         if self.config.write_format != OutputFormat::Rcwt {
             if let Some(subtitles) = subtitles {
                 // output any pending close caption
@@ -1620,6 +1714,8 @@ impl<'a> TeletextContext<'a> {
                 self.telxcc_dump_prev_page();
             }
         }
+
+        pages
     }
 }
 
@@ -1667,8 +1763,11 @@ pub fn fuzzy_cmp(
     );
 
     // For the second string, only take the first chars (up to the first string length, that's short_len).
-    let l = levenshtein(ucs2_buf1, &ucs2_buf2[..short_len]);
-    let is_same = l < max;
-    debug!(msg_type = DebugMessageFlag::LEVENSHTEIN; "\rLEV | {} | {} | Max: {} | Calc: {} | Match: {}\n", c1, c2, max, l, is_same);
+    // Only whether the distance is below max matters, so the computation may stop early.
+    let l = max
+        .checked_sub(1)
+        .and_then(|bound| levenshtein_bounded(ucs2_buf1, &ucs2_buf2[..short_len], bound));
+    let is_same = l.is_some();
+    debug!(msg_type = DebugMessageFlag::LEVENSHTEIN; "\rLEV | {} | {} | Max: {} | Calc: {} | Match: {}\n", c1, c2, max, l.unwrap_or(max), is_same);
     is_same
 }
@@ -5,6 +5,7 @@
 //! - [`get_reverse_byte`]: Reverse the bits in an 8-bit value.
 //! - [`decode_hamming_8_4`]: Decode a Hamming(8,4) encoded byte.
 //! - [`decode_hamming_24_18`]: Decode a Hamming(24,18) encoded value.
+//! - [`decode_hamming_24_18_triplets`]: Decode consecutive Hamming(24,18) encoded triplets.
 //!
 //! # Conversion Guide
 //!
@@ -162,6 +163,54 @@ pub fn decode_hamming_8_4(value: u8) -> Option<u8> {
     }
 }
 
+/// Contribution of each byte of a \[24,18\] hamming code to its syndrome, indexed by byte
+/// position and value. Tests A-F correspond to bits 0-6 respectively of the syndrome.
+const HAMMING_24_18_SYNDROME_TABLE: [[u8; 256]; 3] = hamming_24_18_syndrome_table();
+
+/// Bit to flip for each syndrome of a \[24,18\] hamming code, or `None` for a double error.
+const HAMMING_24_18_CORRECTION_TABLE: [Option<u32>; 64] = hamming_24_18_correction_table();
+
+const fn hamming_24_18_syndrome_table() -> [[u8; 256]; 3] {
+    let mut table = [[0; 256]; 3];
+    let mut byte = 0;
+    while byte < 3 {
+        let mut value = 0;
+        while value < 256 {
+            let mut bit = 0;
+            while bit < 8 {
+                if (value >> bit) & 0x01 != 0 {
+                    let i = byte * 8 + bit;
+                    // Only parity bit is tested for bit 24
+                    table[byte][value] ^= if i < 23 { i as u8 + 33 } else { 32 };
+                }
+                bit += 1;
+            }
+            value += 1;
+        }
+        byte += 1;
+    }
+    table
+}
+
+const fn hamming_24_18_correction_table() -> [Option<u32>; 64] {
+    let mut table = [Some(0); 64];
+    let mut test = 0;
+    while test < 64 {
+        if (test & 0x1f) != 0x1f {
+            // Not all tests A-E correct
+            table[test] = if (test & 0x20) == 0x20 {
+                // F correct: Double error
+                None
+            } else {
+                // Test F incorrect: Single error
+                Some(1 << (30 - test))
+            };
+        }
+        test += 1;
+    }
+    table
+}
+
 /// Returns an Option of the decoded byte given a \[24,18\] hamming code byte.
 /// (ETS 300 706, chapter 8.3)
 ///
@@ -171,26 +220,11 @@ pub fn decode_hamming_8_4(value: u8) -> Option<u8> {
 /// assert_eq!(decode_hamming_24_18(0x00000000), Some(0x00000000));
 /// assert_eq!(decode_hamming_24_18(0x00000001), None);
 /// ```
-pub fn decode_hamming_24_18(mut value: u32) -> Option<u32> {
-    let mut test: u8 = 0;
-
-    // Tests A-F correspond to bits 0-6 respectively in 'test'.
-    for i in 0..23 {
-        test ^= (((value >> i) & 0x01) as u8) * (i + 33);
-    }
-
-    // Only parity bit is tested for bit 24
-    test ^= (((value >> 23) & 0x01) as u8) * 32u8;
-
-    if (test & 0x1f) != 0x1f {
-        // Not all tests A-E correct
-        if (test & 0x20) == 0x20 {
-            // F correct: Double error
-            return None;
-        }
-        // Test F incorrect: Single error
-        value ^= 1 << (30 - test);
-    }
+pub fn decode_hamming_24_18(value: u32) -> Option<u32> {
+    let test = HAMMING_24_18_SYNDROME_TABLE[0][(value & 0xff) as usize]
+        ^ HAMMING_24_18_SYNDROME_TABLE[1][((value >> 8) & 0xff) as usize]
+        ^ HAMMING_24_18_SYNDROME_TABLE[2][((value >> 16) & 0xff) as usize];
+    let value = value ^ HAMMING_24_18_CORRECTION_TABLE[test as usize]?;
 
     Some(
         ((value & 0x000004) >> 2)
@@ -200,6 +234,29 @@ pub fn decode_hamming_24_18(mut value: u32) -> Option<u32> {
     )
 }
 
+/// Decodes `N` consecutive \[24,18\] hamming coded triplets from `data`, least significant byte
+/// first, such as the 13 triplets of a packet X/26, X/28 or X/29.
+///
+/// # Panics
+///
+/// Panics if `data` is shorter than `3 * N` bytes.
+///
+/// # Exmaples
+/// ```rust
+/// # use lib_ccxr::util::bits::*;
+/// let triplets = decode_hamming_24_18_triplets::<2>(&[0x00, 0x00, 0x00, 0x01, 0x00, 0x00]);
+/// assert_eq!(triplets, [Some(0x00000000), None]);
+/// ```
+pub fn decode_hamming_24_18_triplets<const N: usize>(data: &[u8]) -> [Option<u32>; N] {
+    let mut triplets = [None; N];
+    for (triplet, bytes) in triplets.iter_mut().zip(data[..3 * N].chunks_exact(3)) {
+        *triplet = decode_hamming_24_18(
+            ((bytes[2] as u32) << 16) | ((bytes[1] as u32) << 8) | (bytes[0] as u32),
+        );
+    }
+    triplets
+}
+
 /// Returns a crc 32-bit from given 8-bit unsigned integer.
 ///
 /// # Exmaples
@@ -261,6 +318,47 @@ mod tests {
         );
     }
 
+    #[test]
+    fn test_decode_hamming_24_18_matches_syndrome_loop() {
+        // Bit by bit syndrome computation of ETS 300 706, chapter 8.3
+        fn decode_reference(mut value: u32) -> Option<u32> {
+            let mut test: u8 = 0;
+            for i in 0..23 {
+                test ^= (((value >> i) & 0x01) as u8) * (i + 33);
+            }
+            test ^= (((value >> 23) & 0x01) as u8) * 32u8;
+            if (test & 0x1f) != 0x1f {
+                if (test & 0x20) == 0x20 {
+                    return None;
+                }
+                value ^= 1 << (30 - test);
+            }
+            Some(
+                ((value & 0x000004) >> 2)
+                    | ((value & 0x000070) >> 3)
+                    | ((value & 0x007f00) >> 4)
+                    | ((value & 0x7f0000) >> 5),
+            )
+        }
+
+        for value in (0..1u32 << 24).step_by(97).chain([0x00ffffff, 0xff000000]) {
+            assert_eq!(decode_hamming_24_18(value), decode_reference(value));
+        }
+    }
+
+    #[test]
+    fn test_decode_hamming_24_18_triplets() {
+        let data = [0xff, 0xff, 0xff, 0x01, 0x00, 0x00, 0xaa, 0xaa, 0xaa, 0x12];
+        assert_eq!(
+            decode_hamming_24_18_triplets::<3>(&data),
+            [
+                decode_hamming_24_18(0xffffff),
+                decode_hamming_24_18(0x000001),
+                decode_hamming_24_18(0xaaaaaa)
+            ]
+        );
+    }
+
     #[test]
     fn test_get_crc32_byte() {
         assert_eq!(get_crc32_byte(0), 0x00000000);
@@ -1,6 +1,230 @@
 //! Provides function for calculating levenshtein distance.
+//!
+//! The distance is computed with the bit-parallel algorithm of Myers, in the blocked form
+//! described by Hyyrö: each column of the edit distance matrix is kept as vertical delta bit
+//! vectors, so 64 cells are updated per word operation. Patterns of up to 64 symbols (such as a
+//! teletext row) are handled without any heap allocation.
 
-use std::cmp::min;
+const WORD_BITS: usize = u64::BITS as usize;
+
+/// Position bitmasks of every distinct symbol of a pattern of at most 64 symbols.
+///
+/// The symbols are kept sorted so that a lookup is a binary search over at most 64 entries.
+struct SingleBlockMasks<T> {
+    symbols: [T; WORD_BITS],
+    masks: [u64; WORD_BITS],
+    len: usize,
+}
+
+impl<T: Copy + Ord> SingleBlockMasks<T> {
+    /// Builds the masks for `pattern`, which must hold between 1 and 64 symbols.
+    fn new(pattern: &[T]) -> SingleBlockMasks<T> {
+        let mut table = SingleBlockMasks {
+            symbols: [pattern[0]; WORD_BITS],
+            masks: [0; WORD_BITS],
+            len: 0,
+        };
+
+        for (pos, &symbol) in pattern.iter().enumerate() {
+            let idx = match table.symbols[..table.len].binary_search(&symbol) {
+                Ok(idx) => idx,
+                Err(idx) => {
+                    table.symbols.copy_within(idx..table.len, idx + 1);
+                    table.masks.copy_within(idx..table.len, idx + 1);
+                    table.symbols[idx] = symbol;
+                    table.masks[idx] = 0;
+                    table.len += 1;
+                    idx
+                }
+            };
+            table.masks[idx] |= 1 << pos;
+        }
+
+        table
+    }
+
+    fn get(&self, symbol: T) -> u64 {
+        match self.symbols[..self.len].binary_search(&symbol) {
+            Ok(idx) => self.masks[idx],
+            Err(_) => 0,
+        }
+    }
+}
+
+/// Position bitmasks of every distinct symbol of a pattern, split into 64-bit blocks.
+struct BlockMasks<T> {
+    symbols: Vec<T>,
+    /// `blocks` words per entry of `symbols`.
+    masks: Vec<u64>,
+    blocks: usize,
+}
+
+impl<T: Copy + Ord> BlockMasks<T> {
+    fn new(pattern: &[T]) -> BlockMasks<T> {
+        let mut symbols = pattern.to_vec();
+        symbols.sort_unstable();
+        symbols.dedup();
+
+        let blocks = pattern.len().div_ceil(WORD_BITS);
+        let mut masks = vec![0; symbols.len() * blocks];
+        for (pos, symbol) in pattern.iter().enumerate() {
+            // Every symbol of the pattern is in `symbols`.
+            let idx = symbols.binary_search(symbol).unwrap_or_default();
+            masks[idx * blocks + pos / WORD_BITS] |= 1 << (pos % WORD_BITS);
+        }
+
+        BlockMasks {
+            symbols,
+            masks,
+            blocks,
+        }
+    }
+
+    /// Returns the masks of all blocks for `symbol`, or `None` if it is not in the pattern.
+    fn get(&self, symbol: T) -> Option<&[u64]> {
+        self.symbols
+            .binary_search(&symbol)
+            .ok()
+            .map(|idx| &self.masks[idx * self.blocks..(idx + 1) * self.blocks])
+    }
+}
+
+/// Computes the distance of a pattern of 1 to 64 symbols against `text`.
+///
+/// If `max` is given, gives up and returns `None` as soon as the distance is known to exceed it.
+fn myers_single_block<T: Copy + Ord>(
+    pattern: &[T],
+    text: &[T],
+    max: Option<usize>,
+) -> Option<usize> {
+    let masks = SingleBlockMasks::new(pattern);
+    let last = 1u64 << (pattern.len() - 1);
+
+    let mut vp = !0u64;
+    let mut vn = 0u64;
+    let mut dist = pattern.len();
+
+    for (col, &symbol) in text.iter().enumerate() {
+        let x = masks.get(symbol);
+        let d0 = (((x & vp).wrapping_add(vp)) ^ vp) | x | vn;
+        let mut hp = vn | !(d0 | vp);
+        let mut hn = d0 & vp;
+
+        if hp & last != 0 {
+            dist += 1;
+        } else if hn & last != 0 {
+            dist -= 1;
+        }
+
+        if let Some(max) = max {
+            // Every remaining column can lower the distance by at most one.
+            let remaining = text.len() - col - 1;
+            if dist > max + remaining {
+                return None;
+            }
+        }
+
+        hp = (hp << 1) | 1;
+        hn <<= 1;
+        vp = hn | !(d0 | hp);
+        vn = hp & d0;
+    }
+
+    Some(dist)
+}
+
+/// Computes the distance of a pattern longer than 64 symbols against `text`, one 64-row block
+/// of each column at a time.
+///
+/// If `max` is given, gives up and returns `None` as soon as the distance is known to exceed it.
+fn myers_blocks<T: Copy + Ord>(pattern: &[T], text: &[T], max: Option<usize>) -> Option<usize> {
+    let masks = BlockMasks::new(pattern);
+    let blocks = masks.blocks;
+    let last = 1u64 << ((pattern.len() - 1) % WORD_BITS);
+
+    let mut vp = vec![!0u64; blocks];
+    let mut vn = vec![0u64; blocks];
+    let mut dist = pattern.len();
+
+    for (col, &symbol) in text.iter().enumerate() {
+        let symbol_masks = masks.get(symbol);
+        // The top row of the matrix grows by one every column.
+        let mut hp_carry = 1u64;
+        let mut hn_carry = 0u64;
+
+        for block in 0..blocks {
+            let x = symbol_masks.map_or(0, |m| m[block]) | hn_carry;
+            let d0 = (((x & vp[block]).wrapping_add(vp[block])) ^ vp[block]) | x | vn[block];
+            let hp = vn[block] | !(d0 | vp[block]);
+            let hn = d0 & vp[block];
+
+            if block == blocks - 1 {
+                if hp & last != 0 {
+                    dist += 1;
+                } else if hn & last != 0 {
+                    dist -= 1;
+                }
+            }
+
+            let hp_shifted = (hp << 1) | hp_carry;
+            let hn_shifted = (hn << 1) | hn_carry;
+            hp_carry = hp >> (WORD_BITS - 1);
+            hn_carry = hn >> (WORD_BITS - 1);
+
+            vp[block] = hn_shifted | !(d0 | hp_shifted);
+            vn[block] = hp_shifted & d0;
+        }
+
+        if let Some(max) = max {
+            let remaining = text.len() - col - 1;
+            if dist > max + remaining {
+                return None;
+            }
+        }
+    }
+
+    Some(dist)
+}
+
+fn myers<T: Copy + Ord>(a: &[T], b: &[T], max: Option<usize>) -> Option<usize> {
+    // The distance is at least the difference in length.
+    if let Some(max) = max {
+        if a.len().abs_diff(b.len()) > max {
+            return None;
+        }
+    }
+
+    // The shorter slice is the pattern, which keeps the number of blocks down.
+    let (pattern, text) = if a.len() <= b.len() { (a, b) } else { (b, a) };
+
+    // A common prefix or suffix never changes the distance.
+    let prefix = pattern.iter().zip(text).take_while(|(x, y)| x == y).count();
+    let (pattern, text) = (&pattern[prefix..], &text[prefix..]);
+    let suffix = pattern
+        .iter()
+        .rev()
+        .zip(text.iter().rev())
+        .take_while(|(x, y)| x == y)
+        .count();
+    let (pattern, text) = (
+        &pattern[..pattern.len() - suffix],
+        &text[..text.len() - suffix],
+    );
+
+    if pattern.is_empty() {
+        let dist = text.len();
+        return match max {
+            Some(max) if dist > max => None,
+            _ => Some(dist),
+        };
+    }
+
+    if pattern.len() <= WORD_BITS {
+        myers_single_block(pattern, text, max)
+    } else {
+        myers_blocks(pattern, text, max)
+    }
+}
 
 /// Calculates the levenshtein distance between two slices.
 ///
@@ -9,23 +233,23 @@ use std::cmp::min;
 /// # use lib_ccxr::util::levenshtein::*;
 /// assert_eq!(levenshtein(&[1,2,3,4,5], &[1,3,2,4,5,6]), 3);
 /// ```
-pub fn levenshtein<T: Copy + PartialEq>(a: &[T], b: &[T]) -> usize {
-    let mut column: Vec<usize> = (0..).take(a.len() + 1).collect();
-
-    for x in 1..=b.len() {
-        column[0] = x;
-        let mut lastdiag = x - 1;
-        for y in 1..=a.len() {
-            let olddiag = column[y];
-            column[y] = min(
-                min(column[y] + 1, column[y - 1] + 1),
-                lastdiag + (if a[y - 1] == b[x - 1] { 0 } else { 1 }),
-            );
-            lastdiag = olddiag;
-        }
-    }
+pub fn levenshtein<T: Copy + Ord>(a: &[T], b: &[T]) -> usize {
+    myers(a, b, None).unwrap_or_default()
+}
 
-    column[a.len()]
+/// Calculates the levenshtein distance between two slices if it is at most `max`.
+///
+/// Returns `None` as soon as the distance is known to be greater than `max`, which is all that
+/// callers comparing against a threshold need to know.
+///
+/// # Examples
+/// ```rust
+/// # use lib_ccxr::util::levenshtein::*;
+/// assert_eq!(levenshtein_bounded(&[1,2,3,4,5], &[1,3,2,4,5,6], 3), Some(3));
+/// assert_eq!(levenshtein_bounded(&[1,2,3,4,5], &[1,3,2,4,5,6], 2), None);
+/// ```
+pub fn levenshtein_bounded<T: Copy + Ord>(a: &[T], b: &[T], max: usize) -> Option<usize> {
+    myers(a, b, Some(max))
 }
 
 /// Rust equivalent for `levenshtein_dist` function in C. Uses Rust-native types as input and output.
@@ -34,13 +258,46 @@ pub fn levenshtein_dist(s1: &[u64], s2: &[u64]) -> usize {
 }
 
 /// Rust equivalent for `levenshtein_dist_char` function in C. Uses Rust-native types as input and output.
-pub fn levenshtein_dist_char<T: Copy + PartialEq>(s1: &[T], s2: &[T]) -> usize {
+pub fn levenshtein_dist_char<T: Copy + Ord>(s1: &[T], s2: &[T]) -> usize {
     levenshtein(s1, s2)
 }
 
 #[cfg(test)]
 mod tests {
     use super::*;
+    use std::cmp::min;
+
+    /// Reference column-by-column implementation.
+    fn levenshtein_dp<T: Copy + PartialEq>(a: &[T], b: &[T]) -> usize {
+        let mut column: Vec<usize> = (0..).take(a.len() + 1).collect();
+
+        for x in 1..=b.len() {
+            column[0] = x;
+            let mut lastdiag = x - 1;
+            for y in 1..=a.len() {
+                let olddiag = column[y];
+                column[y] = min(
+                    min(column[y] + 1, column[y - 1] + 1),
+                    lastdiag + (if a[y - 1] == b[x - 1] { 0 } else { 1 }),
+                );
+                lastdiag = olddiag;
+            }
+        }
+
+        column[a.len()]
+    }
+
+    /// Deterministic pseudo random symbols from a small alphabet.
+    fn symbols(seed: &mut u64, len: usize, alphabet: u64) -> Vec<u64> {
+        (0..len)
+            .map(|_| {
+                *seed = seed
+                    .wrapping_mul(6364136223846793005)
+                    .wrapping_add(1442695040888963407);
+                (*seed >> 33) % alphabet
+            })
+            .collect()
+    }
 
     #[test]
     fn test_levenshtein() {
@@ -70,4 +327,49 @@ mod tests {
         );
         assert_eq!(levenshtein(&["foo", "bar", "baz"], &["foo", "baz"]), 1);
     }
+
+    #[test]
+    fn test_levenshtein_matches_dp() {
+        let mut seed = 1;
+        // Lengths around the single block limit and across several blocks.
+        for &(len_a, len_b) in &[
+            (1, 1),
+            (5, 40),
+            (40, 40),
+            (63, 64),
+            (64, 64),
+            (64, 65),
+            (65, 64),
+            (100, 130),
+            (128, 128),
+            (129, 200),
+            (300, 250),
+        ] {
+            for alphabet in [2, 4, 26] {
+                let a = symbols(&mut seed, len_a, alphabet);
+                let b = symbols(&mut seed, len_b, alphabet);
+                let expected = levenshtein_dp(&a, &b);
+                assert_eq!(levenshtein(&a, &b), expected);
+                assert_eq!(levenshtein(&b, &a), expected);
+            }
+        }
+    }
+
+    #[test]
+    fn test_levenshtein_bounded() {
+        assert_eq!(levenshtein_bounded(&[1, 2, 3], &[1, 2, 3], 0), Some(0));
+        assert_eq!(levenshtein_bounded(&[1, 2, 3], &[1, 2, 4], 0), None);
+        assert_eq!(levenshtein_bounded(&[1, 2, 3], &[], 2), None);
+        assert_eq!(levenshtein_bounded(&[], &[1, 2, 3], 3), Some(3));
+
+        let mut seed = 7;
+        for &(len_a, len_b) in &[(20, 24), (64, 60), (90, 100), (200, 200)] {
+            let a = symbols(&mut seed, len_a, 4);
+            let b = symbols(&mut seed, len_b, 4);
+            let dist = levenshtein_dp(&a, &b);
+            assert_eq!(levenshtein_bounded(&a, &b, dist), Some(dist));
+            assert_eq!(levenshtein_bounded(&a, &b, dist + 5), Some(dist));
+            assert_eq!(levenshtein_bounded(&a, &b, dist - 1), None);
+        }
+    }
 }
@@ -2,13 +2,14 @@
 //!
 //! # Conversion Guide
 //!
-//! | From                                       | To                             |
-//! |--------------------------------------------|--------------------------------|
-//! | `PARITY_8`                                 | [`parity`]                     |
-//! | `REVERSE_8`                                | [`reverse`]                    |
-//! | `UNHAM_8_4`                                | [`decode_hamming_8_4`]         |
-//! | `unham_24_18`                              | [`decode_hamming_24_18`]       |
-//! | `levenshtein_dist`, levenshtein_dist_char` | [`levenshtein`](levenshtein()) |
+//! | From                                                        | To                                                        |
+//! |-------------------------------------------------------------|-----------------------------------------------------------|
+//! | `PARITY_8`                                                  | [`parity`]                                                |
+//! | `REVERSE_8`                                                 | [`reverse`]                                               |
+//! | `UNHAM_8_4`                                                 | [`decode_hamming_8_4`]                                    |
+//! | `unham_24_18`                                               | [`decode_hamming_24_18`]                                  |
+//! | `levenshtein_dist`, levenshtein_dist_char`                  | [`levenshtein`](levenshtein())                            |
+//! | `levenshtein_dist_bounded`, `levenshtein_dist_char_bounded` | [`levenshtein_bounded`](levenshtein::levenshtein_bounded) |
 
 pub mod bits;
 pub mod encoders_helper;
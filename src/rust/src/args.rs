@@ -577,6 +577,10 @@ pub struct Args {
     /// stream will be processed. e.g. 'eng' for English.
     /// If there are multiple languages, only this specified
     /// language stream will be processed (default).
+    /// Use 'all' to extract every DVB subtitle stream in a
+    /// single pass. The first one goes to the usual output
+    /// file, each of the others to a file named after its
+    /// language, e.g. output_fre.srt.
     #[arg(long, verbatim_doc_comment, help_heading=OUTPUT_AFFECTING_OUTPUT_FILES)]
     pub dvblang: Option<String>,
     /// Manually select the name of the Tesseract .traineddata
@@ -825,6 +829,8 @@ pub struct Args {
     /// Use this page for subtitles (if this parameter
     /// is not used, try to autodetect). In Spain the
     /// page is always 888, may vary in other countries.
+    /// Use --tpage all to extract every subtitle page in a
+    /// single pass, each to its own output file.
     #[arg(long, verbatim_doc_comment, value_name="page", help_heading=TELETEXT_OPTIONS)]
     pub tpage: Option<String>,
     /// Enable verbose mode in the teletext decoder.
@@ -931,6 +937,38 @@ pub struct Args {
     /// to be word-wise
     #[arg(long, verbatim_doc_comment, help_heading=BURNEDIN_SUBTITLE_EXTRACTION)]
     pub detect_italics: bool,
+    /// Sample the video every --min-sub-duration seconds
+    /// and bisect around changes of the subtitle area to
+    /// find exact start and end frames, instead of
+    /// running OCR on every second of the video.
+    /// Much faster on long videos.
+    #[arg(long, verbatim_doc_comment, help_heading=BURNEDIN_SUBTITLE_EXTRACTION)]
+    pub binary_search: bool,
+    /// Top of the region searched for subtitles, as a
+    /// percentage of the frame height. Only this region
+    /// is converted and processed, so smaller regions are
+    /// faster. Default is 75 (bottom quarter), or 92 with
+    /// --tickertext.
+    /// e.g. --roi-top 60
+    #[arg(long, verbatim_doc_comment, value_name="percent", help_heading=BURNEDIN_SUBTITLE_EXTRACTION)]
+    pub roi_top: Option<f32>,
+    /// Number of threads running OCR in the linear and
+    /// ticker text searches. Each one has its own
+    /// Tesseract instance. 0 uses one per CPU core.
+    /// Default is 1. The output does not depend on it.
+    /// e.g. --hardsubx-threads 4
+    #[arg(long, verbatim_doc_comment, value_name="n", help_heading=BURNEDIN_SUBTITLE_EXTRACTION)]
+    pub hardsubx_threads: Option<u32>,
+    /// Do not decode the frames the linear and ticker text
+    /// searches do not need, so decoding costs depend on the
+    /// sampling rate, not the frame rate.
+    /// nonref skips frames no other frame depends on,
+    /// nonkey only decodes key frames, which only works if
+    /// they are closer than --min-sub-duration.
+    /// e.g. --skip-frames none (default), --skip-frames nonref,
+    /// --skip-frames nonkey
+    #[arg(long, verbatim_doc_comment, value_name="mode", help_heading=BURNEDIN_SUBTITLE_EXTRACTION)]
+    pub skip_frames: Option<String>,
     /// Specify the classifier confidence threshold between
     /// 1 and 100.
     /// Try and use a threshold which works for you if you get
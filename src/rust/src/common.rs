@@ -16,6 +16,7 @@ use lib_ccxr::common::StreamMode;
 use lib_ccxr::common::StreamType;
 use lib_ccxr::hardsubx::ColorHue;
 use lib_ccxr::hardsubx::OcrMode;
+use lib_ccxr::hardsubx::SkipFrames;
 use lib_ccxr::teletext::TeletextConfig;
 use lib_ccxr::time::units::Timestamp;
 use lib_ccxr::time::units::TimestampFormat;
@@ -150,6 +151,7 @@ pub unsafe fn copy_from_rust(ccx_s_options: *mut ccx_s_options, options: Options
     if let Some(dvblang) = options.dvblang {
         (*ccx_s_options).dvblang = string_to_c_char(dvblang.to_ctype().as_str());
     }
+    (*ccx_s_options).dvb_all_streams = options.dvb_all_streams as _;
     if options.ocrlang.try_exists().unwrap_or_default() {
         (*ccx_s_options).ocrlang = string_to_c_char(options.ocrlang.to_str().unwrap());
     }
@@ -163,6 +165,10 @@ pub unsafe fn copy_from_rust(ccx_s_options: *mut ccx_s_options, options: Options
     (*ccx_s_options).hardsubx_subcolor = options.hardsubx_hue.to_ctype();
     (*ccx_s_options).hardsubx_min_sub_duration = options.hardsubx_min_sub_duration.seconds() as _;
     (*ccx_s_options).hardsubx_detect_italics = options.hardsubx_detect_italics as _;
+    (*ccx_s_options).hardsubx_binary_search = options.hardsubx_binary_search as _;
+    (*ccx_s_options).hardsubx_roi_top = options.hardsubx_roi_top.unwrap_or(-1.0) as _;
+    (*ccx_s_options).hardsubx_threads = options.hardsubx_threads as _;
+    (*ccx_s_options).hardsubx_skip_frames = options.hardsubx_skip_frames.to_ctype();
     (*ccx_s_options).hardsubx_conf_thresh = options.hardsubx_conf_thresh as _;
     (*ccx_s_options).hardsubx_hue = options.hardsubx_hue.get_hue() as _;
     (*ccx_s_options).hardsubx_lum_thresh = options.hardsubx_lum_thresh as _;
@@ -250,6 +256,7 @@ impl CType2<ccx_s_teletext_config, &Options> for TeletextConfig {
             tid: 0,
             offset: 0.0,
             user_page: self.user_page,
+            all_pages: self.all_pages.into(),
             dolevdist: self.dolevdist.into(),
             levdistmincnt: self.levdistmincnt.into(),
             levdistmaxpct: self.levdistmaxpct.into(),
@@ -372,6 +379,13 @@ impl CType<i32> for OcrMode {
     }
 }
 
+impl CType<i32> for SkipFrames {
+    /// Convert to C variant of `i32`.
+    unsafe fn to_ctype(&self) -> i32 {
+        *self as i32
+    }
+}
+
 impl CType<i32> for ColorHue {
     /// Convert to C variant of `i32`.
     unsafe fn to_ctype(&self) -> i32 {
@@ -16,6 +16,7 @@ use lib_ccxr::{
 };
 
 use crate::{bindings::*, utils::is_true};
+use service_decoder::ServiceDecoder;
 
 const CCX_DTVCC_MAX_PACKET_LENGTH: u8 = 128;
 const CCX_DTVCC_NO_LAST_SEQUENCE: i32 = -1;
@@ -31,7 +32,11 @@ pub struct Dtvcc<'a> {
     pub services_active: Vec<i32>,
     pub report_enabled: bool,
     pub report: &'a mut ccx_decoder_dtvcc_report,
-    pub decoders: Vec<&'a mut dtvcc_service_decoder>,
+    /// Decoders of the active services, indexed by service number - 1
+    ///
+    /// The decoder state lives here rather than in the C `dtvcc_ctx`, so it is only converted for
+    /// the C side when a caption is written
+    pub decoders: Vec<Option<Box<ServiceDecoder>>>,
     pub packet: Vec<u8>,
     pub packet_length: u8,
     pub is_header_parsed: bool,
@@ -47,6 +52,18 @@ impl<'a> Dtvcc<'a> {
         let report = unsafe { &mut *ctx.report };
         let encoder = unsafe { &mut *(ctx.encoder as *mut encoder_ctx) };
         let timing = unsafe { &mut *ctx.timing };
+        let decoders = ctx
+            .services_active
+            .iter()
+            .enumerate()
+            .map(|(i, &active)| {
+                if is_true(active) {
+                    Some(Box::new(ServiceDecoder::new(i as i32 + 1)))
+                } else {
+                    None
+                }
+            })
+            .collect();
 
         Self {
             is_active: is_true(ctx.is_active),
@@ -54,7 +71,7 @@ impl<'a> Dtvcc<'a> {
             services_active: ctx.services_active.to_vec(),
             report_enabled: is_true(ctx.report_enabled),
             report,
-            decoders: ctx.decoders.iter_mut().collect(),
+            decoders,
             packet: ctx.current_packet.to_vec(),
             packet_length: ctx.current_packet_length as u8,
             is_header_parsed: is_true(ctx.is_current_packet_header_parsed),
@@ -175,13 +192,14 @@ impl<'a> Dtvcc<'a> {
             }
 
             if service_number > 0 && is_true(self.services_active[(service_number - 1) as usize]) {
-                let decoder = &mut self.decoders[(service_number - 1) as usize];
-                decoder.process_service_block(
-                    &self.packet[pos as usize..(pos + block_length) as usize],
-                    self.encoder,
-                    self.timing,
-                    self.no_rollup,
-                );
+                if let Some(decoder) = self.decoders[(service_number - 1) as usize].as_mut() {
+                    decoder.process_service_block(
+                        &self.packet[pos as usize..(pos + block_length) as usize],
+                        self.encoder,
+                        self.timing,
+                        self.no_rollup,
+                    );
+                }
             }
 
             pos += block_length // Skip data
@@ -200,6 +218,19 @@ impl<'a> Dtvcc<'a> {
         self.is_header_parsed = false;
         self.packet.iter_mut().for_each(|x| *x = 0);
     }
+    /// Flush the decoders of the active services that printed captions
+    ///
+    /// Returns `true` if any decoder was flushed
+    pub fn flush_active_decoders(&mut self) -> bool {
+        let mut flushed = false;
+        for decoder in self.decoders.iter_mut().flatten() {
+            if decoder.cc_count > 0 {
+                decoder.flush(self.encoder, self.timing);
+                flushed = true;
+            }
+        }
+        flushed
+    }
 }
 
 /// A single character symbol
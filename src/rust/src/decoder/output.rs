@@ -4,12 +4,18 @@
 use std::os::unix::prelude::{FromRawFd, IntoRawFd};
 #[cfg(windows)]
 use std::os::windows::io::{FromRawHandle, IntoRawHandle};
-use std::{fs::File, io::Write};
+use std::{cell::RefCell, fs::File, io::Write};
 
 use crate::{bindings::*, utils::is_true};
 
 use log::{debug, warn};
 
+thread_local! {
+    /// Output buffer handed from one [`Writer`] to the next, so captions are rendered without
+    /// allocating once it has grown to the size of a caption
+    static WRITER_BUF: RefCell<Vec<u8>> = RefCell::new(Vec::new());
+}
+
 // Context for writing subtitles to file
 pub struct Writer<'a> {
     pub cea_708_counter: &'a mut u32,
@@ -21,6 +27,8 @@ pub struct Writer<'a> {
     pub transcript_settings: &'a ccx_encoders_transcript_format,
     pub no_bom: i32,
     pub old_cc_time_end: i32,
+    /// Rendered output, written to the file by [`Writer::flush_buf`]
+    pub buf: Vec<u8>,
 }
 
 impl<'a> Writer<'a> {
@@ -44,6 +52,7 @@ impl<'a> Writer<'a> {
             transcript_settings,
             no_bom,
             old_cc_time_end: 0,
+            buf: WRITER_BUF.with(|buf| std::mem::take(&mut *buf.borrow_mut())),
         }
     }
     /// Write subtitles to the file
@@ -66,6 +75,17 @@ impl<'a> Writer<'a> {
         }
         Ok(())
     }
+    /// Write the rendered output in [`Writer::buf`] to the file and clear it
+    pub fn flush_buf(&mut self) -> Result<(), String> {
+        if self.buf.is_empty() {
+            return Ok(());
+        }
+        let buf = std::mem::take(&mut self.buf);
+        let result = self.write_to_file(&buf);
+        self.buf = buf;
+        self.buf.clear();
+        result
+    }
     /// Finish writing up any remaining parts
     pub fn write_done(&mut self) {
         if self.write_format == ccx_output_format::CCX_OF_SAMI {
@@ -83,6 +103,14 @@ impl<'a> Writer<'a> {
     }
 }
 
+impl Drop for Writer<'_> {
+    fn drop(&mut self) {
+        let mut buf = std::mem::take(&mut self.buf);
+        buf.clear();
+        WRITER_BUF.with(|cell| *cell.borrow_mut() = buf);
+    }
+}
+
 /// Write the symbol to the provided buffer
 ///
 /// If symbol is 8-bit, then it's written to the buffer
@@ -2,22 +2,16 @@
 //!
 //! Caption Service decoder processes service blocks and handles the different [commands][super::commands] received
 
-use std::{
-    alloc::{alloc, dealloc, Layout},
-    os::raw::c_uchar,
-};
+use std::os::raw::c_uchar;
 
 use super::commands::{self, C0CodeSet, C0Command, C1CodeSet, C1Command};
-use super::window::{PenPreset, WindowPreset};
+use super::tv_screen::TvScreen;
+use super::window::{Cell, PenPreset, Window, WindowPreset};
 use super::{
     CCX_DTVCC_MAX_COLUMNS, CCX_DTVCC_MAX_ROWS, CCX_DTVCC_SCREENGRID_COLUMNS,
     CCX_DTVCC_SCREENGRID_ROWS,
 };
-use crate::{
-    bindings::*,
-    decoder::output::Writer,
-    utils::{is_false, is_true},
-};
+use crate::{bindings::*, decoder::output::Writer};
 
 use log::{debug, error, warn};
 
@@ -25,7 +19,29 @@ const CCX_DTVCC_MUSICAL_NOTE_CHAR: u16 = 9836;
 const CCX_DTVCC_MAX_WINDOWS: u8 = 8;
 const DTVCC_COMMANDS_C0_CODES_DTVCC_C0_EXT1: u8 = 16;
 
-impl dtvcc_service_decoder {
+/// Decoder of a single caption service
+///
+/// Owns the windows and the TV screen of the service, the C side only sees the captions
+/// written to the output file
+pub struct ServiceDecoder {
+    pub windows: [Window; CCX_DTVCC_MAX_WINDOWS as usize],
+    pub current_window: i32,
+    pub tv: TvScreen,
+    /// Number of captions printed by the decoder
+    pub cc_count: u32,
+}
+
+impl ServiceDecoder {
+    /// Create a decoder for the service with all windows undefined
+    pub fn new(service_number: i32) -> Self {
+        Self {
+            windows: Default::default(),
+            current_window: -1,
+            tv: TvScreen::new(service_number),
+            cc_count: 0,
+        }
+    }
+
     /// Process service block and call handlers for the respective codesets
     pub fn process_service_block(
         &mut self,
@@ -112,7 +128,7 @@ impl dtvcc_service_decoder {
         }
         let window = &mut self.windows[self.current_window as usize];
         let mut rollup_required = false;
-        let pd = match dtvcc_window_pd::new(window.attribs.print_direction) {
+        let pd = match dtvcc_window_pd::new(window.attribs.print_direction as i32) {
             Ok(val) => val,
             Err(e) => {
                 warn!("{}", e);
@@ -154,13 +170,13 @@ impl dtvcc_service_decoder {
             }
         };
 
-        if is_true(window.is_defined) {
+        if window.is_defined {
             let pen_row = window.pen_row;
             window.update_time_hide(timing);
 
             if rollup_required {
                 debug!("dtvcc_process_cr: rolling up");
-                self.copy_to_screen(&self.windows[self.current_window as usize]);
+                self.copy_to_screen(self.current_window as usize);
                 self.screen_print(encoder, timing);
                 if no_rollup {
                     self.windows[self.current_window as usize].clear_row(pen_row as usize);
@@ -215,7 +231,7 @@ impl dtvcc_service_decoder {
         //it looks strange, but in some videos (rarely) we have a backspace command
         //we just print one character over another
         let window = &mut self.windows[self.current_window as usize];
-        let pd = match dtvcc_window_pd::new(window.attribs.print_direction) {
+        let pd = match dtvcc_window_pd::new(window.attribs.print_direction as i32) {
             Ok(val) => val,
             Err(e) => {
                 warn!("{}", e);
@@ -345,13 +361,12 @@ impl dtvcc_service_decoder {
                 if windows_bitmap & 1 == 1 {
                     let window = &mut self.windows[i as usize];
                     debug!("[W{}]", i);
-                    let window_had_content = is_true(window.is_defined)
-                        && is_true(window.visible)
-                        && is_false(window.is_empty);
+                    let window_had_content =
+                        window.is_defined && window.visible && !window.is_empty;
                     if window_had_content {
                         screen_content_changed = true;
                         window.update_time_hide(timing);
-                        self.copy_to_screen(&self.windows[i as usize]);
+                        self.copy_to_screen(i as usize);
                     }
                     self.windows[i as usize].clear_text();
                 }
@@ -382,12 +397,12 @@ impl dtvcc_service_decoder {
                 if windows_bitmap & 1 == 1 {
                     let window = &mut self.windows[i as usize];
                     debug!("[W{}]", i);
-                    if is_true(window.visible) {
+                    if window.visible {
                         screen_content_changed = true;
-                        window.visible = 0;
+                        window.visible = false;
                         window.update_time_hide(timing);
-                        if is_false(window.is_empty) {
-                            self.copy_to_screen(&self.windows[i as usize]);
+                        if !window.is_empty {
+                            self.copy_to_screen(i as usize);
                         }
                     }
                 }
@@ -416,18 +431,18 @@ impl dtvcc_service_decoder {
             let mut screen_content_changed = false;
             for i in 0..CCX_DTVCC_MAX_WINDOWS {
                 let window = &mut self.windows[i as usize];
-                if windows_bitmap & 1 == 1 && is_true(window.is_defined) {
-                    if is_false(window.visible) {
+                if windows_bitmap & 1 == 1 && window.is_defined {
+                    if !window.visible {
                         debug!("[W-{}: 0->1]", i);
-                        window.visible = 1;
+                        window.visible = true;
                         window.update_time_show(timing);
                     } else {
                         debug!("[W-{}: 1->0]", i);
-                        window.visible = 0;
+                        window.visible = false;
                         window.update_time_hide(timing);
-                        if is_false(window.is_empty) {
+                        if !window.is_empty {
                             screen_content_changed = true;
-                            self.copy_to_screen(&self.windows[i as usize]);
+                            self.copy_to_screen(i as usize);
                         }
                     }
                 }
@@ -458,20 +473,19 @@ impl dtvcc_service_decoder {
                 if windows_bitmap & 1 == 1 {
                     debug!("Deleting [W{}]", i);
                     let window = &mut self.windows[i as usize];
-                    let window_had_content = is_true(window.is_defined)
-                        && is_true(window.visible)
-                        && is_false(window.is_empty);
+                    let window_had_content =
+                        window.is_defined && window.visible && !window.is_empty;
                     if window_had_content {
                         screen_content_changed = true;
                         window.update_time_hide(timing);
-                        self.copy_to_screen(&self.windows[i as usize]);
+                        self.copy_to_screen(i as usize);
                         if self.current_window == i as i32 {
                             self.screen_print(encoder, timing);
                         }
                     }
                     let window = &mut self.windows[i as usize];
-                    window.is_defined = 0;
-                    window.visible = 0;
+                    window.is_defined = false;
+                    window.visible = false;
                     window.time_ms_hide = -1;
                     window.time_ms_show = -1;
                     if self.current_window == i as i32 {
@@ -502,12 +516,12 @@ impl dtvcc_service_decoder {
                 if windows_bitmap & 1 == 1 {
                     let window = &mut self.windows[i as usize];
                     debug!("[W{}]", i);
-                    if is_false(window.is_defined) {
+                    if !window.is_defined {
                         error!("Window {} was not defined", i);
                         continue;
                     }
-                    if is_false(window.visible) {
-                        window.visible = 1;
+                    if !window.visible {
+                        window.visible = true;
                         window.update_time_show(timing);
                     }
                 }
@@ -537,7 +551,7 @@ impl dtvcc_service_decoder {
             .zip(block.iter())
             .all(|(x, y)| x == y);
 
-        if is_true(window.is_defined) && is_command_repeated {
+        if window.is_defined && is_command_repeated {
             // When a decoder receives a DefineWindow command for an existing window, the
             // command is to be ignored if the command parameters are unchanged from the
             // previous window definition.
@@ -561,7 +575,7 @@ impl dtvcc_service_decoder {
 
         let mut do_clear_window = false;
 
-        debug!("Visible: [{}]", if is_true(visible) { "Yes" } else { "No" });
+        debug!("Visible: [{}]", if visible == 1 { "Yes" } else { "No" });
         debug!("Priority: [{}]", priority);
         debug!("Row count: [{}]", row_count);
         debug!("Column count: [{}]", col_count);
@@ -570,15 +584,12 @@ impl dtvcc_service_decoder {
         debug!("Anchor horizontal: [{}]", anchor_horizontal);
         debug!(
             "Relative pos: [{}]",
-            if is_true(relative_pos) { "Yes" } else { "No" }
-        );
-        debug!(
-            "Row lock: [{}]",
-            if is_true(row_lock) { "Yes" } else { "No" }
+            if relative_pos == 1 { "Yes" } else { "No" }
         );
+        debug!("Row lock: [{}]", if row_lock == 1 { "Yes" } else { "No" });
         debug!(
             "Column lock: [{}]",
-            if is_true(col_lock) { "Yes" } else { "No" }
+            if col_lock == 1 { "Yes" } else { "No" }
         );
         debug!("Pen style: [{}]", pen_style);
         debug!("Win style: [{}]", win_style);
@@ -593,27 +604,27 @@ impl dtvcc_service_decoder {
         }
 
         window.priority = priority as i32;
-        window.col_lock = col_lock as i32;
-        window.row_lock = row_lock as i32;
-        window.visible = visible as i32;
+        window.col_lock = col_lock == 1;
+        window.row_lock = row_lock == 1;
+        window.visible = visible == 1;
         window.anchor_vertical = anchor_vertical as i32;
-        window.relative_pos = relative_pos as i32;
+        window.relative_pos = relative_pos == 1;
         window.anchor_horizontal = anchor_horizontal as i32;
         window.row_count = row_count as i32;
         window.anchor_point = anchor_point as i32;
         window.col_count = col_count as i32;
 
         // If changing the style of an existing window delete contents
-        if win_style > 0 && is_false(window.is_defined) && window.win_style != win_style as i32 {
+        if win_style > 0 && !window.is_defined && window.win_style != win_style as i32 {
             do_clear_window = true;
         }
 
         /* If the window doesn't exist and win style==0 then default to win_style=1 */
-        if win_style == 0 && is_false(window.is_defined) {
+        if win_style == 0 && !window.is_defined {
             win_style = 1;
         }
         /* If the window doesn't exist and pen style==0 then default to pen_style=1 */
-        if pen_style == 0 && is_false(window.is_defined) {
+        if pen_style == 0 && !window.is_defined {
             pen_style = 1;
         }
 
@@ -631,28 +642,12 @@ impl dtvcc_service_decoder {
             }
             window.pen_style = pen_style as i32;
         }
-        if is_false(window.is_defined) {
+        if !window.is_defined {
             // If the window is being created, all character positions in the window
             // are set to the fill color and the pen location is set to (0,0)
             window.pen_column = 0;
             window.pen_row = 0;
-            if is_false(window.memory_reserved) {
-                for i in 0..CCX_DTVCC_MAX_ROWS as usize {
-                    let layout = Layout::array::<dtvcc_symbol>(CCX_DTVCC_MAX_COLUMNS as usize);
-                    if let Err(e) = layout {
-                        error!("dtvcc_handle_DFx_DefineWindow: Incorrect Layout, {}", e);
-                    } else {
-                        let ptr = unsafe { alloc(layout.unwrap()) };
-                        if ptr.is_null() {
-                            error!("dtvcc_handle_DFx_DefineWindow: Not enough memory",);
-                        }
-                        // Exit here?
-                        window.rows[i] = ptr as *mut dtvcc_symbol;
-                    }
-                }
-                window.memory_reserved = 1;
-            }
-            window.is_defined = 1;
+            window.is_defined = true;
             window.clear_text();
         } else if do_clear_window {
             window.clear_text();
@@ -664,19 +659,9 @@ impl dtvcc_service_decoder {
             .zip(block.iter())
             .for_each(|(command, val)| *command = *val);
 
-        if is_true(window.visible) {
+        if window.visible {
             window.update_time_show(timing);
         }
-        if is_false(window.memory_reserved) {
-            for i in 0..CCX_DTVCC_MAX_ROWS as usize {
-                let layout = Layout::array::<dtvcc_symbol>(CCX_DTVCC_MAX_COLUMNS as usize);
-                if let Err(e) = layout {
-                    error!("dtvcc_handle_DFx_DefineWindow: Incorrect Layout, {}", e);
-                } else {
-                    unsafe { dealloc(window.rows[i] as *mut u8, layout.unwrap()) };
-                }
-            }
-        }
         // ...also makes the defined windows the current window
         self.handle_set_current_window(window_id);
     }
@@ -714,13 +699,13 @@ impl dtvcc_service_decoder {
         }
 
         let pen = &mut window.pen_attribs_pattern;
-        pen.pen_size = pen_size as i32;
-        pen.offset = offset as i32;
-        pen.text_tag = text_tag as i32;
-        pen.font_tag = font_tag as i32;
-        pen.edge_type = edge_type as i32;
-        pen.underline = underline as i32;
-        pen.italic = italic as i32;
+        pen.pen_size = pen_size;
+        pen.offset = offset;
+        pen.text_tag = text_tag;
+        pen.font_tag = font_tag;
+        pen.edge_type = edge_type;
+        pen.underline = underline == 1;
+        pen.italic = italic == 1;
     }
 
     /// SPC Set Pen Color
@@ -755,11 +740,11 @@ impl dtvcc_service_decoder {
         }
 
         let color = &mut window.pen_color_pattern;
-        color.fg_color = fg_color as i32;
-        color.fg_opacity = fg_opacity as i32;
-        color.bg_color = bg_color as i32;
-        color.bg_opacity = bg_opacity as i32;
-        color.edge_color = edge_color as i32;
+        color.fg_color = fg_color;
+        color.fg_opacity = fg_opacity;
+        color.bg_color = bg_color;
+        color.bg_opacity = bg_opacity;
+        color.edge_color = edge_color;
     }
 
     /// SPL Set Pen Location
@@ -817,17 +802,17 @@ impl dtvcc_service_decoder {
         );
 
         let window_attribts = &mut self.windows[self.current_window as usize].attribs;
-        window_attribts.fill_color = fill_color as i32;
-        window_attribts.fill_opacity = fill_opacity as i32;
-        window_attribts.border_color = border_color as i32;
-        window_attribts.justify = justify as i32;
-        window_attribts.scroll_direction = scroll_dir as i32;
-        window_attribts.print_direction = print_dir as i32;
-        window_attribts.word_wrap = word_wrap as i32;
-        window_attribts.border_type = border_type as i32;
-        window_attribts.display_effect = display_eff as i32;
-        window_attribts.effect_direction = effect_dir as i32;
-        window_attribts.effect_speed = effect_speed as i32;
+        window_attribts.fill_color = fill_color;
+        window_attribts.fill_opacity = fill_opacity;
+        window_attribts.border_color = border_color;
+        window_attribts.justify = justify;
+        window_attribts.scroll_direction = scroll_dir;
+        window_attribts.print_direction = print_dir;
+        window_attribts.word_wrap = word_wrap;
+        window_attribts.border_type = border_type;
+        window_attribts.display_effect = display_eff;
+        window_attribts.effect_direction = effect_dir;
+        window_attribts.effect_speed = effect_speed;
     }
 
     /// CWx Set Current Window
@@ -835,7 +820,7 @@ impl dtvcc_service_decoder {
     /// Change current window to the window id provided
     pub fn handle_set_current_window(&mut self, window_id: u8) {
         debug!("dtvcc_handle_CWx_SetCurrentWindow: [{}]", window_id);
-        if is_true(self.windows[window_id as usize].is_defined) {
+        if self.windows[window_id as usize].is_defined {
             self.current_window = window_id as i32;
         } else {
             debug!(
@@ -865,41 +850,40 @@ impl dtvcc_service_decoder {
         for id in 0..CCX_DTVCC_MAX_WINDOWS as usize {
             let window = &mut self.windows[id];
             window.clear_text();
-            window.is_defined = 0;
-            window.visible = 0;
+            window.is_defined = false;
+            window.visible = false;
             window.commands.fill(0);
         }
         self.current_window = -1;
-        unsafe { (*self.tv).clear() };
+        self.tv.clear();
     }
 
     /// Print the contents of tv screen to the output file
     pub fn screen_print(&mut self, encoder: &mut encoder_ctx, timing: &mut ccx_common_timing_ctx) {
         debug!("dtvcc_screen_print rust");
         self.cc_count += 1;
-        unsafe {
-            let tv = &mut (*self.tv);
-            tv.cc_count += 1;
-            let sn = tv.service_number;
-            let writer_ctx = &mut encoder.dtvcc_writers[(sn - 1) as usize];
-
-            tv.update_time_hide(timing.get_visible_end(3));
-            let mut writer = Writer::new(
-                &mut encoder.cea_708_counter,
-                encoder.subs_delay,
-                encoder.write_format,
-                writer_ctx,
-                encoder.no_font_color,
-                &*encoder.transcript_settings,
-                encoder.no_bom,
-            );
-            tv.writer_output(&mut writer).unwrap();
-            tv.clear();
-        }
+        let tv = &mut self.tv;
+        tv.cc_count += 1;
+        let sn = tv.service_number;
+        let writer_ctx = &mut encoder.dtvcc_writers[(sn - 1) as usize];
+
+        tv.update_time_hide(timing.get_visible_end(3));
+        let mut writer = Writer::new(
+            &mut encoder.cea_708_counter,
+            encoder.subs_delay,
+            encoder.write_format,
+            writer_ctx,
+            encoder.no_font_color,
+            unsafe { &*encoder.transcript_settings },
+            encoder.no_bom,
+        );
+        tv.writer_output(&mut writer).unwrap();
+        tv.clear();
     }
 
-    /// Copy the contents of window to the TV screen
-    pub fn copy_to_screen(&self, window: &dtvcc_window) {
+    /// Copy the contents of the window to the TV screen
+    pub fn copy_to_screen(&mut self, window_id: usize) {
+        let window = &self.windows[window_id];
         if self.is_window_overlapping(window) {
             debug!("dtvcc_window_copy_to_screen : window needs to be skipped");
             return;
@@ -972,27 +956,25 @@ impl dtvcc_service_decoder {
         } else {
             window.col_count
         };
+        // Windows anchored outside of the grid leave nothing to copy
+        let copy_rows = copy_rows.clamp(0, CCX_DTVCC_MAX_ROWS as i32) as usize;
+        let copy_cols = copy_cols.clamp(0, CCX_DTVCC_MAX_COLUMNS as i32) as usize;
         debug!("{}*{} will be copied to the TV.", copy_rows, copy_cols);
 
-        unsafe {
-            let tv = &mut *self.tv;
-            for row in 0..copy_rows as usize {
-                for col in 0..CCX_DTVCC_SCREENGRID_COLUMNS as usize {
-                    if col < copy_cols as usize {
-                        tv.chars[top as usize + row][col] = window.rows[row].add(col).read();
-                    }
-                    tv.pen_attribs[top as usize + row][col] = window.pen_attribs[row][col];
-                    tv.pen_colors[top as usize + row][col] = window.pen_colors[row][col];
-                }
-            }
-
-            tv.update_time_show(window.time_ms_show);
-            tv.update_time_hide(window.time_ms_hide);
+        let tv = &mut self.tv;
+        for (row, screen_row) in window.rows[..copy_rows]
+            .iter()
+            .zip(tv.rows.iter_mut().skip(top as usize))
+        {
+            screen_row[..copy_cols].copy_from_slice(&row[..copy_cols]);
         }
+
+        tv.update_time_show(window.time_ms_show);
+        tv.update_time_hide(window.time_ms_hide);
     }
 
     /// Returns `true` if the given window is overlapping other windows
-    pub fn is_window_overlapping(&self, window: &dtvcc_window) -> bool {
+    pub fn is_window_overlapping(&self, window: &Window) -> bool {
         let mut flag = 0;
         let (a_x1, a_x2, a_y1, a_y2) = match window.get_dimensions() {
             Ok(val) => val,
@@ -1016,7 +998,7 @@ impl dtvcc_service_decoder {
                 && (a_x2 > b_x1)
                 && (a_y1 < b_y2)
                 && (a_y2 > b_y1)
-                && is_true(win_compare.visible)
+                && win_compare.visible
             {
                 if win_compare.priority < window.priority {
                     flag = 1
@@ -1031,7 +1013,7 @@ impl dtvcc_service_decoder {
     /// Returns `true` if decoder has any visible window
     pub fn has_visible_windows(&self) -> bool {
         for id in 0..CCX_DTVCC_MAX_WINDOWS {
-            if is_true(self.windows[id as usize].visible) {
+            if self.windows[id as usize].visible {
                 return true;
             }
         }
@@ -1113,47 +1095,43 @@ impl dtvcc_service_decoder {
     /// Process the character and add it to the current window
     pub fn process_character(&mut self, sym: dtvcc_symbol) {
         debug!("{}", self.current_window);
-        let window = &mut self.windows[self.current_window as usize];
-        let window_state = if is_true(window.is_defined) {
-            "OK"
-        } else {
-            "undefined"
-        };
-        let (mut row, mut column) = (-1, -1);
-        if self.current_window != -1 {
-            row = window.pen_row;
-            column = window.pen_column
+        if self.current_window == -1 {
+            debug!(
+                "dtvcc_process_character: [{:04X}] - Window -1 [undefined]",
+                sym.sym
+            );
+            return;
         }
+        let window = &mut self.windows[self.current_window as usize];
+        let window_state = if window.is_defined { "OK" } else { "undefined" };
         debug!(
             "dtvcc_process_character: [{:04X}] - Window {} [{}], Pen: {}:{}",
-            sym.sym, self.current_window, window_state, row, column
+            sym.sym, self.current_window, window_state, window.pen_row, window.pen_column
         );
 
-        if self.current_window == -1 || is_false(window.is_defined) {
+        if !window.is_defined {
             return;
         }
 
-        window.is_empty = 0;
-
-        // Add symbol to window
-        if window.memory_reserved == 1 {
-            unsafe {
-                let ptr: *mut dtvcc_symbol =
-                    window.rows[window.pen_row as usize].add(window.pen_column as usize);
-                *ptr = sym;
-            }
-        } else {
+        let (row, column) = (window.pen_row as usize, window.pen_column as usize);
+        if row >= CCX_DTVCC_MAX_ROWS as usize || column >= CCX_DTVCC_MAX_COLUMNS as usize {
+            warn!(
+                "dtvcc_process_character: Pen {}:{} is outside of the window",
+                window.pen_row, window.pen_column
+            );
             return;
         }
 
-        // "Painting" char by pen - attribs
-        window.pen_attribs[window.pen_row as usize][window.pen_column as usize] =
-            window.pen_attribs_pattern;
-        // "Painting" char by pen - colors
-        window.pen_colors[window.pen_row as usize][window.pen_column as usize] =
-            window.pen_color_pattern;
+        window.is_empty = false;
+
+        // Add symbol to window, "painting" it by pen - attribs and colors
+        window.rows[row][column] = Cell {
+            sym,
+            attribs: window.pen_attribs_pattern,
+            color: window.pen_color_pattern,
+        };
 
-        let pd = match dtvcc_window_pd::new(window.attribs.print_direction) {
+        let pd = match dtvcc_window_pd::new(window.attribs.print_direction as i32) {
             Ok(val) => val,
             Err(e) => {
                 warn!("{}", e);
@@ -1184,96 +1162,73 @@ impl dtvcc_service_decoder {
         };
     }
     /// Flush the decoder of any remaining subtitles
-    pub fn flush(&self, encoder: &mut encoder_ctx) {
-        unsafe {
-            let tv = &mut (*self.tv);
-            let sn = tv.service_number;
-            let writer_ctx = &mut encoder.dtvcc_writers[(sn - 1) as usize];
-
-            let mut writer = Writer::new(
-                &mut encoder.cea_708_counter,
-                encoder.subs_delay,
-                encoder.write_format,
-                writer_ctx,
-                encoder.no_font_color,
-                &*encoder.transcript_settings,
-                encoder.no_bom,
-            );
-            writer.write_done();
+    ///
+    /// Visible windows are printed and the output file is finished
+    pub fn flush(&mut self, encoder: &mut encoder_ctx, timing: &mut ccx_common_timing_ctx) {
+        debug!("dtvcc_decoder_flush: Flushing decoder");
+        let mut screen_content_changed = false;
+        for i in 0..CCX_DTVCC_MAX_WINDOWS as usize {
+            let window = &mut self.windows[i];
+            if window.visible {
+                screen_content_changed = true;
+                window.update_time_hide(timing);
+                self.copy_to_screen(i);
+                self.windows[i].visible = false;
+            }
         }
-    }
-}
-
-/// Flush service decoder
-#[no_mangle]
-extern "C" fn ccxr_flush_decoder(dtvcc: *mut dtvcc_ctx, decoder: *mut dtvcc_service_decoder) {
-    debug!("dtvcc_decoder_flush: Flushing decoder");
-    let timing = unsafe { &mut *((*dtvcc).timing) };
-    let encoder = unsafe { &mut *((*dtvcc).encoder as *mut encoder_ctx) };
-    let decoder = unsafe { &mut *decoder };
-
-    let mut screen_content_changed = false;
-    for i in 0..CCX_DTVCC_MAX_WINDOWS {
-        let window = &mut decoder.windows[i as usize];
-        if is_true(window.visible) {
-            screen_content_changed = true;
-            window.update_time_hide(timing);
-            decoder.copy_to_screen(&decoder.windows[i as usize]);
-            decoder.windows[i as usize].visible = 0
+        if screen_content_changed {
+            self.screen_print(encoder, timing);
         }
+
+        let sn = self.tv.service_number;
+        let writer_ctx = &mut encoder.dtvcc_writers[(sn - 1) as usize];
+        let mut writer = Writer::new(
+            &mut encoder.cea_708_counter,
+            encoder.subs_delay,
+            encoder.write_format,
+            writer_ctx,
+            encoder.no_font_color,
+            unsafe { &*encoder.transcript_settings },
+            encoder.no_bom,
+        );
+        writer.write_done();
     }
-    if screen_content_changed {
-        decoder.screen_print(encoder, timing);
-    }
-    decoder.flush(encoder);
 }
 
 #[cfg(test)]
 mod test {
     use super::*;
-    use crate::utils::get_zero_allocated_obj;
 
-    fn setup_test_decoder_with_memory() -> dtvcc_service_decoder {
-        let mut decoder = get_zero_allocated_obj::<dtvcc_service_decoder>();
+    fn setup_test_decoder() -> ServiceDecoder {
+        let mut decoder = ServiceDecoder::new(1);
 
         decoder.current_window = 0;
-        decoder.windows[0].is_defined = 1;
+        decoder.windows[0].is_defined = true;
         decoder.windows[0].row_count = 4;
         decoder.windows[0].col_count = 4;
         decoder.windows[0].attribs.print_direction =
-            dtvcc_window_pd::DTVCC_WINDOW_PD_LEFT_RIGHT as i32;
-
-        let layout = Layout::array::<dtvcc_symbol>(CCX_DTVCC_MAX_COLUMNS as usize).unwrap();
-        decoder.windows[0].rows[0] = unsafe { alloc(layout) } as *mut dtvcc_symbol;
-        decoder.windows[0].memory_reserved = 1;
+            dtvcc_window_pd::DTVCC_WINDOW_PD_LEFT_RIGHT as u8;
 
-        *decoder
-    }
-
-    fn cleanup_test_decoder(decoder: &mut dtvcc_service_decoder) {
-        let layout = Layout::array::<dtvcc_symbol>(CCX_DTVCC_MAX_COLUMNS as usize).unwrap();
-        unsafe {
-            dealloc(decoder.windows[0].rows[0] as *mut u8, layout);
-        }
+        decoder
     }
 
     // -------------------------- C0 Commands-------------------------
     #[test]
     fn test_process_cr() {
-        let set_tmp_values = |window: &mut dtvcc_window| {
-            window.is_defined = 1;
-            window.visible = 1;
+        let set_tmp_values = |window: &mut Window| {
+            window.is_defined = true;
+            window.visible = true;
             window.row_count = 5;
             window.col_count = 10;
             window.pen_row = 2;
             window.pen_column = 5;
-            window.is_empty = 0;
+            window.is_empty = false;
         };
 
-        let mut decoder = get_zero_allocated_obj::<dtvcc_service_decoder>();
+        let mut decoder = ServiceDecoder::new(1);
         decoder.current_window = 0;
         decoder.windows[0].attribs.print_direction =
-            dtvcc_window_pd::DTVCC_WINDOW_PD_LEFT_RIGHT as i32;
+            dtvcc_window_pd::DTVCC_WINDOW_PD_LEFT_RIGHT as u8;
 
         let mut encoder = encoder_ctx::default();
         let mut timing = ccx_common_timing_ctx::default();
@@ -1283,7 +1238,7 @@ mod test {
         set_tmp_values(&mut decoder.windows[0]);
 
         decoder.windows[0].attribs.print_direction =
-            dtvcc_window_pd::DTVCC_WINDOW_PD_LEFT_RIGHT as i32;
+            dtvcc_window_pd::DTVCC_WINDOW_PD_LEFT_RIGHT as u8;
         decoder.process_cr(&mut encoder, &mut timing, no_rollup);
         assert_eq!(decoder.windows[0].pen_row, 3);
         assert_eq!(decoder.windows[0].pen_column, 0);
@@ -1292,7 +1247,7 @@ mod test {
         set_tmp_values(&mut decoder.windows[0]);
 
         decoder.windows[0].attribs.print_direction =
-            dtvcc_window_pd::DTVCC_WINDOW_PD_RIGHT_LEFT as i32;
+            dtvcc_window_pd::DTVCC_WINDOW_PD_RIGHT_LEFT as u8;
         decoder.process_cr(&mut encoder, &mut timing, no_rollup);
         assert_eq!(decoder.windows[0].pen_row, 3);
         assert_eq!(decoder.windows[0].pen_column, 10);
@@ -1301,7 +1256,7 @@ mod test {
         set_tmp_values(&mut decoder.windows[0]);
 
         decoder.windows[0].attribs.print_direction =
-            dtvcc_window_pd::DTVCC_WINDOW_PD_TOP_BOTTOM as i32;
+            dtvcc_window_pd::DTVCC_WINDOW_PD_TOP_BOTTOM as u8;
         decoder.process_cr(&mut encoder, &mut timing, no_rollup);
         assert_eq!(decoder.windows[0].pen_row, 0);
         assert_eq!(decoder.windows[0].pen_column, 6);
@@ -1310,7 +1265,7 @@ mod test {
         set_tmp_values(&mut decoder.windows[0]);
 
         decoder.windows[0].attribs.print_direction =
-            dtvcc_window_pd::DTVCC_WINDOW_PD_BOTTOM_TOP as i32;
+            dtvcc_window_pd::DTVCC_WINDOW_PD_BOTTOM_TOP as u8;
         decoder.process_cr(&mut encoder, &mut timing, no_rollup);
         assert_eq!(decoder.windows[0].pen_row, 5);
         assert_eq!(decoder.windows[0].pen_column, 6);
@@ -1318,39 +1273,34 @@ mod test {
 
     #[test]
     fn test_process_hcr() {
-        let mut decoder = get_zero_allocated_obj::<dtvcc_service_decoder>();
+        let mut decoder = ServiceDecoder::new(1);
         decoder.current_window = 1;
         decoder.windows[1].pen_column = 12;
         decoder.windows[1].pen_row = 1;
-        decoder.windows[1].rows[1] = Box::into_raw(Box::new(dtvcc_symbol::new(1)));
-        decoder.windows[1].rows[2] = Box::into_raw(Box::new(dtvcc_symbol::new(1)));
-        decoder.windows[1].memory_reserved = 1;
+        decoder.windows[1].rows[1][0].sym = dtvcc_symbol::new(1);
+        decoder.windows[1].rows[2][0].sym = dtvcc_symbol::new(1);
 
         decoder.process_hcr();
 
         assert_eq!(decoder.windows[1].pen_column, 0);
 
         // Ensuring, it erases all text on the row mentioned by `pen_row`
-        assert_eq!(
-            unsafe { decoder.windows[1].rows[1].as_mut() },
-            Some(&mut dtvcc_symbol::default()),
-        );
+        assert_eq!(decoder.windows[1].rows[1][0].sym, dtvcc_symbol::default());
         // Do not clear text for row which is not mentioned by `pen_row`
         assert_eq!(
-            unsafe { decoder.windows[1].rows[2].as_mut() },
-            Some(&mut dtvcc_symbol { sym: 1, init: 1 }),
+            decoder.windows[1].rows[2][0].sym,
+            dtvcc_symbol { sym: 1, init: 1 }
         );
     }
 
     #[test]
     fn test_process_ff() {
-        let mut decoder = get_zero_allocated_obj::<dtvcc_service_decoder>();
+        let mut decoder = ServiceDecoder::new(1);
         decoder.current_window = 1;
         decoder.windows[1].pen_column = 2;
         decoder.windows[1].pen_row = 1;
-        decoder.windows[1].memory_reserved = 1;
-        decoder.windows[1].rows[1] = Box::into_raw(Box::new(dtvcc_symbol::new(1)));
-        decoder.windows[1].rows[2] = Box::into_raw(Box::new(dtvcc_symbol::new(1)));
+        decoder.windows[1].rows[1][0].sym = dtvcc_symbol::new(1);
+        decoder.windows[1].rows[2][0].sym = dtvcc_symbol::new(1);
 
         decoder.process_ff();
 
@@ -1359,19 +1309,14 @@ mod test {
 
         // Ensuring, it erases all text on the rows
         // (Doesn't matter for value of pen_column or pen_row..Just delete all text present)
-        assert_eq!(
-            unsafe { decoder.windows[1].rows[1].as_mut() },
-            Some(&mut dtvcc_symbol::default()),
-        );
-        assert_eq!(
-            unsafe { decoder.windows[1].rows[2].as_mut() },
-            Some(&mut dtvcc_symbol::default()),
-        );
+        assert_eq!(decoder.windows[1].rows[1][0].sym, dtvcc_symbol::default());
+        assert_eq!(decoder.windows[1].rows[2][0].sym, dtvcc_symbol::default());
+        assert!(decoder.windows[1].is_empty);
     }
 
     #[test]
     fn test_process_bs() {
-        let mut decoder = get_zero_allocated_obj::<dtvcc_service_decoder>();
+        let mut decoder = ServiceDecoder::new(1);
         decoder.current_window = 1;
 
         // 0 -> dtvcc_window_pd::DTVCC_WINDOW_PD_LEFT_RIGHT
@@ -1410,55 +1355,51 @@ mod test {
 
     #[test]
     fn test_process_p16() {
-        let mut decoder = setup_test_decoder_with_memory();
+        let mut decoder = setup_test_decoder();
         let block = [b'a', b'b'] as [c_uchar; 2];
 
         decoder.process_p16(&block);
 
         assert_eq!(decoder.windows[0].pen_row, 0);
         assert_eq!(decoder.windows[0].pen_column, 1);
-        unsafe {
-            assert_eq!(
-                *decoder.windows[0].rows[0].add(0),
-                dtvcc_symbol::new_16(block[0], block[1])
-            );
-        }
-
-        cleanup_test_decoder(&mut decoder);
+        assert_eq!(
+            decoder.windows[0].rows[0][0].sym,
+            dtvcc_symbol::new_16(block[0], block[1])
+        );
     }
 
     // -------------------------- C1 Commands-------------------------
     #[test]
     fn test_handle_display_windows() {
-        let mut decoder = get_zero_allocated_obj::<dtvcc_service_decoder>();
+        let mut decoder = ServiceDecoder::new(1);
         let mut timing = ccx_common_timing_ctx::default();
 
-        decoder.windows[0].is_defined = 1;
-        decoder.windows[2].is_defined = 1;
-        decoder.windows[2].visible = 1; // Window 2 is already visible
+        decoder.windows[0].is_defined = true;
+        decoder.windows[2].is_defined = true;
+        decoder.windows[2].visible = true; // Window 2 is already visible
 
         // Test case 1: Display all windows
         let windows_bitmap = 0b00000111;
         decoder.handle_display_windows(windows_bitmap, &mut timing);
 
-        assert_eq!(decoder.windows[0].visible, 1);
-        assert_eq!(decoder.windows[1].visible, 0);
-        assert_eq!(decoder.windows[2].visible, 1);
+        assert!(decoder.windows[0].visible);
+        assert!(!decoder.windows[1].visible);
+        assert!(decoder.windows[2].visible);
 
         // Test case 2: Do nothing with the windows
         let windows_bitmap = 0b00000000;
-        decoder.windows[1].is_defined = 1;
+        decoder.windows[1].is_defined = true;
         decoder.handle_display_windows(windows_bitmap, &mut timing);
 
-        assert_eq!(decoder.windows[0].visible, 1);
+        assert!(decoder.windows[0].visible);
         // Even after window is defined & `windows_bitmap = 0` => it is not visible
-        assert_eq!(decoder.windows[1].visible, 0);
-        assert_eq!(decoder.windows[2].visible, 1);
+        assert!(!decoder.windows[1].visible);
+        assert!(decoder.windows[2].visible);
     }
 
     #[test]
     fn test_handle_define_windows() {
-        let mut decoder = get_zero_allocated_obj::<dtvcc_service_decoder>();
+        let mut decoder = ServiceDecoder::new(1);
         let mut timing = ccx_common_timing_ctx::default();
         let window_id = 1;
         let test_block = [
@@ -1471,11 +1412,11 @@ mod test {
 
         assert_eq!(window.number, window_id as i32);
         assert_eq!(window.priority, 0x7);
-        assert_eq!(window.col_lock, 0x0);
-        assert_eq!(window.row_lock, 0x0);
-        assert_eq!(window.visible, 0x0);
+        assert!(!window.col_lock);
+        assert!(!window.row_lock);
+        assert!(!window.visible);
         assert_eq!(window.anchor_vertical, 64);
-        assert_eq!(window.relative_pos, 0x0);
+        assert!(!window.relative_pos);
         assert_eq!(window.anchor_horizontal, 0x2);
         assert_eq!(window.row_count, 0xb);
         assert_eq!(window.anchor_point, 0x0);
@@ -1484,8 +1425,9 @@ mod test {
         assert_eq!(window.win_style, 0x1);
         assert_eq!(window.pen_row, 0x0);
         assert_eq!(window.pen_column, 0x0);
-        assert_eq!(window.is_defined, 1);
-        assert_eq!(window.memory_reserved, 1);
+        assert!(window.is_defined);
+        assert!(window.is_empty);
+        assert_eq!(decoder.current_window, window_id as i32);
 
         // Check `Command` has been set or not
         assert_eq!(window.commands[0], 0b00000111);
@@ -1498,7 +1440,7 @@ mod test {
 
     #[test]
     fn test_handle_set_pen_attributes() {
-        let mut decoder = get_zero_allocated_obj::<dtvcc_service_decoder>();
+        let mut decoder = ServiceDecoder::new(1);
         let test_block = [0b00111000, 0b11010001];
 
         decoder.current_window = 0;
@@ -1512,13 +1454,13 @@ mod test {
         assert_eq!(pen.text_tag, 0x3);
         assert_eq!(pen.font_tag, 0x1);
         assert_eq!(pen.edge_type, 0x2);
-        assert_eq!(pen.underline, 0x1);
-        assert_eq!(pen.italic, 0x1);
+        assert!(pen.underline);
+        assert!(pen.italic);
     }
 
     #[test]
     fn test_handle_set_pen_color() {
-        let mut decoder = get_zero_allocated_obj::<dtvcc_service_decoder>();
+        let mut decoder = ServiceDecoder::new(1);
         let test_block = [0b00111111, 0b00111110, 0b00111100];
 
         decoder.current_window = 0;
@@ -1536,7 +1478,7 @@ mod test {
 
     #[test]
     fn test_handle_set_pen_location() {
-        let mut decoder = get_zero_allocated_obj::<dtvcc_service_decoder>();
+        let mut decoder = ServiceDecoder::new(1);
         let test_block = [0b00001111, 0b00111111];
         decoder.current_window = 0;
 
@@ -1548,7 +1490,7 @@ mod test {
 
     #[test]
     fn test_handle_set_window_attributes() {
-        let mut decoder = get_zero_allocated_obj::<dtvcc_service_decoder>();
+        let mut decoder = ServiceDecoder::new(1);
         decoder.current_window = 0;
         let test_block = [
             0b00111111, // fill_color, fill_opacity
@@ -1576,10 +1518,10 @@ mod test {
 
     #[test]
     fn test_handle_set_current_window() {
-        let mut decoder = get_zero_allocated_obj::<dtvcc_service_decoder>();
+        let mut decoder = ServiceDecoder::new(1);
 
         let window_id = 2;
-        decoder.windows[window_id].is_defined = 1;
+        decoder.windows[window_id].is_defined = true;
         decoder.current_window = 5;
 
         decoder.handle_set_current_window(window_id as u8);
@@ -1589,44 +1531,47 @@ mod test {
 
     #[test]
     fn test_handle_reset() {
-        let mut decoder = get_zero_allocated_obj::<dtvcc_service_decoder>();
+        let mut decoder = ServiceDecoder::new(1);
 
         // Set random values in decoder
         decoder.current_window = 0;
         decoder.windows.iter_mut().for_each(|window| {
-            window.visible = 1;
-            window.is_defined = 1;
-            window.visible = 1;
+            window.visible = true;
+            window.is_defined = true;
+            window.visible = true;
             window.commands.fill(1);
         });
-        decoder.tv = Box::into_raw(get_zero_allocated_obj::<dtvcc_tv_screen>());
+        decoder.tv.rows[0][0].sym = dtvcc_symbol::new(0x41);
+        decoder.tv.time_ms_show = 1000;
 
         decoder.handle_reset();
 
         // Test if reset perfectly works or not?
         assert_eq!(decoder.current_window, -1);
         decoder.windows.iter_mut().for_each(|window| {
-            assert_eq!(window.visible, 0);
-            assert_eq!(window.is_defined, 0);
+            assert!(!window.visible);
+            assert!(!window.is_defined);
             assert!(window.commands.iter().all(|&c| c == 0));
         });
+        assert!(decoder.tv.is_row_empty(0));
+        assert_eq!(decoder.tv.time_ms_show, -1);
     }
 
     #[test]
     fn test_is_window_overlapping() {
-        let mut decoder = get_zero_allocated_obj::<dtvcc_service_decoder>();
+        let mut decoder = ServiceDecoder::new(1);
 
         // Non-overlapping windows
-        decoder.windows[0].is_defined = 1;
-        decoder.windows[0].visible = 1;
+        decoder.windows[0].is_defined = true;
+        decoder.windows[0].visible = true;
         decoder.windows[0].anchor_vertical = 2;
         decoder.windows[0].anchor_horizontal = 2;
         decoder.windows[0].row_count = 5;
         decoder.windows[0].col_count = 10;
         assert!(!decoder.is_window_overlapping(&decoder.windows[0]));
 
-        decoder.windows[1].is_defined = 1;
-        decoder.windows[1].visible = 1;
+        decoder.windows[1].is_defined = true;
+        decoder.windows[1].visible = true;
         decoder.windows[1].anchor_vertical = 10;
         decoder.windows[1].anchor_horizontal = 10;
         decoder.windows[1].row_count = 3;
@@ -1634,8 +1579,8 @@ mod test {
         assert!(!decoder.is_window_overlapping(&decoder.windows[1]));
 
         // Overlapping windows
-        decoder.windows[2].is_defined = 1;
-        decoder.windows[2].visible = 1;
+        decoder.windows[2].is_defined = true;
+        decoder.windows[2].visible = true;
         decoder.windows[2].anchor_vertical = 3;
         decoder.windows[2].anchor_horizontal = 3;
         decoder.windows[2].row_count = 3;
@@ -1643,8 +1588,8 @@ mod test {
         decoder.windows[2].priority = 1;
         assert!(decoder.is_window_overlapping(&decoder.windows[2]));
 
-        decoder.windows[3].is_defined = 1;
-        decoder.windows[3].visible = 1;
+        decoder.windows[3].is_defined = true;
+        decoder.windows[3].visible = true;
         decoder.windows[3].anchor_vertical = 4;
         decoder.windows[3].anchor_horizontal = 4;
         decoder.windows[3].row_count = 3;
@@ -1655,20 +1600,20 @@ mod test {
 
     #[test]
     fn test_has_visible_windows() {
-        let mut decoder = get_zero_allocated_obj::<dtvcc_service_decoder>();
+        let mut decoder = ServiceDecoder::new(1);
 
         // Default case - No windows is visible
         assert!(!decoder.has_visible_windows());
 
         // Make 1 window visible
-        decoder.windows[0].visible = 1;
+        decoder.windows[0].visible = true;
         assert!(decoder.has_visible_windows());
     }
 
     // -------------------------- G0, G1 and extended Commands-------------------------
     #[test]
     fn test_handle_G0() {
-        let mut decoder = setup_test_decoder_with_memory();
+        let mut decoder = setup_test_decoder();
 
         // Case: block[0] == 0x7F
         let block = [0x7F, 0x61];
@@ -1676,28 +1621,22 @@ mod test {
 
         assert_eq!(decoder.windows[0].pen_row, 0);
         assert_eq!(decoder.windows[0].pen_column, 1);
-        unsafe {
-            assert_eq!(
-                decoder.windows[0].rows[0].add(0).read().sym,
-                CCX_DTVCC_MUSICAL_NOTE_CHAR
-            );
-        }
+        assert_eq!(
+            decoder.windows[0].rows[0][0].sym.sym,
+            CCX_DTVCC_MUSICAL_NOTE_CHAR
+        );
 
         // Case: block[0] != 0x7F
         let block = [0x60, 0x61];
         let return_value = decoder.handle_G0(&block);
 
         assert_eq!(return_value, 1);
-        unsafe {
-            assert_eq!(decoder.windows[0].rows[0].add(1).read().sym, 96);
-        }
-
-        cleanup_test_decoder(&mut decoder);
+        assert_eq!(decoder.windows[0].rows[0][1].sym.sym, 96);
     }
 
     #[test]
     fn test_handle_G1() {
-        let mut decoder = setup_test_decoder_with_memory();
+        let mut decoder = setup_test_decoder();
 
         let block = [0x7F, 0x61];
         let return_value = decoder.handle_G1(&block);
@@ -1705,16 +1644,12 @@ mod test {
         assert_eq!(return_value, 1);
         assert_eq!(decoder.windows[0].pen_row, 0);
         assert_eq!(decoder.windows[0].pen_column, 1);
-        unsafe {
-            assert_eq!(decoder.windows[0].rows[0].add(0).read().sym, 0x7F);
-        }
-
-        cleanup_test_decoder(&mut decoder);
+        assert_eq!(decoder.windows[0].rows[0][0].sym.sym, 0x7F);
     }
 
     #[test]
     fn test_handle_extended_char() {
-        let mut decoder = setup_test_decoder_with_memory();
+        let mut decoder = setup_test_decoder();
 
         // 0..=0x1F
         let return_value = decoder.handle_extended_char(&[0x1A, 0x61]);
@@ -1725,9 +1660,7 @@ mod test {
         assert_eq!(return_value, 1);
         assert_eq!(decoder.windows[0].pen_row, 0);
         assert_eq!(decoder.windows[0].pen_column, 1);
-        unsafe {
-            assert_eq!(decoder.windows[0].rows[0].add(0).read().sym, 0x5);
-        }
+        assert_eq!(decoder.windows[0].rows[0][0].sym.sym, 0x5);
 
         // 0x80..=0x9F
         let return_value = decoder.handle_extended_char(&[0x86, 0x61]);
@@ -1738,49 +1671,69 @@ mod test {
         assert_eq!(return_value, 1);
         assert_eq!(decoder.windows[0].pen_row, 0);
         assert_eq!(decoder.windows[0].pen_column, 2);
-        unsafe {
-            assert_eq!(decoder.windows[0].rows[0].add(1).read().sym, 0x20);
-        }
-
-        cleanup_test_decoder(&mut decoder);
+        assert_eq!(decoder.windows[0].rows[0][1].sym.sym, 0x20);
     }
 
     #[test]
     fn test_process_character() {
-        let mut decoder = get_zero_allocated_obj::<dtvcc_service_decoder>();
+        let mut decoder = ServiceDecoder::new(1);
         let sym = dtvcc_symbol::new(0x41);
 
+        // No current window case
+        decoder.process_character(sym);
+
         // Undefined window case
-        decoder.windows[0].is_defined = 0;
+        decoder.current_window = 0;
         decoder.process_character(sym);
 
         // No changes occurred
-        assert!(decoder.windows[0].rows[0].is_null());
+        assert!(decoder.windows[0].is_empty);
+        assert_eq!(decoder.windows[0].rows[0][0], Cell::default());
         assert_eq!(decoder.windows[0].pen_row, 0);
         assert_eq!(decoder.windows[0].pen_column, 0);
 
         // Valid window case
-        decoder.current_window = 0;
-        decoder.windows[0].is_defined = 1;
+        decoder.windows[0].is_defined = true;
         decoder.windows[0].row_count = 4;
         decoder.windows[0].col_count = 4;
         decoder.windows[0].attribs.print_direction =
-            dtvcc_window_pd::DTVCC_WINDOW_PD_LEFT_RIGHT as i32;
-
-        let layout = Layout::array::<dtvcc_symbol>(CCX_DTVCC_MAX_COLUMNS as usize).unwrap();
-        decoder.windows[0].rows[0] = unsafe { alloc(layout) } as *mut dtvcc_symbol;
-        decoder.windows[0].memory_reserved = 1;
+            dtvcc_window_pd::DTVCC_WINDOW_PD_LEFT_RIGHT as u8;
+        decoder.windows[0].pen_color_pattern.fg_color = 0x30;
 
         decoder.process_character(sym);
 
         // Check changes
+        assert!(!decoder.windows[0].is_empty);
         assert_eq!(decoder.windows[0].pen_row, 0);
         assert_eq!(decoder.windows[0].pen_column, 1);
-        unsafe {
-            assert_eq!(
-                decoder.windows[0].rows[0].add(0).read(),
-                dtvcc_symbol::new(0x41)
-            );
-        }
+        assert_eq!(decoder.windows[0].rows[0][0].sym, dtvcc_symbol::new(0x41));
+        assert_eq!(decoder.windows[0].rows[0][0].color.fg_color, 0x30);
+
+        // Pen outside of the window storage
+        decoder.windows[0].pen_row = CCX_DTVCC_MAX_ROWS as i32;
+        decoder.process_character(sym);
+        assert_eq!(decoder.windows[0].pen_row, CCX_DTVCC_MAX_ROWS as i32);
+    }
+
+    #[test]
+    fn test_copy_to_screen() {
+        let mut decoder = setup_test_decoder();
+        decoder.windows[0].anchor_vertical = 10;
+        decoder.windows[0].anchor_horizontal = 20;
+        decoder.windows[0].time_ms_show = 1000;
+        decoder.windows[0].time_ms_hide = 2000;
+        decoder.windows[0].pen_attribs_pattern.italic = true;
+        decoder.handle_G0(&[0x41]);
+        decoder.handle_G0(&[0x42]);
+
+        decoder.copy_to_screen(0);
+
+        let tv = &decoder.tv;
+        assert_eq!(tv.rows[10][0].sym, dtvcc_symbol::new(0x41));
+        assert_eq!(tv.rows[10][1].sym, dtvcc_symbol::new(0x42));
+        assert!(tv.rows[10][1].attribs.italic);
+        assert!(tv.is_row_empty(11));
+        assert_eq!(tv.time_ms_show, 1000);
+        assert_eq!(tv.time_ms_hide, 2000);
     }
 }
@@ -1,5 +1,7 @@
 //! Utilty functions to get timing for captions
 
+use std::io::Write;
+
 use crate::{bindings::*, cb_708, cb_field1, cb_field2};
 
 use log::{debug, error};
@@ -41,11 +43,43 @@ impl ccx_common_timing_ctx {
 
 /// Returns a hh:mm:ss,ms string of time
 pub fn get_time_str(time: LLONG) -> String {
+    let mut buf = Vec::with_capacity(12);
+    write_time_str(&mut buf, time);
+    String::from_utf8(buf).unwrap_or_default()
+}
+
+/// Append a hh:mm:ss,ms string of time to `buf`
+///
+/// Same output as [`get_time_str`], without allocating a new `String`
+pub fn write_time_str(buf: &mut Vec<u8>, time: LLONG) {
     let hh = time / 1000 / 60 / 60;
     let mm = time / 1000 / 60 - 60 * hh;
     let ss = time / 1000 - 60 * (mm + 60 * hh);
     let ms = time - 1000 * (ss + 60 * (mm + 60 * hh));
-    format!("{hh:02}:{mm:02}:{ss:02},{ms:03}")
+    if time < 0 {
+        // Negative fields are rare, leave their formatting to the std formatter
+        let _ = write!(buf, "{hh:02}:{mm:02}:{ss:02},{ms:03}");
+        return;
+    }
+    write_padded(buf, hh as u64, 2);
+    buf.push(b':');
+    write_padded(buf, mm as u64, 2);
+    buf.push(b':');
+    write_padded(buf, ss as u64, 2);
+    buf.push(b',');
+    write_padded(buf, ms as u64, 3);
+}
+
+/// Append `value` to `buf` in decimal, zero padded to at least `width` digits
+fn write_padded(buf: &mut Vec<u8>, mut value: u64, width: usize) {
+    let mut digits = [b'0'; 20];
+    let mut len = 0;
+    while value > 0 || len < width {
+        digits[len] = b'0' + (value % 10) as u8;
+        value /= 10;
+        len += 1;
+    }
+    buf.extend(digits[..len].iter().rev());
 }
 
 impl ccx_boundary_time {
@@ -77,13 +111,34 @@ impl PartialEq for ccx_boundary_time {
 
 /// Returns a hh:mm:ss;frame string of time for SCC format
 pub fn get_scc_time_str(time: ccx_boundary_time) -> String {
+    let mut buf = Vec::with_capacity(11);
+    write_scc_time_str(&mut buf, time);
+    String::from_utf8(buf).unwrap_or_default()
+}
+
+/// Append a hh:mm:ss;frame string of time for SCC format to `buf`
+pub fn write_scc_time_str(buf: &mut Vec<u8>, time: ccx_boundary_time) {
     // Feel sorry for formatting:(
     let frame: u8 = (((time.time_in_ms
         - 1000 * ((time.ss as i64) + 60 * ((time.mm as i64) + 60 * (time.hh as i64))))
         as f64)
         * 29.97
         / 1000.0) as u8;
-    format!("{:02}:{:02}:{:02};{:02}", time.hh, time.mm, time.ss, frame)
+    if time.hh < 0 || time.mm < 0 || time.ss < 0 {
+        let _ = write!(
+            buf,
+            "{:02}:{:02}:{:02};{:02}",
+            time.hh, time.mm, time.ss, frame
+        );
+        return;
+    }
+    write_padded(buf, time.hh as u64, 2);
+    buf.push(b':');
+    write_padded(buf, time.mm as u64, 2);
+    buf.push(b':');
+    write_padded(buf, time.ss as u64, 2);
+    buf.push(b';');
+    write_padded(buf, frame as u64, 2);
 }
 
 #[cfg(test)]
@@ -140,6 +195,15 @@ mod test {
         assert_eq!(get_time_str(60000), "00:01:00,000");
         assert_eq!(get_time_str(3600000), "01:00:00,000");
         assert_eq!(get_time_str(86400000), "24:00:00,000");
+        assert_eq!(get_time_str(360000000), "100:00:00,000");
+        assert_eq!(get_time_str(-1), "00:00:00,-01");
+    }
+
+    #[test]
+    fn test_write_time_str() {
+        let mut buf = b"x ".to_vec();
+        write_time_str(&mut buf, 3723004);
+        assert_eq!(buf, b"x 01:02:03,004");
     }
 
     #[test]
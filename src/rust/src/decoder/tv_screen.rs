@@ -8,10 +8,11 @@ use std::cmp::Ordering;
 use std::os::unix::prelude::IntoRawFd;
 #[cfg(windows)]
 use std::os::windows::io::IntoRawHandle;
-use std::{ffi::CStr, fs::File};
+use std::{ffi::CStr, fs::File, io::Write};
 
 use super::output::{color_to_hex, write_char, Writer};
-use super::timing::{get_scc_time_str, get_time_str};
+use super::timing::{get_time_str, write_scc_time_str, write_time_str};
+use super::window::{Cell, PenAttribs, PenColor};
 use super::{CCX_DTVCC_SCREENGRID_COLUMNS, CCX_DTVCC_SCREENGRID_ROWS};
 use crate::{
     bindings::*,
@@ -21,11 +22,39 @@ use encoding_rs::Encoding;
 
 use log::{debug, warn};
 
-impl dtvcc_tv_screen {
+/// TV screen of a service decoder
+///
+/// Windows are copied onto the screen when their captions are displayed, and the screen is
+/// written to the output file by [`screen_print`](super::service_decoder::ServiceDecoder::screen_print)
+pub struct TvScreen {
+    /// Screen grid, row by row
+    pub rows: Vec<[Cell; CCX_DTVCC_SCREENGRID_COLUMNS as usize]>,
+    pub time_ms_show: LLONG,
+    pub time_ms_hide: LLONG,
+    /// Number of captions printed from this screen
+    pub cc_count: u32,
+    pub service_number: i32,
+}
+
+impl TvScreen {
+    /// Create an empty TV screen for the service
+    pub fn new(service_number: i32) -> Self {
+        Self {
+            rows: vec![
+                [Cell::default(); CCX_DTVCC_SCREENGRID_COLUMNS as usize];
+                CCX_DTVCC_SCREENGRID_ROWS as usize
+            ],
+            time_ms_show: -1,
+            time_ms_hide: -1,
+            cc_count: 0,
+            service_number,
+        }
+    }
+
     /// Clear all text from TV screen
     pub fn clear(&mut self) {
-        for row in 0..CCX_DTVCC_SCREENGRID_ROWS as usize {
-            self.chars[row].fill(dtvcc_symbol::default());
+        for row in self.rows.iter_mut() {
+            row.fill(Cell::default());
         }
         self.time_ms_hide = -1;
         self.time_ms_show = -1;
@@ -33,9 +62,11 @@ impl dtvcc_tv_screen {
 
     /// Update TV screen show time
     pub fn update_time_show(&mut self, time: LLONG) {
-        let prev_time_str = get_time_str(self.time_ms_show);
-        let curr_time_str = get_time_str(time);
-        debug!("Screen show time: {} -> {}", prev_time_str, curr_time_str);
+        debug!(
+            "Screen show time: {} -> {}",
+            get_time_str(self.time_ms_show),
+            get_time_str(time)
+        );
         if self.time_ms_show == -1 || self.time_ms_show > time {
             self.time_ms_show = time;
         }
@@ -43,9 +74,11 @@ impl dtvcc_tv_screen {
 
     /// Update TV screen hide time
     pub fn update_time_hide(&mut self, time: LLONG) {
-        let prev_time_str = get_time_str(self.time_ms_hide);
-        let curr_time_str = get_time_str(time);
-        debug!("Screen hide time: {} -> {}", prev_time_str, curr_time_str);
+        debug!(
+            "Screen hide time: {} -> {}",
+            get_time_str(self.time_ms_hide),
+            get_time_str(time)
+        );
         if self.time_ms_hide == -1 || self.time_ms_hide < time {
             self.time_ms_hide = time;
         }
@@ -105,27 +138,19 @@ impl dtvcc_tv_screen {
 
     /// Returns the bounds in which captions are present
     pub fn get_write_interval(&self, row_index: usize) -> (usize, usize) {
-        let mut first = 0;
-        let mut last = 0;
-
-        for col in 0..CCX_DTVCC_SCREENGRID_COLUMNS as usize {
-            if self.chars[row_index][col].is_set() {
-                first = col;
-                break;
-            }
-        }
-        for col in (0..(CCX_DTVCC_SCREENGRID_COLUMNS as usize - 1)).rev() {
-            if self.chars[row_index][col].is_set() {
-                last = col;
-                break;
-            }
-        }
+        let row = &self.rows[row_index];
+        let first = row.iter().position(|cell| cell.sym.is_set()).unwrap_or(0);
+        let last = row[..CCX_DTVCC_SCREENGRID_COLUMNS as usize - 1]
+            .iter()
+            .rposition(|cell| cell.sym.is_set())
+            .unwrap_or(0);
         (first, last)
     }
 
     /// Write captions according to the output file type
     ///
-    /// Calls the respective function for the output file type
+    /// Calls the respective function for the output file type.
+    /// The caption is rendered into the writer's buffer and written to the file at once.
     pub fn write(&self, writer: &mut Writer) {
         let result = match writer.write_format {
             ccx_output_format::CCX_OF_SRT => self.write_srt(writer),
@@ -137,12 +162,13 @@ impl dtvcc_tv_screen {
                 Err("Unsupported write format".to_owned())
             }
         };
-        if let Err(err) = result {
+        let flushed = writer.flush_buf();
+        if let Err(err) = result.and(flushed) {
             warn!("{}", err);
         }
     }
 
-    /// Write all captions from the row to the output file
+    /// Render all captions from the row into the writer's buffer
     ///
     /// If use_colors is 'true' then <font color="xxx"></font> tags are added to the output
     pub fn write_row(
@@ -151,78 +177,54 @@ impl dtvcc_tv_screen {
         row_index: usize,
         use_colors: bool,
     ) -> Result<(), String> {
-        let mut buf = Vec::new();
-        let mut pen_color = dtvcc_pen_color::default();
-        let mut pen_attribs = dtvcc_pen_attribs::default();
+        let no_font_color = writer.no_font_color;
+        let start = writer.buf.len();
+        let buf = &mut writer.buf;
+        let mut pen_color = PenColor::default();
+        let mut pen_attribs = PenAttribs::default();
         let (first, last) = self.get_write_interval(row_index);
         debug!("First: {}, Last: {}", first, last);
 
         for i in 0..last + 1 {
             if use_colors {
-                self.change_pen_color(
-                    &pen_color,
-                    writer.no_font_color,
-                    row_index,
-                    i,
-                    false,
-                    &mut buf,
-                );
+                self.change_pen_color(&pen_color, no_font_color, row_index, i, false, buf);
             }
-            self.change_pen_attribs(
-                &pen_attribs,
-                writer.no_font_color,
-                row_index,
-                i,
-                false,
-                &mut buf,
-            );
-            self.change_pen_attribs(
-                &pen_attribs,
-                writer.no_font_color,
-                row_index,
-                i,
-                true,
-                &mut buf,
-            );
+            self.change_pen_attribs(&pen_attribs, no_font_color, row_index, i, false, buf);
+            self.change_pen_attribs(&pen_attribs, no_font_color, row_index, i, true, buf);
             if use_colors {
-                self.change_pen_color(
-                    &pen_color,
-                    writer.no_font_color,
-                    row_index,
-                    i,
-                    true,
-                    &mut buf,
-                )
+                self.change_pen_color(&pen_color, no_font_color, row_index, i, true, buf)
             }
-            pen_color = self.pen_colors[row_index][i];
-            pen_attribs = self.pen_attribs[row_index][i];
+            let cell = &self.rows[row_index][i];
+            pen_color = cell.color;
+            pen_attribs = cell.attribs;
             if i < first {
                 buf.push(b' ');
             } else {
-                write_char(&self.chars[row_index][i], &mut buf)
+                write_char(&cell.sym, buf)
             }
         }
         // there can be unclosed tags or colors after the last symbol in a row
         if use_colors {
             self.change_pen_color(
                 &pen_color,
-                writer.no_font_color,
+                no_font_color,
                 row_index,
                 CCX_DTVCC_SCREENGRID_COLUMNS as usize,
                 false,
-                &mut buf,
+                buf,
             )
         }
         self.change_pen_attribs(
             &pen_attribs,
-            writer.no_font_color,
+            no_font_color,
             row_index,
             CCX_DTVCC_SCREENGRID_COLUMNS as usize,
             false,
-            &mut buf,
+            buf,
         );
         // Tags can still be crossed e.g <f><i>text</f></i>, but testing HTML code has shown that they still are handled correctly.
         if writer.writer_ctx.cd != (-1_isize) as iconv_t {
+            let row = writer.buf.split_off(start);
             if writer.writer_ctx.charset.is_null() {
                 debug!("Charset: null");
             } else {
@@ -235,18 +237,16 @@ impl dtvcc_tv_screen {
 
                 // Look up the encoding by label (name)
                 if let Some(encoding) = Encoding::for_label(charset.as_bytes()) {
-                    let (cow, _encoding_used, had_errors) = encoding.decode(&buf);
+                    let (cow, _encoding_used, had_errors) = encoding.decode(&row);
                     if had_errors {
                         println!("Warning: Had errors during encoding from {charset} to UTF-8");
                     }
                     if _encoding_used != encoding {
                         println!("Warning: Encoding specified ({}) does not match encoding detected ({})",charset,_encoding_used.name());
                     }
-                    writer.write_to_file(cow.as_bytes())?;
+                    writer.buf.extend_from_slice(cow.as_bytes());
                 }
             }
-        } else {
-            writer.write_to_file(&buf)?;
         }
 
         Ok(())
@@ -254,74 +254,64 @@ impl dtvcc_tv_screen {
 
     /// Write captions in SRT format
     pub fn write_srt(&self, writer: &mut Writer) -> Result<(), String> {
-        if self.is_screen_empty(writer) {
+        let rows = self.non_empty_rows();
+        if self.is_screen_empty(rows, writer) {
             return Ok(());
         }
         if self.time_ms_show + writer.subs_delay < 0 {
             return Ok(());
         }
 
-        let time_show = get_time_str(self.time_ms_show);
-        let time_hide = get_time_str(self.time_ms_hide);
-
         let counter = *writer.cea_708_counter;
-        let line = format!(
-            "{}{}{} --> {}{}",
-            counter, "\r\n", time_show, time_hide, "\r\n"
-        );
-        writer.write_to_file(line.as_bytes())?;
+        let _ = write!(writer.buf, "{counter}\r\n");
+        write_time_str(&mut writer.buf, self.time_ms_show);
+        writer.buf.extend_from_slice(b" --> ");
+        write_time_str(&mut writer.buf, self.time_ms_hide);
+        writer.buf.extend_from_slice(b"\r\n");
 
-        for row_index in 0..CCX_DTVCC_SCREENGRID_ROWS as usize {
-            if !self.is_row_empty(row_index) {
-                self.write_row(writer, row_index, true)?;
-                writer.write_to_file(b"\r\n")?;
-            }
+        for row_index in row_indexes(rows) {
+            self.write_row(writer, row_index, true)?;
+            writer.buf.extend_from_slice(b"\r\n");
         }
-        writer.write_to_file(b"\r\n")?;
+        writer.buf.extend_from_slice(b"\r\n");
         Ok(())
     }
 
     /// Write captions in Transcripts format
     pub fn write_transcript(&self, writer: &mut Writer) -> Result<(), String> {
-        if self.is_screen_empty(writer) {
+        let rows = self.non_empty_rows();
+        if self.is_screen_empty(rows, writer) {
             return Ok(());
         }
         if self.time_ms_show + writer.subs_delay < 0 {
             return Ok(());
         }
 
-        let time_show = get_time_str(self.time_ms_show);
-        let time_hide = get_time_str(self.time_ms_hide);
-
-        for row_index in 0..CCX_DTVCC_SCREENGRID_ROWS as usize {
-            if !self.is_row_empty(row_index) {
-                let mut buf = String::new();
-
-                if is_true(writer.transcript_settings.showStartTime) {
-                    buf.push_str(&time_show);
-                    buf.push('|');
-                }
-                if is_true(writer.transcript_settings.showEndTime) {
-                    buf.push_str(&time_hide);
-                    buf.push('|');
-                }
-                if is_true(writer.transcript_settings.showCC) {
-                    buf.push_str("CC1|"); //always CC1 because CEA-708 is field-independent
-                }
-                if is_true(writer.transcript_settings.showMode) {
-                    buf.push_str("POP|"); //TODO caption mode(pop, rollup, etc.)
-                }
-                writer.write_to_file(buf.as_bytes())?;
-                self.write_row(writer, row_index, false)?;
-                writer.write_to_file(b"\r\n")?;
+        for row_index in row_indexes(rows) {
+            if is_true(writer.transcript_settings.showStartTime) {
+                write_time_str(&mut writer.buf, self.time_ms_show);
+                writer.buf.push(b'|');
+            }
+            if is_true(writer.transcript_settings.showEndTime) {
+                write_time_str(&mut writer.buf, self.time_ms_hide);
+                writer.buf.push(b'|');
+            }
+            if is_true(writer.transcript_settings.showCC) {
+                writer.buf.extend_from_slice(b"CC1|"); //always CC1 because CEA-708 is field-independent
             }
+            if is_true(writer.transcript_settings.showMode) {
+                writer.buf.extend_from_slice(b"POP|"); //TODO caption mode(pop, rollup, etc.)
+            }
+            self.write_row(writer, row_index, false)?;
+            writer.buf.extend_from_slice(b"\r\n");
         }
         Ok(())
     }
 
     /// Write captions in SAMI format
     pub fn write_sami(&self, writer: &mut Writer) -> Result<(), String> {
-        if self.is_screen_empty(writer) {
+        let rows = self.non_empty_rows();
+        if self.is_screen_empty(rows, writer) {
             return Err("Sami:- Screen is empty".to_owned());
         }
         if self.time_ms_show + writer.subs_delay < 0 {
@@ -333,23 +323,21 @@ impl dtvcc_tv_screen {
         if self.cc_count == 1 {
             self.write_sami_header(writer)?;
         }
-        let buf = format!(
+        let _ = write!(
+            writer.buf,
             "<sync start={}><p class=\"unknowncc\">\r\n",
             self.time_ms_show + writer.subs_delay
         );
-        writer.write_to_file(buf.as_bytes())?;
 
-        for row_index in 0..CCX_DTVCC_SCREENGRID_ROWS as usize {
-            if !self.is_row_empty(row_index) {
-                self.write_row(writer, row_index, true)?;
-                writer.write_to_file("<br>\r\n".as_bytes())?;
-            }
+        for row_index in row_indexes(rows) {
+            self.write_row(writer, row_index, true)?;
+            writer.buf.extend_from_slice(b"<br>\r\n");
         }
-        let buf = format!(
+        let _ = write!(
+            writer.buf,
             "<sync start={}><p class=\"unknowncc\">&nbsp;</p></sync>\r\n\r\n",
             self.time_ms_hide + writer.subs_delay
         );
-        writer.write_to_file(buf.as_bytes())?;
         Ok(())
     }
 
@@ -367,14 +355,12 @@ impl dtvcc_tv_screen {
                             </head>\r\n\r\n\
                             <body>\r\n";
 
-        writer.write_to_file(buf)?;
+        writer.buf.extend_from_slice(buf);
         Ok(())
     }
 
     fn count_captions_lines_scc(&self) -> usize {
-        (0..CCX_DTVCC_SCREENGRID_ROWS)
-            .filter(|&row_index| !self.is_row_empty(row_index as usize))
-            .count()
+        self.non_empty_rows().count_ones() as usize
     }
 
     /// Write captions in SCC format
@@ -398,37 +384,38 @@ impl dtvcc_tv_screen {
         // 2 line length subtitles can be placed in 14th and 15th row
         // 3 line length subtitles can be placed in 13th, 14th and 15th row
         fn add_needed_scc_labels(
-            buf: &mut String,
+            buf: &mut Vec<u8>,
             total_subtitle_count: usize,
             current_subtitle_count: usize,
         ) {
             match total_subtitle_count {
                 // row 15, column 00
-                1 => buf.push_str(" 94e0 94e0"),
+                1 => buf.extend_from_slice(b" 94e0 94e0"),
                 2 => {
                     if current_subtitle_count == 1 {
                         // row 14, column 00
-                        buf.push_str(" 9440 9440");
+                        buf.extend_from_slice(b" 9440 9440");
                     } else {
                         // row 15, column 00
-                        buf.push_str(" 94e0 94e0")
+                        buf.extend_from_slice(b" 94e0 94e0")
                     }
                 }
                 _ => {
                     if current_subtitle_count == 1 {
                         // row 13, column 04
-                        buf.push_str(" 13e0 13e0");
+                        buf.extend_from_slice(b" 13e0 13e0");
                     } else if current_subtitle_count == 2 {
                         // row 14, column 00
-                        buf.push_str(" 9440 9440");
+                        buf.extend_from_slice(b" 9440 9440");
                     } else {
                         // row 15, column 00
-                        buf.push_str(" 94e0 94e0")
+                        buf.extend_from_slice(b" 94e0 94e0")
                     }
                 }
             }
         }
-        if self.is_screen_empty(writer) {
+        let rows = self.non_empty_rows();
+        if self.is_screen_empty(rows, writer) {
             return Ok(());
         }
 
@@ -437,14 +424,14 @@ impl dtvcc_tv_screen {
         }
 
         if self.cc_count == 2 {
-            writer.write_to_file(b"Scenarist_SCC V1.0\n\n")?;
+            writer.buf.extend_from_slice(b"Scenarist_SCC V1.0\n\n");
         }
 
         if writer.old_cc_time_end == 0 {
             writer.old_cc_time_end = self.time_ms_show as i32;
         }
 
-        let mut buf = String::new();
+        let buf = &mut writer.buf;
         let mut time_show = ccx_boundary_time::get_time(self.time_ms_show);
         let time_end = ccx_boundary_time::get_time(self.time_ms_hide);
 
@@ -453,62 +440,61 @@ impl dtvcc_tv_screen {
             Ordering::Greater => {
                 // Correct the frame delay
                 time_show.time_in_ms -= 1000 / 29.97 as i64;
-                buf.push_str(&(get_scc_time_str(time_show) + "\t942c 942c ").to_owned());
+                write_scc_time_str(buf, time_show);
+                buf.extend_from_slice(b"\t942c 942c ");
                 time_show.time_in_ms += 1000 / 29.97 as i64;
                 // Clear the buffer and start pop on caption
-                buf.push_str("94ae 94ae 9420 9420");
+                buf.extend_from_slice(b"94ae 94ae 9420 9420");
             }
             Ordering::Less => {
                 // Clear the screen for new caption
                 let time_to_display = ccx_boundary_time::get_time(writer.old_cc_time_end as i64);
-                buf.push_str(&(get_scc_time_str(time_to_display) + "\t942c 942c \n\n").to_owned());
+                write_scc_time_str(buf, time_to_display);
+                buf.extend_from_slice(b"\t942c 942c \n\n");
                 // Correct the frame delay
                 time_show.time_in_ms -= 1000 / 29.97 as i64;
                 // Clear the buffer and start pop on caption in new time
-                buf.push_str(&(get_scc_time_str(time_show) + "\t94ae 94ae 9420 9420").to_owned());
+                write_scc_time_str(buf, time_show);
+                buf.extend_from_slice(b"\t94ae 94ae 9420 9420");
                 time_show.time_in_ms += 1000 / 29.97 as i64;
             }
             Ordering::Equal => {
                 time_show.time_in_ms -= 1000 / 29.97 as i64;
-                buf.push_str(
-                    &(get_scc_time_str(time_show) + "\t942c 942c 94ae 94ae 9420 9420").to_owned(),
-                );
+                write_scc_time_str(buf, time_show);
+                buf.extend_from_slice(b"\t942c 942c 94ae 94ae 9420 9420");
                 time_show.time_in_ms += 1000 / 29.97 as i64;
             }
         }
 
-        let total_subtitle_count = self.count_captions_lines_scc();
+        let total_subtitle_count = rows.count_ones() as usize;
         let mut current_subtitle_count = 0;
 
-        for row_index in 0..CCX_DTVCC_SCREENGRID_ROWS as usize {
-            if !self.is_row_empty(row_index) {
-                current_subtitle_count += 1;
-                add_needed_scc_labels(&mut buf, total_subtitle_count, current_subtitle_count);
+        for row_index in row_indexes(rows) {
+            current_subtitle_count += 1;
+            add_needed_scc_labels(buf, total_subtitle_count, current_subtitle_count);
 
-                let (first, last) = self.get_write_interval(row_index);
-                debug!("First: {}, Last: {}", first, last);
+            let (first, last) = self.get_write_interval(row_index);
+            debug!("First: {}, Last: {}", first, last);
 
-                let mut bytes_written = 0;
-                for i in 0..last + 1 {
-                    if bytes_written % 2 == 0 {
-                        buf.push(' ');
-                    }
-                    let adjusted_val = adjust_odd_parity(self.chars[row_index][i].sym as u8);
-                    buf = format!("{buf}{adjusted_val:x}");
-                    bytes_written += 1;
-                }
-                // add 0x80 padding and form byte pair if the last byte pair is not form
-                if bytes_written % 2 == 1 {
-                    buf.push_str("80 ");
-                } else {
-                    buf.push(' ');
+            let mut bytes_written = 0;
+            for i in 0..last + 1 {
+                if bytes_written % 2 == 0 {
+                    buf.push(b' ');
                 }
+                let adjusted_val = adjust_odd_parity(self.rows[row_index][i].sym.sym as u8);
+                let _ = write!(buf, "{adjusted_val:x}");
+                bytes_written += 1;
+            }
+            // add 0x80 padding and form byte pair if the last byte pair is not form
+            if bytes_written % 2 == 1 {
+                buf.extend_from_slice(b"80 ");
+            } else {
+                buf.push(b' ');
             }
         }
 
         // Display caption (942f 942f)
-        buf.push_str("942f 942f \n\n");
-        writer.write_to_file(buf.as_bytes())?;
+        buf.extend_from_slice(b"942f 942f \n\n");
 
         writer.old_cc_time_end = time_end.time_in_ms as i32;
         Ok(())
@@ -526,8 +512,8 @@ impl dtvcc_tv_screen {
             if !self.is_row_empty(row_index) {
                 let mut buf = String::new();
                 let (first, last) = self.get_write_interval(row_index);
-                for sym in self.chars[row_index][first..=last].iter() {
-                    buf.push_str(&format!("{:04X},", sym.sym));
+                for cell in self.rows[row_index][first..=last].iter() {
+                    buf.push_str(&format!("{:04X},", cell.sym.sym));
                 }
                 debug!("{}", buf);
             }
@@ -536,26 +522,33 @@ impl dtvcc_tv_screen {
 
     /// Returns `true` if TV screen has no text
     ///
+    /// `rows` is the bitmap returned by [`non_empty_rows`](Self::non_empty_rows).
     /// If any text is found then 708 counter is incremented
-    pub fn is_screen_empty(&self, writer: &mut Writer) -> bool {
-        for index in 0..CCX_DTVCC_SCREENGRID_ROWS as usize {
-            if !self.is_row_empty(index) {
-                // we will write subtitle
-                *writer.cea_708_counter += 1;
-                return false;
+    pub fn is_screen_empty(&self, rows: u128, writer: &mut Writer) -> bool {
+        if rows == 0 {
+            return true;
+        }
+        // we will write subtitle
+        *writer.cea_708_counter += 1;
+        false
+    }
+
+    /// Returns a bitmap of the rows holding text, bit `n` is set for row `n`
+    ///
+    /// Computed once per caption, so the writers do not rescan every row for each pass
+    pub fn non_empty_rows(&self) -> u128 {
+        let mut rows = 0;
+        for row_index in 0..CCX_DTVCC_SCREENGRID_ROWS as usize {
+            if !self.is_row_empty(row_index) {
+                rows |= 1 << row_index;
             }
         }
-        true
+        rows
     }
 
     /// Returns `true` if row has no text
     pub fn is_row_empty(&self, row_index: usize) -> bool {
-        for col_index in 0..CCX_DTVCC_SCREENGRID_COLUMNS as usize {
-            if self.chars[row_index][col_index].is_set() {
-                return false;
-            }
-        }
-        true
+        !self.rows[row_index].iter().any(|cell| cell.sym.is_set())
     }
 
     /// Add underline(<u>) and italic(<i>) tags according to the pen attributes
@@ -563,7 +556,7 @@ impl dtvcc_tv_screen {
     /// Open specifies if tag is an opening or closing tag
     pub fn change_pen_attribs(
         &self,
-        pen_attribs: &dtvcc_pen_attribs,
+        pen_attribs: &PenAttribs,
         no_font_color: bool,
         row_index: usize,
         col_index: usize,
@@ -574,22 +567,22 @@ impl dtvcc_tv_screen {
             return;
         }
         let new_pen_attribs = if col_index >= CCX_DTVCC_SCREENGRID_COLUMNS as usize {
-            dtvcc_pen_attribs::default()
+            PenAttribs::default()
         } else {
-            self.pen_attribs[row_index][col_index]
+            self.rows[row_index][col_index].attribs
         };
 
         if pen_attribs.italic != new_pen_attribs.italic {
-            if is_true(pen_attribs.italic) && !open {
+            if pen_attribs.italic && !open {
                 buf.extend_from_slice(b"</i>");
-            } else if is_false(pen_attribs.italic) && open {
+            } else if !pen_attribs.italic && open {
                 buf.extend_from_slice(b"<i>");
             }
         }
         if pen_attribs.underline != new_pen_attribs.underline {
-            if is_true(pen_attribs.underline) && !open {
+            if pen_attribs.underline && !open {
                 buf.extend_from_slice(b"</u>");
-            } else if is_false(pen_attribs.underline) && open {
+            } else if !pen_attribs.underline && open {
                 buf.extend_from_slice(b"<u>");
             }
         }
@@ -600,7 +593,7 @@ impl dtvcc_tv_screen {
     /// Open specifies if tag is an opening or closing tag
     pub fn change_pen_color(
         &self,
-        pen_color: &dtvcc_pen_color,
+        pen_color: &PenColor,
         no_font_color: bool,
         row_index: usize,
         col_index: usize,
@@ -611,9 +604,9 @@ impl dtvcc_tv_screen {
             return;
         }
         let new_pen_color = if col_index >= CCX_DTVCC_SCREENGRID_COLUMNS as usize {
-            dtvcc_pen_color::default()
+            PenColor::default()
         } else {
-            self.pen_colors[row_index][col_index]
+            self.rows[row_index][col_index].color
         };
         if pen_color.fg_color != new_pen_color.fg_color {
             if pen_color.fg_color != 0x3F && !open {
@@ -621,30 +614,43 @@ impl dtvcc_tv_screen {
                 buf.extend_from_slice(b"</font>");
             } else if new_pen_color.fg_color != 0x3F && open {
                 debug!("Colors: {}", col_index);
-                let (mut red, mut green, mut blue) = color_to_hex(new_pen_color.fg_color as u8);
+                let (mut red, mut green, mut blue) = color_to_hex(new_pen_color.fg_color);
                 red *= 255 / 3;
                 green *= 255 / 3;
                 blue *= 255 / 3;
-                let font_tag = format!("<font color=\"#{red:02x}{green:02x}{blue:02x}\">");
-                buf.extend_from_slice(font_tag.as_bytes());
+                let _ = write!(buf, "<font color=\"#{red:02x}{green:02x}{blue:02x}\">");
             }
         }
     }
 }
 
+/// Iterate over the row indexes set in a bitmap from [`TvScreen::non_empty_rows`]
+fn row_indexes(mut rows: u128) -> impl Iterator<Item = usize> {
+    std::iter::from_fn(move || {
+        if rows == 0 {
+            return None;
+        }
+        let row_index = rows.trailing_zeros() as usize;
+        rows &= rows - 1;
+        Some(row_index)
+    })
+}
+
 #[cfg(test)]
 mod test {
-    use crate::utils::get_zero_allocated_obj;
-
     use super::*;
 
     #[test]
     fn test_clear() {
-        let mut screen = get_zero_allocated_obj::<dtvcc_tv_screen>();
+        let mut screen = TvScreen::new(1);
         screen.time_ms_show = 1000;
         screen.time_ms_hide = 2000;
-        screen.chars = [[dtvcc_symbol { sym: 1, init: 2 }; CCX_DTVCC_SCREENGRID_COLUMNS as usize];
-            CCX_DTVCC_SCREENGRID_ROWS as usize];
+        for row in screen.rows.iter_mut() {
+            row.fill(Cell {
+                sym: dtvcc_symbol { sym: 1, init: 2 },
+                ..Default::default()
+            });
+        }
 
         // Clear the screen will clear the chars and timings
         screen.clear();
@@ -653,14 +659,14 @@ mod test {
         assert_eq!(screen.time_ms_hide, -1);
         for row in 0..CCX_DTVCC_SCREENGRID_ROWS as usize {
             for col in 0..CCX_DTVCC_SCREENGRID_COLUMNS as usize {
-                assert_eq!(screen.chars[row][col], dtvcc_symbol::default());
+                assert_eq!(screen.rows[row][col], Cell::default());
             }
         }
     }
 
     #[test]
     fn test_update_time_show() {
-        let mut screen = get_zero_allocated_obj::<dtvcc_tv_screen>();
+        let mut screen = TvScreen::new(1);
         screen.time_ms_show = -1;
 
         // Case 1: time_ms_show = -1     -> Update time show
@@ -678,7 +684,7 @@ mod test {
 
     #[test]
     fn test_update_time_hide() {
-        let mut screen = get_zero_allocated_obj::<dtvcc_tv_screen>();
+        let mut screen = TvScreen::new(1);
         screen.time_ms_hide = -1;
 
         // Case 1: time_ms_show = -1     -> Update time hide
@@ -696,11 +702,11 @@ mod test {
 
     #[test]
     fn test_get_write_interval() {
-        let mut screen = get_zero_allocated_obj::<dtvcc_tv_screen>();
-        screen.chars[0][2] = dtvcc_symbol::new(0x41);
-        screen.chars[0][3] = dtvcc_symbol::new(0x42);
-        screen.chars[0][4] = dtvcc_symbol::new(0x43);
-        screen.chars[1][4] = dtvcc_symbol::new(0x43);
+        let mut screen = TvScreen::new(1);
+        screen.rows[0][2].sym = dtvcc_symbol::new(0x41);
+        screen.rows[0][3].sym = dtvcc_symbol::new(0x42);
+        screen.rows[0][4].sym = dtvcc_symbol::new(0x43);
+        screen.rows[1][4].sym = dtvcc_symbol::new(0x43);
 
         // Mulitple row filed
         assert_eq!(screen.get_write_interval(0), (2, 4));
@@ -712,29 +718,41 @@ mod test {
 
     #[test]
     fn test_count_captions_lines_scc() {
-        let mut screen = get_zero_allocated_obj::<dtvcc_tv_screen>();
+        let mut screen = TvScreen::new(1);
 
         // No captions
         assert_eq!(screen.count_captions_lines_scc(), 0);
 
         // Set some non-default values
-        screen.chars[0][2] = dtvcc_symbol::new(0x41);
-        screen.chars[1][2] = dtvcc_symbol::new(0x42);
-        screen.chars[2][2] = dtvcc_symbol::new(0x43);
+        screen.rows[0][2].sym = dtvcc_symbol::new(0x41);
+        screen.rows[1][2].sym = dtvcc_symbol::new(0x42);
+        screen.rows[2][2].sym = dtvcc_symbol::new(0x43);
 
         assert_eq!(screen.count_captions_lines_scc(), 3);
     }
 
+    #[test]
+    fn test_non_empty_rows() {
+        let mut screen = TvScreen::new(1);
+        assert_eq!(screen.non_empty_rows(), 0);
+
+        screen.rows[1][0].sym = dtvcc_symbol::new(0x41);
+        screen.rows[74][209].sym = dtvcc_symbol::new(0x42);
+        let rows = screen.non_empty_rows();
+        assert_eq!(rows, (1 << 1) | (1 << 74));
+        assert_eq!(row_indexes(rows).collect::<Vec<_>>(), vec![1, 74]);
+    }
+
     #[test]
     fn test_is_row_empty() {
-        let mut screen = get_zero_allocated_obj::<dtvcc_tv_screen>();
+        let mut screen = TvScreen::new(1);
 
         // Default emty row check
         assert!(screen.is_row_empty(0));
         assert!(screen.is_row_empty(1));
 
         // Non-default emty row check
-        screen.chars[0][0] = dtvcc_symbol::new(0x51);
+        screen.rows[0][0].sym = dtvcc_symbol::new(0x51);
         assert!(!screen.is_row_empty(0));
         assert!(screen.is_row_empty(1));
     }
@@ -10,66 +10,156 @@
 //! At any time there is a current window to which all subsequent
 //! window/pen commands are directed. All caption text is written to the current window
 
-use std::{
-    alloc::{alloc_zeroed, dealloc, Layout},
-    ptr::copy_nonoverlapping,
-};
-
 use super::timing::get_time_str;
 use super::{
     CCX_DTVCC_MAX_COLUMNS, CCX_DTVCC_MAX_ROWS, CCX_DTVCC_SCREENGRID_COLUMNS,
     CCX_DTVCC_SCREENGRID_ROWS,
 };
-use crate::{bindings::*, utils::is_true};
+use crate::bindings::*;
+
+use log::debug;
+
+/// A character cell of a window or of the TV screen
+///
+/// The symbol is kept next to the pen it was painted with, so copying or writing a row walks
+/// a single array instead of three
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct Cell {
+    pub sym: dtvcc_symbol,
+    pub attribs: PenAttribs,
+    pub color: PenColor,
+}
+
+/// Window attributes
+///
+/// Set by the window presets and the SWA(SetWindowAttributes) command. Refer Section 8.10.5.9 CEA-708-E
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct WindowAttribs {
+    pub justify: u8,
+    pub print_direction: u8,
+    pub scroll_direction: u8,
+    pub word_wrap: u8,
+    pub display_effect: u8,
+    pub effect_direction: u8,
+    pub effect_speed: u8,
+    pub fill_color: u8,
+    pub fill_opacity: u8,
+    pub border_type: u8,
+    pub border_color: u8,
+}
 
-use log::{debug, error};
+/// A caption window of a service decoder
+///
+/// The window text lives inline in `rows`, so a window is created once with its decoder and
+/// never allocates while captions are decoded
+#[derive(Clone)]
+pub struct Window {
+    pub is_defined: bool,
+    pub number: i32,
+    pub priority: i32,
+    pub col_lock: bool,
+    pub row_lock: bool,
+    pub visible: bool,
+    pub anchor_vertical: i32,
+    pub relative_pos: bool,
+    pub anchor_horizontal: i32,
+    pub row_count: i32,
+    pub anchor_point: i32,
+    pub col_count: i32,
+    pub pen_style: i32,
+    pub win_style: i32,
+    /// Parameters of the DefineWindow command used to create this window
+    pub commands: [u8; 6],
+    pub attribs: WindowAttribs,
+    pub pen_row: i32,
+    pub pen_column: i32,
+    pub rows: [[Cell; CCX_DTVCC_MAX_COLUMNS as usize]; CCX_DTVCC_MAX_ROWS as usize],
+    pub pen_color_pattern: PenColor,
+    pub pen_attribs_pattern: PenAttribs,
+    pub is_empty: bool,
+    pub time_ms_show: LLONG,
+    pub time_ms_hide: LLONG,
+}
 
-impl dtvcc_window {
+impl Default for Window {
+    /// Create an undefined, hidden and empty window
+    fn default() -> Self {
+        Self {
+            is_defined: false,
+            number: 0,
+            priority: 0,
+            col_lock: false,
+            row_lock: false,
+            visible: false,
+            anchor_vertical: 0,
+            relative_pos: false,
+            anchor_horizontal: 0,
+            row_count: 0,
+            anchor_point: 0,
+            col_count: 0,
+            pen_style: 0,
+            win_style: 0,
+            commands: [0; 6],
+            attribs: WindowAttribs::default(),
+            pen_row: 0,
+            pen_column: 0,
+            rows: [[Cell::default(); CCX_DTVCC_MAX_COLUMNS as usize]; CCX_DTVCC_MAX_ROWS as usize],
+            pen_color_pattern: PenColor::default(),
+            pen_attribs_pattern: PenAttribs::default(),
+            is_empty: true,
+            time_ms_show: -1,
+            time_ms_hide: -1,
+        }
+    }
+}
+
+impl Window {
     /// Sets the window style according to the window preset
     pub fn set_style(&mut self, preset: WindowPreset) {
         let style_id = preset as i32;
         let window_style = WindowStyle::new(preset);
         self.win_style = style_id;
-        self.attribs.border_color = window_style.border_color as i32;
-        self.attribs.border_type = window_style.border_type as i32;
-        self.attribs.display_effect = window_style.display_effect as i32;
-        self.attribs.effect_direction = window_style.effect_direction as i32;
-        self.attribs.effect_speed = window_style.effect_speed as i32;
-        self.attribs.fill_color = window_style.fill_color as i32;
-        self.attribs.fill_opacity = window_style.fill_opacity as i32;
-        self.attribs.justify = window_style.justify as i32;
-        self.attribs.print_direction = window_style.print_direction as i32;
-        self.attribs.scroll_direction = window_style.scroll_direction as i32;
-        self.attribs.word_wrap = window_style.word_wrap as i32;
+        self.attribs.border_color = window_style.border_color;
+        self.attribs.border_type = window_style.border_type as u8;
+        self.attribs.display_effect = window_style.display_effect as u8;
+        self.attribs.effect_direction = window_style.effect_direction;
+        self.attribs.effect_speed = window_style.effect_speed;
+        self.attribs.fill_color = window_style.fill_color;
+        self.attribs.fill_opacity = window_style.fill_opacity as u8;
+        self.attribs.justify = window_style.justify as u8;
+        self.attribs.print_direction = window_style.print_direction as u8;
+        self.attribs.scroll_direction = window_style.scroll_direction as u8;
+        self.attribs.word_wrap = window_style.word_wrap;
     }
     /// Sets the pen style according to the pen preset
     pub fn set_pen_style(&mut self, preset: PenPreset) {
         let pen_style = PenStyle::new(preset);
         let pen = &mut self.pen_attribs_pattern;
-        pen.pen_size = pen_style.pen_size as i32;
-        pen.offset = pen_style.offset as i32;
-        pen.edge_type = pen_style.edge_type as i32;
-        pen.underline = pen_style.underline as i32;
-        pen.italic = pen_style.italics as i32;
-
-        let pen_color = &mut self.pen_color_pattern;
-        pen_color.fg_color = pen_style.color.fg_color as i32;
-        pen_color.fg_opacity = pen_style.color.fg_opacity as i32;
-        pen_color.bg_color = pen_style.color.bg_color as i32;
-        pen_color.bg_opacity = pen_style.color.bg_opacity as i32;
-        pen_color.edge_color = pen_style.color.edge_color as i32;
+        pen.pen_size = pen_style.pen_size as u8;
+        pen.offset = pen_style.offset as u8;
+        pen.edge_type = pen_style.edge_type as u8;
+        pen.underline = pen_style.underline;
+        pen.italic = pen_style.italics;
+
+        self.pen_color_pattern = pen_style.color;
     }
     /// Update the show time for the window
     pub fn update_time_show(&mut self, timing: &mut ccx_common_timing_ctx) {
         self.time_ms_show = timing.get_visible_start(3);
-        let time = get_time_str(self.time_ms_show);
-        debug!("[W-{}] show time updated to {}", self.number, time);
+        debug!(
+            "[W-{}] show time updated to {}",
+            self.number,
+            get_time_str(self.time_ms_show)
+        );
     }
     /// Update the hide time for the window
     pub fn update_time_hide(&mut self, timing: &mut ccx_common_timing_ctx) {
         self.time_ms_hide = timing.get_visible_end(3);
-        let time = get_time_str(self.time_ms_hide);
-        debug!("[W-{}] hide time updated to {}", self.number, time);
+        debug!(
+            "[W-{}] hide time updated to {}",
+            self.number,
+            get_time_str(self.time_ms_hide)
+        );
     }
     /// Get dimensions of the window
     ///
@@ -149,39 +239,18 @@ impl dtvcc_window {
     /// Clear all text from the window
     pub fn clear_text(&mut self) {
         // Set pen color to default value
-        self.pen_color_pattern = dtvcc_pen_color::default();
+        self.pen_color_pattern = PenColor::default();
         // Set pen attributes to default value
-        self.pen_attribs_pattern = dtvcc_pen_attribs::default();
+        self.pen_attribs_pattern = PenAttribs::default();
         for row in 0..CCX_DTVCC_MAX_ROWS as usize {
             self.clear_row(row);
         }
-        self.is_empty = 1;
+        self.is_empty = true;
     }
-    /// Clear text from the selected row
+    /// Clear text, pen color and attributes from the selected row
     pub fn clear_row(&mut self, row_index: usize) {
-        if is_true(self.memory_reserved) {
-            unsafe {
-                let layout = Layout::array::<dtvcc_symbol>(CCX_DTVCC_MAX_COLUMNS as usize);
-                if let Err(e) = layout {
-                    error!("clear_row: Incorrect Layout, {}", e);
-                } else {
-                    let layout = layout.unwrap();
-                    // deallocate previous memory
-                    dealloc(self.rows[row_index] as *mut u8, layout);
-
-                    // allocate new zero initialized memory
-                    let ptr = alloc_zeroed(layout);
-                    if ptr.is_null() {
-                        error!("clear_row: Not enough memory",);
-                    }
-                    self.rows[row_index] = ptr as *mut dtvcc_symbol;
-                }
-            }
-            for col in 0..CCX_DTVCC_MAX_COLUMNS as usize {
-                // Set pen color and attributes to default value
-                self.pen_attribs[row_index][col] = dtvcc_pen_attribs::default();
-                self.pen_colors[row_index][col] = dtvcc_pen_color::default();
-            }
+        if let Some(row) = self.rows.get_mut(row_index) {
+            row.fill(Cell::default());
         }
     }
     /// Roll-up the captions
@@ -189,16 +258,12 @@ impl dtvcc_window {
     /// Scroll all the rows above by 1 to achieve the rollup effect
     pub fn rollup(&mut self) {
         debug!("roller");
-        for row_index in 0..(self.row_count - 1) as usize {
-            let curr_row = self.rows[row_index];
-            let next_row = self.rows[row_index + 1] as *const dtvcc_symbol;
-            unsafe { copy_nonoverlapping(next_row, curr_row, CCX_DTVCC_MAX_COLUMNS as usize) };
-            for col_index in 0..CCX_DTVCC_MAX_COLUMNS as usize {
-                self.pen_colors[row_index][col_index] = self.pen_colors[row_index + 1][col_index];
-                self.pen_attribs[row_index][col_index] = self.pen_attribs[row_index + 1][col_index];
-            }
+        let row_count = (self.row_count as usize).min(CCX_DTVCC_MAX_ROWS as usize);
+        if row_count == 0 {
+            return;
         }
-        self.clear_row((self.row_count - 1) as usize);
+        self.rows.copy_within(1..row_count, 0);
+        self.clear_row(row_count - 1);
     }
 }
 
@@ -404,10 +469,10 @@ pub struct PenStyle {
     /// Not being used current in the C code(bindings)
     _font_style: dtvcc_pen_font_style,
     offset: dtvcc_pen_offset,
-    /// always no, i.e. 0
-    italics: u8,
-    /// always no, i.e. 0
-    underline: u8,
+    /// always no
+    italics: bool,
+    /// always no
+    underline: bool,
     edge_type: dtvcc_pen_edge,
     color: PenColor,
 }
@@ -418,8 +483,8 @@ impl PenStyle {
         // All styles have these common attributes
         let pen_size = dtvcc_pen_size::DTVCC_PEN_SIZE_STANDART;
         let offset = dtvcc_pen_offset::DTVCC_PEN_OFFSET_NORMAL;
-        let italics = 0;
-        let underline = 0;
+        let italics = false;
+        let underline = false;
         let bg_opacity = match preset {
             PenPreset::MonoBordered | PenPreset::PropBordered => Opacity::Transparent,
             _ => Opacity::Solid,
@@ -428,10 +493,10 @@ impl PenStyle {
         let color = PenColor {
             // White(2,2,2) i.e 10,10,10 i.e 42
             fg_color: 42,
-            fg_opacity: Opacity::Solid,
+            fg_opacity: Opacity::Solid as u8,
             // Either N/A or black, still always 0
             bg_color: 0,
-            bg_opacity,
+            bg_opacity: bg_opacity as u8,
             // Either N/A or black, still always 0
             edge_color: 0,
         };
@@ -485,28 +550,21 @@ impl PenStyle {
 ///
 /// Text written to the current window will have the color attributes specified by
 /// the most recent SetPenColor command written to the window.
-struct PenColor {
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub struct PenColor {
     /// Color of text forground body
-    fg_color: u8,
+    pub fg_color: u8,
     /// Opacity of text foreground body
-    fg_opacity: Opacity,
+    pub fg_opacity: u8,
     /// Color of background box surrounding the text
-    bg_color: u8,
+    pub bg_color: u8,
     /// Opacity of background box surrounding the text
-    bg_opacity: Opacity,
+    pub bg_opacity: u8,
     /// Color of the outlined edges of text
-    edge_color: u8,
+    pub edge_color: u8,
 }
 
-/// Opacity of the window/pen colors
-enum Opacity {
-    Solid = 0,
-    _Flash = 1,
-    _Translucent = 2,
-    Transparent = 3,
-}
-
-impl Default for dtvcc_pen_color {
+impl Default for PenColor {
     /// Returns the default pen color
     fn default() -> Self {
         Self {
@@ -519,41 +577,41 @@ impl Default for dtvcc_pen_color {
     }
 }
 
-impl Default for dtvcc_pen_attribs {
+/// Pen attributes
+///
+/// Set by the SPA(SetPenAttributes) command. Refer Section 8.10.5.9 CEA-708-E
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub struct PenAttribs {
+    pub pen_size: u8,
+    pub offset: u8,
+    pub text_tag: u8,
+    pub font_tag: u8,
+    pub edge_type: u8,
+    pub underline: bool,
+    pub italic: bool,
+}
+
+impl Default for PenAttribs {
     /// Returns the default pen attributes
     fn default() -> Self {
         Self {
-            pen_size: dtvcc_pen_size::DTVCC_PEN_SIZE_STANDART as i32,
+            pen_size: dtvcc_pen_size::DTVCC_PEN_SIZE_STANDART as u8,
             offset: 0,
-            text_tag: dtvcc_pen_text_tag::DTVCC_PEN_TEXT_TAG_UNDEFINED_12 as i32,
+            text_tag: dtvcc_pen_text_tag::DTVCC_PEN_TEXT_TAG_UNDEFINED_12 as u8,
             font_tag: 0,
-            edge_type: dtvcc_pen_edge::DTVCC_PEN_EDGE_NONE as i32,
-            underline: 0,
-            italic: 0,
+            edge_type: dtvcc_pen_edge::DTVCC_PEN_EDGE_NONE as u8,
+            underline: false,
+            italic: false,
         }
     }
 }
 
-impl PartialEq for dtvcc_pen_attribs {
-    fn eq(&self, other: &Self) -> bool {
-        self.pen_size == other.pen_size
-            && self.offset == other.offset
-            && self.text_tag == other.text_tag
-            && self.font_tag == other.font_tag
-            && self.edge_type == other.edge_type
-            && self.underline == other.underline
-            && self.italic == other.italic
-    }
-}
-
-impl PartialEq for dtvcc_pen_color {
-    fn eq(&self, other: &Self) -> bool {
-        self.fg_color == other.fg_color
-            && self.bg_color == other.bg_color
-            && self.fg_opacity == other.fg_opacity
-            && self.edge_color == other.edge_color
-            && self.bg_opacity == other.bg_opacity
-    }
+/// Opacity of the window/pen colors
+enum Opacity {
+    Solid = 0,
+    _Flash = 1,
+    _Translucent = 2,
+    Transparent = 3,
 }
 
 #[cfg(test)]
@@ -565,7 +623,7 @@ mod test {
     fn test_update_time_show() {
         set_test_cb_values();
         let mut timing = get_temp_timing_ctx();
-        let mut window = dtvcc_window::default();
+        let mut window = Window::default();
         window.update_time_show(&mut timing);
 
         assert_eq!(window.time_ms_show, 501);
@@ -575,14 +633,14 @@ mod test {
     fn test_update_time_end() {
         set_test_cb_values();
         let mut timing = get_temp_timing_ctx();
-        let mut window = dtvcc_window::default();
+        let mut window = Window::default();
         window.update_time_hide(&mut timing);
 
         assert!(window.time_ms_hide == 393 || window.time_ms_hide == 427);
     }
 
-    fn create_window(anchor_point: i32, pts: (i32, i32, i32, i32)) -> dtvcc_window {
-        dtvcc_window {
+    fn create_window(anchor_point: i32, pts: (i32, i32, i32, i32)) -> Window {
+        Window {
             anchor_point,
             anchor_vertical: pts.0,
             anchor_horizontal: pts.1,
@@ -662,78 +720,73 @@ mod test {
 
     #[test]
     fn test_clear_row() {
-        let mut window = dtvcc_window {
-            memory_reserved: 1,
-            ..Default::default()
-        };
-
-        // Allocate memory for the rows
-        for row in 0..CCX_DTVCC_MAX_ROWS as usize {
-            let layout = Layout::array::<dtvcc_symbol>(CCX_DTVCC_MAX_COLUMNS as usize);
-            let ptr = unsafe { alloc_zeroed(layout.unwrap()) };
-            window.rows[row] = ptr as *mut dtvcc_symbol;
-        }
-
-        window.pen_attribs[2][3] = dtvcc_pen_attribs {
-            pen_size: dtvcc_pen_size::DTVCC_PEN_SIZE_SMALL as i32,
-            offset: 10,
-            ..Default::default()
-        };
-        window.pen_colors[2][3] = dtvcc_pen_color {
-            fg_color: 0x12,
-            fg_opacity: 0x34,
-            ..Default::default()
+        let mut window = Window::default();
+
+        window.rows[2][3] = Cell {
+            sym: dtvcc_symbol::new(0x41),
+            attribs: PenAttribs {
+                pen_size: dtvcc_pen_size::DTVCC_PEN_SIZE_SMALL as u8,
+                offset: 10,
+                ..Default::default()
+            },
+            color: PenColor {
+                fg_color: 0x12,
+                fg_opacity: 0x34,
+                ..Default::default()
+            },
         };
+        window.rows[3][3].sym = dtvcc_symbol::new(0x42);
 
         window.clear_row(2);
 
         // Verify the row has been cleared
         for col in 0..CCX_DTVCC_MAX_COLUMNS as usize {
-            assert_eq!(window.pen_attribs[2][col], dtvcc_pen_attribs::default());
-            assert_eq!(window.pen_colors[2][col], dtvcc_pen_color::default());
+            assert_eq!(window.rows[2][col], Cell::default());
         }
+        // Other rows are left alone
+        assert_eq!(window.rows[3][3].sym, dtvcc_symbol::new(0x42));
     }
 
     #[test]
     fn test_rollup() {
-        let mut window = dtvcc_window::default();
-
-        // Allocate memory for the rows
-        for row in 0..CCX_DTVCC_MAX_ROWS as usize {
-            let layout = Layout::array::<dtvcc_symbol>(CCX_DTVCC_MAX_COLUMNS as usize);
-            let ptr = unsafe { alloc_zeroed(layout.unwrap()) };
-            window.rows[row] = ptr as *mut dtvcc_symbol;
-        }
-
-        window.pen_attribs[0][0] = dtvcc_pen_attribs {
-            pen_size: dtvcc_pen_size::DTVCC_PEN_SIZE_SMALL as i32,
-            offset: 10,
-            ..Default::default()
-        };
-        window.pen_colors[0][0] = dtvcc_pen_color {
-            fg_color: 0x12,
-            fg_opacity: 0x34,
-            ..Default::default()
+        let mut window = Window::default();
+
+        window.rows[0][0] = Cell {
+            sym: dtvcc_symbol::new(0x41),
+            attribs: PenAttribs {
+                pen_size: dtvcc_pen_size::DTVCC_PEN_SIZE_SMALL as u8,
+                offset: 10,
+                ..Default::default()
+            },
+            color: PenColor {
+                fg_color: 0x12,
+                fg_opacity: 0x34,
+                ..Default::default()
+            },
         };
-
-        window.pen_attribs[1][1] = dtvcc_pen_attribs {
-            pen_size: dtvcc_pen_size::DTVCC_PEN_SIZE_LARGE as i32,
-            offset: 20,
-            ..Default::default()
-        };
-        window.pen_colors[1][1] = dtvcc_pen_color {
-            fg_color: 0x56,
-            fg_opacity: 0x78,
-            ..Default::default()
+        let second = Cell {
+            sym: dtvcc_symbol::new(0x42),
+            attribs: PenAttribs {
+                pen_size: dtvcc_pen_size::DTVCC_PEN_SIZE_LARGE as u8,
+                offset: 20,
+                ..Default::default()
+            },
+            color: PenColor {
+                fg_color: 0x56,
+                fg_opacity: 0x78,
+                ..Default::default()
+            },
         };
+        window.rows[1][1] = second;
         window.row_count = 2;
 
         window.rollup();
 
-        // Verify the rows have been rolled up
+        // Verify the rows have been rolled up and the last row cleared
+        assert_eq!(window.rows[0][0], Cell::default());
+        assert_eq!(window.rows[0][1], second);
         for col in 0..CCX_DTVCC_MAX_COLUMNS as usize {
-            assert_eq!(window.pen_attribs[0][col], window.pen_attribs[1][col]);
-            assert_eq!(window.pen_colors[0][col], window.pen_colors[1][col]);
+            assert_eq!(window.rows[1][col], Cell::default());
         }
     }
 
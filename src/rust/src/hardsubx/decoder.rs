@@ -7,8 +7,6 @@ use leptonica_sys::*;
 use std::convert::TryInto;
 use std::eprintln;
 use std::ffi;
-use std::format;
-use std::os::raw::c_char;
 use std::process::exit;
 use std::ptr::null;
 
@@ -16,7 +14,7 @@ use std::ptr::null;
 // use crate::bindings::{hardsubx_ocr_mode_HARDSUBX_OCRMODE_WORD};
 use crate::bindings::AVFrame;
 use crate::hardsubx::classifier::*;
-use crate::hardsubx::imgops::{rgb_to_hsv, rgb_to_lab};
+use crate::hardsubx::imgops::get_color_lut;
 use crate::hardsubx::lib_hardsubx_ctx;
 use crate::utils::string_to_c_char;
 
@@ -71,6 +69,47 @@ pub unsafe fn dispatch_classifier_functions(ctx: *mut lib_hardsubx_ctx, im: *mut
     }
 }
 
+/// A 32 bpp Leptonica RGB pixel
+fn compose_rgb(r: u8, g: u8, b: u8) -> u32 {
+    ((r as u32) << 24) | ((g as u32) << 16) | ((b as u32) << 8)
+}
+
+const WHITE_PIXEL: u32 = 0xffffff00;
+
+/// Returns `*pix`, recreating it if it does not have the requested size.
+/// Pixels of a reused image keep their values from the previous frame,
+/// so callers must write every pixel they read back later.
+///
+/// # Safety
+/// `pix` must point to a null or valid Pix pointer
+unsafe fn reuse_pix(pix: *mut *mut Pix, width: i32, height: i32) -> *mut Pix {
+    if !(*pix).is_null() && (pixGetWidth(*pix) != width || pixGetHeight(*pix) != height) {
+        pixDestroy(pix);
+    }
+    if (*pix).is_null() {
+        *pix = pixCreate(width, height, 32);
+    }
+    *pix
+}
+
+/// # Safety
+/// `pix` must be a valid image with more than `row` rows
+unsafe fn pix_line(pix: *mut Pix, row: i32) -> *mut u32 {
+    pixGetData(pix).offset((row * pixGetWpl(pix)) as isize)
+}
+
+/// Pixel `n` of a line of a 1 bpp image, like Leptonica's GET_DATA_BIT
+unsafe fn get_data_bit(line: *const u32, n: i32) -> u32 {
+    (*line.offset((n >> 5) as isize) >> (31 - (n & 31))) & 1
+}
+
+/// Pixel `n` of a line of an 8 bpp image, like Leptonica's GET_DATA_BYTE
+unsafe fn get_data_byte(line: *const u32, n: i32) -> u8 {
+    #[cfg(target_endian = "little")]
+    let n = n ^ 3;
+    *(line as *const u8).offset(n as isize)
+}
+
 /// # Safety
 /// The function dereferences a raw pointer
 /// The function also calls other functions whose safety is not guaranteed
@@ -84,29 +123,25 @@ pub unsafe extern "C" fn _process_frame_white_basic(
     height: ::std::os::raw::c_int,
     _index: ::std::os::raw::c_int,
 ) -> *mut ::std::os::raw::c_char {
-    let mut im: *mut Pix = pixCreate(width, height, 32);
-    let mut lum_im: *mut Pix = pixCreate(width, height, 32);
+    let lut = get_color_lut(ctx, false);
+    let im: *mut Pix = reuse_pix(&mut (*ctx).frame_im, width, height);
+    let lum_im: *mut Pix = reuse_pix(&mut (*ctx).mask_im, width, height);
     let frame_deref = *frame;
 
-    for i in (3 * height / 4)..height {
-        for j in 0..width {
-            let p: isize = (j * 3 + i * frame_deref.linesize[0]).try_into().unwrap();
-            let r: i32 = (*(frame_deref.data[0]).offset(p)).into();
-            let g: i32 = (*(frame_deref.data[0]).offset(p + 1)).into();
-            let b: i32 = (*(frame_deref.data[0]).offset(p + 2)).into();
-            pixSetRGBPixel(im, j, i, r, g, b);
-
-            let mut L: f32 = 0.0;
-            let mut A: f32 = 0.0;
-            let mut B: f32 = 0.0;
-
-            rgb_to_lab(r as f32, g as f32, b as f32, &mut L, &mut A, &mut B);
-
-            if L > (*ctx).lum_thresh {
-                pixSetRGBPixel(lum_im, j, i, 255, 255, 255);
+    for i in 0..height {
+        let src = frame_deref.data[0].offset((i * frame_deref.linesize[0]) as isize);
+        let im_line = pix_line(im, i);
+        let lum_line = pix_line(lum_im, i);
+        for j in 0..width as isize {
+            let r = *src.offset(3 * j);
+            let g = *src.offset(3 * j + 1);
+            let b = *src.offset(3 * j + 2);
+            *im_line.offset(j) = compose_rgb(r, g, b);
+            *lum_line.offset(j) = if lut.is_bright(r, g, b) {
+                WHITE_PIXEL
             } else {
-                pixSetRGBPixel(lum_im, j, i, 0, 0, 0);
-            }
+                0
+            };
         }
     }
 
@@ -116,21 +151,15 @@ pub unsafe extern "C" fn _process_frame_white_basic(
     let mut dilate_gray_im: *mut Pix = pixDilateGray(sobel_edge_im, 21, 1);
     let mut edge_im: *mut Pix = pixThresholdToBinary(dilate_gray_im, 50);
 
-    let mut feat_im: *mut Pix = pixCreate(width, height, 32);
+    let feat_im: *mut Pix = reuse_pix(&mut (*ctx).feat_im, width, height);
 
-    for i in (3 * (height / 4))..height {
+    for i in 0..height {
+        let edge_line = pix_line(edge_im, i);
+        let lum_line = pix_line(lum_im, i);
+        let feat_line = pix_line(feat_im, i);
         for j in 0..width {
-            let mut p1: u32 = 0;
-            let mut p2: u32 = 0;
-
-            pixGetPixel(edge_im, j, i, &mut p1);
-            pixGetPixel(lum_im, j, i, &mut p2);
-
-            if p1 == 0 && p2 > 0 {
-                pixSetRGBPixel(feat_im, j, i, 255, 255, 255);
-            } else {
-                pixSetRGBPixel(feat_im, j, i, 0, 0, 0);
-            }
+            let is_feat = get_data_bit(edge_line, j) == 0 && *lum_line.offset(j as isize) > 0;
+            *feat_line.offset(j as isize) = if is_feat { WHITE_PIXEL } else { 0 };
         }
     }
 
@@ -140,13 +169,10 @@ pub unsafe extern "C" fn _process_frame_white_basic(
 
     let subtitle_text = dispatch_classifier_functions(ctx, feat_im);
 
-    pixDestroy(&mut im as *mut *mut Pix);
     pixDestroy(&mut gray_im as *mut *mut Pix);
     pixDestroy(&mut sobel_edge_im as *mut *mut Pix);
     pixDestroy(&mut dilate_gray_im as *mut *mut Pix);
     pixDestroy(&mut edge_im as *mut *mut Pix);
-    pixDestroy(&mut lum_im as *mut *mut Pix);
-    pixDestroy(&mut feat_im as *mut *mut Pix);
 
     string_to_c_char(&subtitle_text)
 }
@@ -164,27 +190,22 @@ pub unsafe extern "C" fn _process_frame_color_basic(
     height: ::std::os::raw::c_int,
     _index: ::std::os::raw::c_int,
 ) -> *mut ::std::os::raw::c_char {
-    let mut im: *mut Pix = pixCreate(width, height, 32);
-    let mut hue_im: *mut Pix = pixCreate(width, height, 32);
+    let lut = get_color_lut(ctx, true);
+    let im: *mut Pix = reuse_pix(&mut (*ctx).frame_im, width, height);
+    let hue_im: *mut Pix = reuse_pix(&mut (*ctx).mask_im, width, height);
     let frame_deref = *frame;
 
     for i in 0..height {
-        for j in 0..width {
-            let p: isize = (j * 3 + i * frame_deref.linesize[0]).try_into().unwrap();
-            let r: i32 = (*(frame_deref.data[0]).offset(p)).into();
-            let g: i32 = (*(frame_deref.data[0]).offset(p + 1)).into();
-            let b: i32 = (*(frame_deref.data[0]).offset(p + 2)).into();
-            pixSetRGBPixel(im, j, i, r, g, b);
-
-            let mut H: f32 = 0.0;
-            let mut S: f32 = 0.0;
-            let mut V: f32 = 0.0;
-
-            rgb_to_hsv(r as f32, g as f32, b as f32, &mut H, &mut S, &mut V);
-
-            if ((H - (*ctx).hue).abs()) < 20.0 {
-                pixSetRGBPixel(hue_im, j, i, r, g, b);
-            }
+        let src = frame_deref.data[0].offset((i * frame_deref.linesize[0]) as isize);
+        let im_line = pix_line(im, i);
+        let hue_line = pix_line(hue_im, i);
+        for j in 0..width as isize {
+            let r = *src.offset(3 * j);
+            let g = *src.offset(3 * j + 1);
+            let b = *src.offset(3 * j + 2);
+            let pixel = compose_rgb(r, g, b);
+            *im_line.offset(j) = pixel;
+            *hue_line.offset(j) = if lut.is_hue(r, g, b) { pixel } else { 0 };
         }
     }
 
@@ -209,21 +230,18 @@ pub unsafe extern "C" fn _process_frame_color_basic(
         &mut pixd,
     );
 
-    let mut feat_im: *mut Pix = pixCreate(width, height, 32);
+    let feat_im: *mut Pix = reuse_pix(&mut (*ctx).feat_im, width, height);
 
-    for i in (3 * (height / 4))..height {
+    for i in 0..height {
+        let edge_line = pix_line(edge_im, i);
+        let pixd_line = pix_line(pixd, i);
+        let edge_2_line = pix_line(edge_im_2, i);
+        let feat_line = pix_line(feat_im, i);
         for j in 0..width {
-            let mut p1: u32 = 0;
-            let mut p2: u32 = 0;
-            let mut p3: u32 = 0;
-
-            pixGetPixel(edge_im, j, i, &mut p1);
-            pixGetPixel(pixd, j, i, &mut p2);
-            pixGetPixel(edge_im_2, j, i, &mut p3);
-
-            if p1 == 0 && p2 == 0 && p3 > 0 {
-                pixSetRGBPixel(feat_im, j, i, 255, 255, 255);
-            }
+            let is_feat = get_data_bit(edge_line, j) == 0
+                && get_data_bit(pixd_line, j) == 0
+                && get_data_byte(edge_2_line, j) > 0;
+            *feat_line.offset(j as isize) = if is_feat { WHITE_PIXEL } else { 0 };
         }
     }
 
@@ -233,8 +251,6 @@ pub unsafe extern "C" fn _process_frame_color_basic(
 
     let subtitle_text = dispatch_classifier_functions(ctx, feat_im);
 
-    pixDestroy(&mut im as *mut *mut Pix);
-    pixDestroy(&mut hue_im as *mut *mut Pix);
     pixDestroy(&mut gray_im as *mut *mut Pix);
     pixDestroy(&mut sobel_edge_im as *mut *mut Pix);
     pixDestroy(&mut dilate_gray_im as *mut *mut Pix);
@@ -242,93 +258,8 @@ pub unsafe extern "C" fn _process_frame_color_basic(
     pixDestroy(&mut gray_im_2 as *mut *mut Pix);
     pixDestroy(&mut edge_im_2 as *mut *mut Pix);
     pixDestroy(&mut pixd as *mut *mut Pix);
-    pixDestroy(&mut feat_im as *mut *mut Pix);
 
     // This is a memory leak
     // the returned thing needs to be deallocated by caller
     string_to_c_char(&subtitle_text)
 }
-/// # Safety
-/// The function accepts and dereferences a raw pointer
-/// The function also makes calls to functions whose safety is not guaranteed
-/// The function returns a raw pointer which is a string made in C
-#[no_mangle]
-pub unsafe extern "C" fn _process_frame_tickertext(
-    ctx: *mut lib_hardsubx_ctx,
-    frame: *mut AVFrame,
-    width: ::std::os::raw::c_int,
-    height: ::std::os::raw::c_int,
-    index: ::std::os::raw::c_int,
-) -> *mut ::std::os::raw::c_char {
-    let mut im: *mut Pix = pixCreate(width, height, 32);
-    let mut lum_im: *mut Pix = pixCreate(width, height, 32);
-    let frame_deref = *frame;
-
-    for i in ((92 * height) / 100)..height {
-        for j in 0..width {
-            let p: isize = (j * 3 + i * frame_deref.linesize[0]).try_into().unwrap();
-            let r: i32 = (*(frame_deref.data[0]).offset(p)).into();
-            let g: i32 = (*(frame_deref.data[0]).offset(p + 1)).into();
-            let b: i32 = (*(frame_deref.data[0]).offset(p + 2)).into();
-            pixSetRGBPixel(im, j, i, r, g, b);
-
-            let mut L: f32 = 0.0;
-            let mut A: f32 = 0.0;
-            let mut B: f32 = 0.0;
-
-            rgb_to_lab(r as f32, g as f32, b as f32, &mut L, &mut A, &mut B);
-
-            if L > (*ctx).lum_thresh {
-                pixSetRGBPixel(lum_im, j, i, 255, 255, 255);
-            } else {
-                pixSetRGBPixel(lum_im, j, i, 0, 0, 0);
-            }
-        }
-    }
-
-    let mut gray_im: *mut Pix = pixConvertRGBToGray(im, 0.0, 0.0, 0.0);
-    let mut sobel_edge_im: *mut Pix =
-        pixSobelEdgeFilter(gray_im, L_VERTICAL_EDGES.try_into().unwrap());
-    let mut dilate_gray_im: *mut Pix = pixDilateGray(sobel_edge_im, 21, 11);
-    let mut edge_im: *mut Pix = pixThresholdToBinary(dilate_gray_im, 50);
-
-    let mut feat_im: *mut Pix = pixCreate(width, height, 32);
-
-    for i in (92 * (height / 100))..height {
-        for j in 0..width {
-            let mut p1: u32 = 0;
-            let mut p2: u32 = 0;
-
-            pixGetPixel(edge_im, j, i, &mut p1);
-            pixGetPixel(lum_im, j, i, &mut p2);
-
-            if p1 == 0 && p2 > 0 {
-                pixSetRGBPixel(feat_im, j, i, 255, 255, 255);
-            } else {
-                pixSetRGBPixel(feat_im, j, i, 0, 0, 0);
-            }
-        }
-    }
-
-    let subtitle_text = get_ocr_text_simple_threshold(ctx, lum_im, 0.0);
-
-    let write_path: String = format!("./lum_im{}.jpg", index);
-    let write_path_c: *mut c_char = string_to_c_char(&write_path);
-    pixWrite(write_path_c, lum_im, IFF_JFIF_JPEG.try_into().unwrap());
-    let _dealloc = std::ffi::CString::from_raw(write_path_c); // for memory reasons
-
-    let write_path: String = format!("./im{}.jpg", index);
-    let write_path_c: *mut c_char = string_to_c_char(&write_path);
-    pixWrite(write_path_c, lum_im, IFF_JFIF_JPEG.try_into().unwrap());
-    let _dealloc = std::ffi::CString::from_raw(write_path_c); // for memory reasons
-
-    pixDestroy(&mut im as *mut *mut Pix);
-    pixDestroy(&mut gray_im as *mut *mut Pix);
-    pixDestroy(&mut sobel_edge_im as *mut *mut Pix);
-    pixDestroy(&mut dilate_gray_im as *mut *mut Pix);
-    pixDestroy(&mut edge_im as *mut *mut Pix);
-    pixDestroy(&mut lum_im as *mut *mut Pix);
-    pixDestroy(&mut feat_im as *mut *mut Pix);
-
-    subtitle_text
-}
@@ -1,4 +1,8 @@
-use palette::{FromColor, Hsv, Lab, Srgb};
+use palette::white_point::D65;
+use palette::{FromColor, Hsv, Lab, Srgb, Xyz};
+use std::os::raw::{c_int, c_void};
+
+use crate::hardsubx::lib_hardsubx_ctx;
 
 #[no_mangle]
 pub extern "C" fn rgb_to_hsv(R: f32, G: f32, B: f32, H: &mut f32, S: &mut f32, V: &mut f32) {
@@ -23,6 +27,156 @@ pub extern "C" fn rgb_to_lab(R: f32, G: f32, B: f32, L: &mut f32, a: &mut f32, b
     *b = lab_rep.b;
 }
 
+/// Subtitle colour tests of [`rgb_to_lab`] and [`rgb_to_hsv`], precomputed
+/// for one luminance threshold and hue. Components are in 0..=255, as the
+/// frame processing functions pass them.
+pub struct ColorLut {
+    lum_thresh: f32,
+    hue: f32,
+    lum: [[f32; 256]; 3],
+    lum_min: f32,
+    /// Bit `r << 16 | g << 8 | b` set if the hue is within 20 degrees
+    hue_match: Option<Vec<u8>>,
+}
+
+impl ColorLut {
+    pub fn new(lum_thresh: f32) -> ColorLut {
+        let mut lut = ColorLut {
+            lum_thresh,
+            hue: 0.0,
+            lum: [[0.0; 256]; 3],
+            lum_min: 0.0,
+            hue_match: None,
+        };
+        lut.build_lum_tables(lum_thresh);
+        lut
+    }
+
+    /// L only depends on Y, and Y is the sum of the contributions of the
+    /// linearised components, so it can be looked up per component.
+    fn build_lum_tables(&mut self, lum_thresh: f32) {
+        for v in 0..256 {
+            let c = v as f32;
+            self.lum[0][v] = Xyz::<D65, f32>::from_color(Srgb::new(c, 0.0, 0.0)).y;
+            self.lum[1][v] = Xyz::<D65, f32>::from_color(Srgb::new(0.0, c, 0.0)).y;
+            self.lum[2][v] = Xyz::<D65, f32>::from_color(Srgb::new(0.0, 0.0, c)).y;
+        }
+        self.lum_min = Xyz::<D65, f32>::from_color(Lab::<D65, f32>::new(lum_thresh, 0.0, 0.0)).y;
+        self.lum_thresh = lum_thresh;
+    }
+
+    fn build_hue_table(&mut self, hue: f32) {
+        let mut table = vec![0u8; 1 << 21];
+        for r in 0..256u32 {
+            for g in 0..256u32 {
+                for b in 0..256u32 {
+                    let (mut h, mut s, mut v) = (0.0, 0.0, 0.0);
+                    rgb_to_hsv(r as f32, g as f32, b as f32, &mut h, &mut s, &mut v);
+                    if (h - hue).abs() < 20.0 {
+                        table[((r << 13) | (g << 5) | (b >> 3)) as usize] |= 1 << (b & 7);
+                    }
+                }
+            }
+        }
+        self.hue_match = Some(table);
+        self.hue = hue;
+    }
+
+    /// `rgb_to_lab` gives an L above the luminance threshold
+    #[inline]
+    pub fn is_bright(&self, r: u8, g: u8, b: u8) -> bool {
+        self.lum[0][r as usize] + self.lum[1][g as usize] + self.lum[2][b as usize] > self.lum_min
+    }
+
+    /// `rgb_to_hsv` gives a hue within 20 degrees of the subtitle hue.
+    /// Only valid on tables returned by [`get_color_lut`] with `need_hue`.
+    #[inline]
+    pub fn is_hue(&self, r: u8, g: u8, b: u8) -> bool {
+        let index = ((r as usize) << 13) | ((g as usize) << 5) | ((b as usize) >> 3);
+        (self.hue_match.as_ref().unwrap()[index] >> (b & 7)) & 1 != 0
+    }
+}
+
+/// Returns the colour lookup tables for the current `lum_thresh` and `hue`
+/// of `ctx`, building them on first use and rebuilding them if either
+/// changed. The 2 MB hue table is only built if `need_hue` is set.
+///
+/// # Safety
+/// `ctx` must be a valid hardsubx context whose `color_lut` is null or was
+/// set by this function
+pub unsafe fn get_color_lut<'a>(ctx: *mut lib_hardsubx_ctx, need_hue: bool) -> &'a ColorLut {
+    if (*ctx).color_lut.is_null() {
+        (*ctx).color_lut = Box::into_raw(Box::new(ColorLut::new((*ctx).lum_thresh))) as *mut _;
+    }
+    // Tables shared between OCR threads are only borrowed mutably to rebuild them
+    let lut = (*ctx).color_lut as *mut ColorLut;
+    if (*lut).lum_thresh != (*ctx).lum_thresh {
+        (*lut).build_lum_tables((*ctx).lum_thresh);
+    }
+    if need_hue && ((*lut).hue_match.is_none() || (*lut).hue != (*ctx).hue) {
+        (*lut).build_hue_table((*ctx).hue);
+    }
+    &*lut
+}
+
+/// Builds the colour lookup tables of `ctx` ahead of use, so OCR threads
+/// can share them, and returns them. See [`get_color_lut`].
+///
+/// # Safety
+/// As for [`get_color_lut`]
+#[no_mangle]
+pub unsafe extern "C" fn hardsubx_get_color_lut(
+    ctx: *mut lib_hardsubx_ctx,
+    need_hue: c_int,
+) -> *mut c_void {
+    get_color_lut(ctx, need_hue != 0) as *const ColorLut as *mut c_void
+}
+
+/// # Safety
+/// `ctx` must be a valid hardsubx context whose `color_lut` is null or was
+/// set by [`get_color_lut`]
+#[no_mangle]
+pub unsafe extern "C" fn hardsubx_free_color_lut(ctx: *mut lib_hardsubx_ctx) {
+    if !(*ctx).color_lut.is_null() {
+        drop(Box::from_raw((*ctx).color_lut as *mut ColorLut));
+        (*ctx).color_lut = std::ptr::null_mut();
+    }
+}
+
+/// Sets `match_[k]` if pixel `k * step` of the packed RGB row `rgb` has the
+/// subtitle colour, for `k < count`: [`ColorLut::is_bright`], or
+/// [`ColorLut::is_hue`] if `by_hue` is set. Lets code shared by both builds
+/// test colours exactly as the frame processing functions do.
+///
+/// # Safety
+/// `ctx` must be valid as for [`get_color_lut`], `rgb` must hold
+/// `(count - 1) * step + 1` pixels and `match_` `count` bytes
+#[no_mangle]
+pub unsafe extern "C" fn hardsubx_match_color(
+    ctx: *mut lib_hardsubx_ctx,
+    rgb: *const u8,
+    count: c_int,
+    step: c_int,
+    by_hue: c_int,
+    match_: *mut u8,
+) {
+    if count <= 0 {
+        return;
+    }
+    let lut = get_color_lut(ctx, by_hue != 0);
+    let rgb = std::slice::from_raw_parts(rgb, 3 * ((count - 1) * step + 1) as usize);
+    let match_ = std::slice::from_raw_parts_mut(match_, count as usize);
+    for (k, m) in match_.iter_mut().enumerate() {
+        let p = &rgb[3 * k * step as usize..];
+        let is_sub = if by_hue != 0 {
+            lut.is_hue(p[0], p[1], p[2])
+        } else {
+            lut.is_bright(p[0], p[1], p[2])
+        };
+        *m = is_sub as u8;
+    }
+}
+
 #[cfg(test)]
 mod test {
     use super::*;
@@ -84,4 +238,29 @@ mod test {
         assert_eq!(a.floor(), 0.0);
         assert_eq!(b.floor(), 0.0);
     }
+
+    #[test]
+    fn test_color_lut() {
+        let mut lut = ColorLut::new(80.0);
+        lut.build_hue_table(60.0);
+
+        for r in (0..256).step_by(15) {
+            for g in (0..256).step_by(15) {
+                for b in (0..256).step_by(15) {
+                    let (r, g, b) = (r as u8, g as u8, b as u8);
+                    let (mut l, mut a, mut b_) = (0.0, 0.0, 0.0);
+                    rgb_to_lab(r as f32, g as f32, b as f32, &mut l, &mut a, &mut b_);
+                    assert_eq!(lut.is_bright(r, g, b), l > 80.0, "L of {r} {g} {b}");
+
+                    let (mut h, mut s, mut v) = (0.0, 0.0, 0.0);
+                    rgb_to_hsv(r as f32, g as f32, b as f32, &mut h, &mut s, &mut v);
+                    assert_eq!(
+                        lut.is_hue(r, g, b),
+                        (h - 60.0).abs() < 20.0,
+                        "H of {r} {g} {b}"
+                    );
+                }
+            }
+        }
+    }
 }
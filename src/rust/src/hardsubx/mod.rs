@@ -42,6 +42,9 @@ pub struct lib_hardsubx_ctx {
     pub video_stream_id: ::std::os::raw::c_int,
     pub im: *mut Pix,
     pub tess_handle: *mut TessBaseAPI,
+    pub frame_im: *mut Pix,
+    pub mask_im: *mut Pix,
+    pub feat_im: *mut Pix,
     pub cur_conf: f32,
     pub prev_conf: f32,
     pub tickertext: ::std::os::raw::c_int,
@@ -54,4 +57,13 @@ pub struct lib_hardsubx_ctx {
     pub conf_thresh: f32,
     pub hue: f32,
     pub lum_thresh: f32,
+    pub binary_search: ::std::os::raw::c_int,
+    pub color_lut: *mut ::std::os::raw::c_void,
+    pub roi_top: f32,
+    pub roi_y: ::std::os::raw::c_int,
+    pub roi_height: ::std::os::raw::c_int,
+    pub threads: ::std::os::raw::c_int,
+    pub skip_frames: ::std::os::raw::c_int,
+    pub tessdata_path: *const ::std::os::raw::c_char,
+    pub ocr_lang: *const ::std::os::raw::c_char,
 }
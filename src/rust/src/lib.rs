@@ -41,7 +41,7 @@ use log::{warn, LevelFilter};
 use std::{
     ffi::CStr,
     io::Write,
-    os::raw::{c_char, c_double, c_int, c_long, c_uint},
+    os::raw::{c_char, c_double, c_int, c_long, c_uint, c_void},
 };
 
 // Mock data for rust unit tests
@@ -113,6 +113,9 @@ pub extern "C" fn ccxr_init_logger() {
 
 /// Process cc_data
 ///
+/// The triplets are read in place, and the 708 decoder state is kept in a [`Dtvcc`] owned by
+/// `dec_ctx` (see [`get_or_init_dtvcc`]), so nothing is allocated per call.
+///
 /// # Safety
 /// dec_ctx should not be a null pointer
 /// data should point to cc_data of length cc_count
@@ -123,17 +126,19 @@ extern "C" fn ccxr_process_cc_data(
     cc_count: c_int,
 ) -> c_int {
     let mut ret = -1;
-    let mut cc_data: Vec<u8> = (0..cc_count * 3)
-        .map(|x| unsafe { *data.add(x as usize) })
-        .collect();
+    if data.is_null() || cc_count <= 0 {
+        return ret;
+    }
+    let cc_data = unsafe { std::slice::from_raw_parts(data, cc_count as usize * 3) };
     let dec_ctx = unsafe { &mut *dec_ctx };
-    let dtvcc_ctx = unsafe { &mut *dec_ctx.dtvcc };
-    let mut dtvcc = Dtvcc::new(dtvcc_ctx);
-    for cc_block in cc_data.chunks_exact_mut(3) {
-        if !validate_cc_pair(cc_block) {
+    let dtvcc = unsafe { get_or_init_dtvcc(dec_ctx) };
+    for cc_block in cc_data.chunks_exact(3) {
+        // validate_cc_pair() may patch 608 data, which must not leak back into the C buffer
+        let mut cc_block = [cc_block[0], cc_block[1], cc_block[2]];
+        if !validate_cc_pair(&mut cc_block) {
             continue;
         }
-        let success = do_cb(dec_ctx, &mut dtvcc, cc_block);
+        let success = do_cb(dec_ctx, dtvcc, &cc_block);
         if success {
             ret = 0;
         }
@@ -141,6 +146,50 @@ extern "C" fn ccxr_process_cc_data(
     ret
 }
 
+/// Returns the persistent [`Dtvcc`] of `dec_ctx`, creating it on first use
+///
+/// The decoder is stored in `dec_ctx.dtvcc_rust` and must be released with [`ccxr_dtvcc_free`].
+///
+/// # Safety
+/// `dec_ctx.dtvcc` and its `encoder`, `report` and `timing` pointers must be valid
+unsafe fn get_or_init_dtvcc(dec_ctx: &mut lib_cc_decode) -> &'static mut Dtvcc<'static> {
+    if dec_ctx.dtvcc_rust.is_null() {
+        let dtvcc = Box::new(Dtvcc::new(&mut *dec_ctx.dtvcc));
+        dec_ctx.dtvcc_rust = Box::into_raw(dtvcc) as *mut c_void;
+    }
+    let dtvcc = &mut *(dec_ctx.dtvcc_rust as *mut Dtvcc<'static>);
+    // The C code reassigns the encoder whenever the output context changes
+    dtvcc.encoder = &mut *((*dec_ctx.dtvcc).encoder as *mut encoder_ctx);
+    dtvcc
+}
+
+/// Free the [`Dtvcc`] created by [`ccxr_process_cc_data`]
+///
+/// # Safety
+/// dtvcc_rust must be null or a pointer stored in `lib_cc_decode.dtvcc_rust`
+#[no_mangle]
+pub unsafe extern "C" fn ccxr_dtvcc_free(dtvcc_rust: *mut c_void) {
+    if !dtvcc_rust.is_null() {
+        drop(Box::from_raw(dtvcc_rust as *mut Dtvcc<'static>));
+    }
+}
+
+/// Flush the service decoders of the [`Dtvcc`] created by [`ccxr_process_cc_data`]
+///
+/// Returns 1 if any decoder had printed captions and was flushed, 0 otherwise
+///
+/// # Safety
+/// dec_ctx should not be a null pointer, and `dec_ctx.dtvcc` and its pointers must be valid
+#[no_mangle]
+pub unsafe extern "C" fn ccxr_flush_active_decoders(dec_ctx: *mut lib_cc_decode) -> c_int {
+    let dec_ctx = &mut *dec_ctx;
+    if dec_ctx.dtvcc_rust.is_null() {
+        return 0;
+    }
+    let dtvcc = get_or_init_dtvcc(dec_ctx);
+    dtvcc.flush_active_decoders() as c_int
+}
+
 /// Returns `true` if cc_block pair is valid
 ///
 /// For CEA-708 data, only cc_valid is checked
@@ -366,4 +415,28 @@ mod test {
         assert_eq!(decoder_ctx.processed_enough, 0);
         assert_eq!(unsafe { cb_708 }, 11);
     }
+
+    #[test]
+    fn test_dtvcc_persists_between_calls() {
+        let mut dtvcc_ctx = crate::decoder::test::initialize_dtvcc_ctx();
+        dtvcc_ctx.is_active = 1;
+
+        let mut decoder_ctx = lib_cc_decode::default();
+        decoder_ctx.dtvcc = &mut *dtvcc_ctx;
+
+        // A 4 byte DTVCC packet (service 1, one byte block) split over two frames
+        let dtvcc = unsafe { get_or_init_dtvcc(&mut decoder_ctx) };
+        dtvcc.process_cc_data(1, 3, 0x02, 0x21);
+        let first = decoder_ctx.dtvcc_rust;
+        assert!(!first.is_null());
+        assert_eq!(unsafe { (*dtvcc_ctx.report).services[1] }, 0);
+
+        let dtvcc = unsafe { get_or_init_dtvcc(&mut decoder_ctx) };
+        assert_eq!(dtvcc.packet_length, 2);
+        dtvcc.process_cc_data(1, 2, 0x41, 0x00);
+        assert_eq!(decoder_ctx.dtvcc_rust, first);
+        assert_eq!(unsafe { (*dtvcc_ctx.report).services[1] }, 1);
+
+        unsafe { ccxr_dtvcc_free(decoder_ctx.dtvcc_rust) };
+    }
 }
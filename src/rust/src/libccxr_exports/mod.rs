@@ -95,3 +95,54 @@ pub unsafe extern "C" fn ccxr_levenshtein_dist_char(
     ans.try_into()
         .expect("Failed to convert the levenshtein distance to C int")
 }
+
+/// Rust equivalent for `levenshtein_dist_bounded` function in C. Uses C-native types as input and output.
+///
+/// Returns the distance if it is at most `max`, and `max + 1` otherwise.
+///
+/// # Safety
+///
+/// `s1` and `s2` must valid slices of data with lengths of `s1len` and `s2len` respectively.
+#[no_mangle]
+pub unsafe extern "C" fn ccxr_levenshtein_dist_bounded(
+    s1: *const u64,
+    s2: *const u64,
+    s1len: c_uint,
+    s2len: c_uint,
+    max: c_uint,
+) -> c_int {
+    let s1 = std::slice::from_raw_parts(s1, s1len.try_into().unwrap());
+    let s2 = std::slice::from_raw_parts(s2, s2len.try_into().unwrap());
+    let max: usize = max.try_into().unwrap();
+
+    let ans = levenshtein_bounded(s1, s2, max).unwrap_or(max + 1);
+
+    ans.try_into()
+        .expect("Failed to convert the levenshtein distance to C int")
+}
+
+/// Rust equivalent for `levenshtein_dist_char_bounded` function in C. Uses C-native types as input and output.
+///
+/// Returns the distance if it is at most `max`, and `max + 1` otherwise.
+///
+/// # Safety
+///
+/// `s1` and `s2` must valid slices of data and therefore not be null. They must have lengths
+/// of `s1len` and `s2len` respectively.
+#[no_mangle]
+pub unsafe extern "C" fn ccxr_levenshtein_dist_char_bounded(
+    s1: *const c_char,
+    s2: *const c_char,
+    s1len: c_uint,
+    s2len: c_uint,
+    max: c_uint,
+) -> c_int {
+    let s1 = std::slice::from_raw_parts(s1, s1len.try_into().unwrap());
+    let s2 = std::slice::from_raw_parts(s2, s2len.try_into().unwrap());
+    let max: usize = max.try_into().unwrap();
+
+    let ans = levenshtein_bounded(s1, s2, max).unwrap_or(max + 1);
+
+    ans.try_into()
+        .expect("Failed to convert the levenshtein distance to C int")
+}
@@ -642,6 +642,42 @@ impl OptionsExt for Options {
                     self.hardsubx_detect_italics = true;
                 }
 
+                if args.binary_search {
+                    self.hardsubx_binary_search = true;
+                }
+
+                if let Some(ref value) = args.roi_top {
+                    if !(0.0..100.0).contains(value) {
+                        fatal!(
+                            cause = ExitCause::MalformedParameter;
+                           "Invalid region of interest, valid values are between 0 & 100"
+                        );
+                    }
+                    self.hardsubx_roi_top = Some(*value as _);
+                }
+
+                if let Some(value) = args.hardsubx_threads {
+                    self.hardsubx_threads = value;
+                }
+
+                if let Some(ref skip_frames) = args.skip_frames {
+                    let skip_frames = match skip_frames.as_str() {
+                        "none" => Some(SkipFrames::None),
+                        "nonref" => Some(SkipFrames::NonRef),
+                        "nonkey" => Some(SkipFrames::NonKey),
+                        _ => None,
+                    };
+
+                    if skip_frames.is_none() {
+                        fatal!(
+                            cause = ExitCause::MalformedParameter;
+                           "Invalid value for --skip-frames. Valid values are {{none,nonref,nonkey}}"
+                        );
+                    }
+
+                    self.hardsubx_skip_frames = skip_frames.unwrap_or_default();
+                }
+
                 if let Some(ref value) = args.conf_thresh {
                     if !(0.0..=100.0).contains(value) {
                         fatal!(
@@ -763,7 +799,11 @@ impl OptionsExt for Options {
         }
 
         if let Some(ref lang) = args.dvblang {
-            self.dvblang = Some(Language::from_str(lang.as_str()).unwrap());
+            if lang == "all" {
+                self.dvb_all_streams = true;
+            } else {
+                self.dvblang = Some(Language::from_str(lang.as_str()).unwrap());
+            }
         }
 
         if let Some(ref ocrlang) = args.ocrlang {
@@ -1221,8 +1261,12 @@ impl OptionsExt for Options {
         }
 
         if let Some(ref tpage) = args.tpage {
-            tlt_config.user_page = get_atoi_hex::<u16>(tpage.as_str()) as _;
-            tlt_config.page = Cell::new(TeletextPageNumber::from(tlt_config.user_page));
+            if tpage == "all" {
+                tlt_config.all_pages = true;
+            } else {
+                tlt_config.user_page = get_atoi_hex::<u16>(tpage.as_str()) as _;
+                tlt_config.page = Cell::new(TeletextPageNumber::from(tlt_config.user_page));
+            }
         }
 
         // Red Hen/ UCLA Specific stuff
@@ -1861,6 +1905,14 @@ pub mod tests {
         assert_eq!(options.dvblang.unwrap(), Language::Eng);
     }
 
+    #[test]
+    fn dvblang_all() {
+        let (options, _) = parse_args(&["--dvblang", "all"]);
+
+        assert!(options.dvb_all_streams);
+        assert!(options.dvblang.is_none());
+    }
+
     #[test]
     fn general_1() {
         let (options, _) = parse_args(&[
@@ -2438,4 +2490,12 @@ pub mod tests {
         assert_eq!(options.write_format, OutputFormat::Srt);
         assert_eq!(options.enc_cfg.encoding, Encoding::Latin1);
     }
+
+    #[test]
+    fn teletext_all_pages() {
+        let (_, tlt_config) = parse_args(&["--teletext", "--tpage", "all"]);
+
+        assert!(tlt_config.all_pages);
+        assert_eq!(tlt_config.user_page, 0);
+    }
 }